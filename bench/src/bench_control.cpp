@@ -0,0 +1,107 @@
+#include "control_message.hpp"
+#include "render_options.hpp"
+
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+#include <string>
+
+namespace {
+
+// Типичные команды клиента в том виде, в каком их шлет web/app.js
+const std::string CONTROL_MESSAGES[] = {
+    R"({"type":"auth","api_key":"0123456789abcdef0123456789abcdef","role":"controller"})",
+    R"({"type":"config","camera_index":0,"resolution":"120x90","fps":10})",
+    R"({"type":"set_render_options","tone":"equalize","dither":"ordered","edges":false})",
+    R"({"type":"playback_speed","speed":2.0})"
+};
+
+} // namespace
+
+// Разбор и извлечение полей так же, как в WebSocketSession::handle_message
+static void BM_ControlMessageParse(benchmark::State& state) 
+{
+    const std::string& message = CONTROL_MESSAGES[state.range(0)];
+
+    for (auto _ : state) 
+    {
+        auto j = nlohmann::json::parse(message);
+        std::string type = j["type"];
+
+        if (type == "auth") 
+        {
+            std::string api_key = j["api_key"];
+            std::string role = j.value("role", "viewer");
+            benchmark::DoNotOptimize(api_key.data());
+            benchmark::DoNotOptimize(role.data());
+        } 
+        else if (type == "config") 
+        {
+            int camera_index = j.value("camera_index", 0);
+            std::string resolution = j.value("resolution", "120x90");
+            int fps = j.value("fps", 10);
+            benchmark::DoNotOptimize(camera_index + fps);
+            benchmark::DoNotOptimize(resolution.data());
+        } 
+        else if (type == "set_render_options") 
+        {
+            RenderOptions options;
+            options.tone = RenderOptions::parse_tone(j.value("tone", std::string("linear")));
+            options.dither = RenderOptions::parse_dither(j.value("dither", std::string("none")));
+            options.edges = j.value("edges", options.edges);
+            benchmark::DoNotOptimize(options);
+        } 
+        else 
+        {
+            double speed = j.value("speed", 1.0);
+            benchmark::DoNotOptimize(speed);
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * message.size());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ControlMessageParse)->DenseRange(0, 3);
+
+// Тот же разбор через ControlMessage: без выделения памяти, выбор команды через switch
+static void BM_ControlMessageFastParse(benchmark::State& state) 
+{
+    const std::string& message = CONTROL_MESSAGES[state.range(0)];
+    ControlMessage msg;
+
+    for (auto _ : state) 
+    {
+        if (!msg.parse(message)) 
+        {
+            state.SkipWithError("parse failed");
+            break;
+        }
+
+        switch (msg.command()) 
+        {
+            case ControlCommand::Auth: 
+                benchmark::DoNotOptimize(msg.string("api_key").data());
+                benchmark::DoNotOptimize(msg.string("role", "viewer").data());
+                break;
+            case ControlCommand::Config: 
+                benchmark::DoNotOptimize(msg.integer("camera_index", 0) + msg.integer("fps", 10));
+                benchmark::DoNotOptimize(msg.string("resolution", "120x90").data());
+                break;
+            case ControlCommand::SetRenderOptions: 
+            {
+                RenderOptions options;
+                options.tone = RenderOptions::parse_tone(msg.string("tone", "linear"));
+                options.dither = RenderOptions::parse_dither(msg.string("dither", "none"));
+                options.edges = msg.boolean("edges", options.edges);
+                benchmark::DoNotOptimize(options);
+                break;
+            }
+            default: 
+                benchmark::DoNotOptimize(msg.number("speed", 1.0));
+                break;
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * message.size());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ControlMessageFastParse)->DenseRange(0, 3);
\ No newline at end of file
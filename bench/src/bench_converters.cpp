@@ -0,0 +1,108 @@
+#include "ascii_converter.hpp"
+#include "glyph_match_converter.hpp"
+#include "unicode_converter.hpp"
+
+#include <benchmark/benchmark.h>
+#include <boost/beast/zlib/deflate_stream.hpp>
+#include <opencv2/opencv.hpp>
+
+namespace {
+
+// Кадр камеры 640x480 со случайным содержимым; размер ASCII-кадра - аргумент
+cv::Mat make_frame() 
+{
+    cv::Mat frame(480, 640, CV_8UC3);
+    cv::RNG rng(1);
+    rng.fill(frame, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(256));
+    return frame;
+}
+
+// Размер кадра после deflate - оценка трафика при permessage-deflate
+size_t deflated_size(const std::string& frame) 
+{
+    namespace zlib = boost::beast::zlib;
+
+    zlib::deflate_stream stream;
+    stream.reset(6, 15, 8, zlib::Strategy::normal);
+    std::string compressed(stream.upper_bound(frame.size()), '\0');
+
+    zlib::z_params params;
+    params.next_in = frame.data();
+    params.avail_in = frame.size();
+    params.next_out = compressed.data();
+    params.avail_out = compressed.size();
+
+    boost::system::error_code ec;
+    stream.write(params, zlib::Flush::full, ec);
+    return params.total_out;
+}
+
+template <typename Converter>
+void run_converter(benchmark::State& state, Converter& converter) 
+{
+    const int width = static_cast<int>(state.range(0));
+    const int height = width * 3 / 4;
+    const cv::Mat frame = make_frame();
+    std::string output;
+
+    for (auto _ : state) 
+    {
+        converter.convert(frame, width, height, output);
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * width * height);
+    state.counters["fps"] = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+    state.counters["frame_bytes"] = static_cast<double>(output.size());
+    state.counters["deflated_bytes"] = static_cast<double>(deflated_size(output));
+}
+
+} // namespace
+
+static void BM_BrightnessConverter(benchmark::State& state) 
+{
+    AsciiConverter converter;
+    run_converter(state, converter);
+}
+BENCHMARK(BM_BrightnessConverter)->Arg(80)->Arg(120)->Arg(160)->Arg(320);
+
+// Набор символов влияет только на таблицу, но длина набора меняет
+// распределение символов в кадре и работу дизеринга
+static void BM_BrightnessConverterCharset(benchmark::State& state) 
+{
+    static const char* const CHARSETS[] = {
+        "@%#*+=-:. ",
+        "$@B%8&WM#*oahkbdpqwmZO0QLCJUYXzcvunxrjft/\\|()1{}[]?-_+~<>i!lI;:,\"^`'. ",
+        "# "
+    };
+
+    RenderOptions options;
+    options.dither = RenderOptions::Dither::Ordered;
+
+    AsciiConverter converter;
+    converter.set_ascii_chars(CHARSETS[state.range(1)]);
+    converter.set_render_options(options);
+    run_converter(state, converter);
+}
+BENCHMARK(BM_BrightnessConverterCharset)->ArgsProduct({{80, 160}, {0, 1, 2}});
+
+static void BM_GlyphMatchConverter(benchmark::State& state) 
+{
+    GlyphMatchConverter converter;
+    run_converter(state, converter);
+}
+BENCHMARK(BM_GlyphMatchConverter)->Arg(80)->Arg(120)->Arg(160)->Arg(320);
+
+static void BM_BrailleConverter(benchmark::State& state) 
+{
+    UnicodeConverter converter(UnicodeConverter::Mode::Braille);
+    run_converter(state, converter);
+}
+BENCHMARK(BM_BrailleConverter)->Arg(80)->Arg(120)->Arg(160)->Arg(320);
+
+static void BM_HalfBlockConverter(benchmark::State& state) 
+{
+    UnicodeConverter converter(UnicodeConverter::Mode::HalfBlock);
+    run_converter(state, converter);
+}
+BENCHMARK(BM_HalfBlockConverter)->Arg(80)->Arg(120)->Arg(160)->Arg(320);
\ No newline at end of file
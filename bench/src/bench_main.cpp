@@ -0,0 +1,18 @@
+#include "logger.hpp"
+#include <benchmark/benchmark.h>
+
+int main(int argc, char** argv) 
+{
+    Logger::init();
+    // Отладочные сообщения конвертера искажают замеры
+    Logger::get()->set_level(spdlog::level::warn);
+
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv)) 
+    {
+        return 1;
+    }
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+    return 0;
+}
\ No newline at end of file
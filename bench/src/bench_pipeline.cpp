@@ -0,0 +1,183 @@
+#include "stream_controller.hpp"
+#include "record_controller.hpp"
+#include "frame_viewer_interface.hpp"
+#include "shm_frame_bus.hpp"
+
+#include <benchmark/benchmark.h>
+#include <boost/asio.hpp>
+#include <deque>
+#include <filesystem>
+#include <unistd.h>
+
+namespace {
+
+// ASCII-кадр заданного размера из строк одинаковой длины
+std::string make_ascii_frame(int width, int height) 
+{
+    static const std::string CHARS = "@%#*+=-:. ";
+    std::string frame;
+    frame.reserve(static_cast<size_t>(height) * (width + 1));
+    for (int y = 0; y < height; ++y) 
+    {
+        for (int x = 0; x < width; ++x) 
+        {
+            frame += CHARS[(x * 7 + y * 3) % CHARS.size()];
+        }
+        frame += '\n';
+    }
+    return frame;
+}
+
+// Зритель без сети с той же очередью, что у WebSocketSession: не больше
+// десяти кадров, при переполнении вытесняется самый старый
+class QueueingViewer : public IFrameViewer 
+{
+public:
+    explicit QueueingViewer(uint64_t id) : id_(id) {}
+
+    void send_frame(std::shared_ptr<const std::string> frame, const FrameTrace& trace) override 
+    {
+        if (queue_.size() >= MAX_QUEUE_SIZE) 
+        {
+            queue_.pop_front();
+        }
+        queue_.push_back(std::move(frame));
+    }
+
+    uint64_t session_id() const override { return id_; }
+
+private:
+    static constexpr size_t MAX_QUEUE_SIZE = 10;
+
+    uint64_t id_;
+    std::deque<std::shared_ptr<const std::string>> queue_;
+};
+
+} // namespace
+
+// Раздача одного кадра N зрителям через strand контроллера
+static void BM_BroadcastFanOut(benchmark::State& state) 
+{
+    const auto viewer_count = static_cast<size_t>(state.range(0));
+
+    net::io_context ioc;
+    auto controller = std::make_shared<StreamController>(ioc, nullptr, nullptr);
+    std::vector<std::shared_ptr<QueueingViewer>> viewers;
+    for (size_t i = 0; i < viewer_count; ++i) 
+    {
+        viewers.push_back(std::make_shared<QueueingViewer>(i + 1));
+        controller->add_viewer(viewers.back());
+    }
+    ioc.run();
+
+    auto frame = std::make_shared<const std::string>(make_ascii_frame(120, 90));
+    for (auto _ : state) 
+    {
+        net::co_spawn(ioc, controller->broadcast_frame(frame), net::detached);
+        ioc.restart();
+        ioc.run();
+    }
+
+    state.SetItemsProcessed(state.iterations() * viewer_count);
+}
+BENCHMARK(BM_BroadcastFanOut)->RangeMultiplier(10)->Range(1, 1000);
+
+// Запись кадров в файл .asr вместе с индексом активности и превью
+static void BM_RecordWrite(benchmark::State& state) 
+{
+    const int width = static_cast<int>(state.range(0));
+    const std::string frame = make_ascii_frame(width, width * 3 / 4);
+
+    net::io_context ioc;
+    RecordController recorder(ioc);
+    if (!recorder.start_recording()) 
+    {
+        state.SkipWithError("Could not start recording");
+        return;
+    }
+
+    int activity = 0;
+    for (auto _ : state) 
+    {
+        recorder.write_frame(frame, activity);
+        activity = (activity + 37) % 1000;
+    }
+
+    const std::string filename = recorder.get_current_filename();
+    recorder.stop_recording();
+    std::filesystem::remove(filename);
+    std::filesystem::remove(index_filename(filename));
+
+    state.SetBytesProcessed(state.iterations() * frame.size());
+}
+BENCHMARK(BM_RecordWrite)->Arg(80)->Arg(160)->Arg(320);
+
+// Разбор записи целиком: тот же проход по кадрам, что и при построении
+// превью для записей, сделанных до запуска сервера
+static void BM_RecordingParse(benchmark::State& state) 
+{
+    const auto frame_count = static_cast<size_t>(state.range(0));
+    const std::string frame = make_ascii_frame(120, 90);
+
+    net::io_context ioc;
+    RecordController recorder(ioc);
+    if (!recorder.start_recording()) 
+    {
+        state.SkipWithError("Could not start recording");
+        return;
+    }
+    for (size_t i = 0; i < frame_count; ++i) 
+    {
+        recorder.write_frame(frame, static_cast<int>(i % 1000));
+    }
+    const std::string path = recorder.get_current_filename();
+    const std::string filename = std::filesystem::path(path).filename().string();
+    recorder.stop_recording();
+
+    RecordController::RecordingPreview preview;
+    for (auto _ : state) 
+    {
+        recorder.remove_preview(filename);
+        if (!recorder.get_preview(filename, preview)) 
+        {
+            state.SkipWithError("Could not parse recording");
+            break;
+        }
+        benchmark::DoNotOptimize(preview.frames.data());
+    }
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(index_filename(path));
+
+    state.SetItemsProcessed(state.iterations() * frame_count);
+    state.SetBytesProcessed(state.iterations() * frame_count * frame.size());
+}
+BENCHMARK(BM_RecordingParse)->Arg(100)->Arg(1000);
+
+// Передача кадра через шину в разделяемой памяти: публикация сервером
+// и чтение потребителем, время - от записи до получения копии
+static void BM_FrameBusHandoff(benchmark::State& state) 
+{
+    const int width = static_cast<int>(state.range(0));
+    const std::string frame = make_ascii_frame(width, width * 3 / 4);
+    const std::string name = "/ascii_bench_" + std::to_string(getpid());
+
+    frame_bus::Writer writer(name, 8, frame.size());
+    frame_bus::Reader reader(name);
+    frame_bus::Frame received;
+    received.data.reserve(frame.size());
+
+    for (auto _ : state) 
+    {
+        writer.publish(frame, std::chrono::steady_clock::now());
+        if (!reader.read_next(received)) 
+        {
+            state.SkipWithError("Published frame was not read");
+            break;
+        }
+        benchmark::DoNotOptimize(received.data.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * frame.size());
+}
+BENCHMARK(BM_FrameBusHandoff)->Arg(80)->Arg(160)->Arg(320);
\ No newline at end of file
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Ограничения на входящие соединения. 0 - без ограничения.
+struct AdmissionLimits 
+{
+    // Открытых соединений (HTTP и WebSocket) на всех слушателях
+    size_t max_connections = 1024;
+    // TLS-рукопожатий, выполняющихся одновременно
+    size_t max_handshakes = 64;
+    // Новых соединений в секунду с одного адреса и допустимый всплеск
+    double connections_per_second = 10;
+    double connection_burst = 20;
+    // Одновременно открытых соединений с одного адреса
+    size_t max_connections_per_ip = 64;
+    // Неудачных auth с одного адреса за auth_lockout до блокировки адреса
+    unsigned max_auth_failures = 5;
+    std::chrono::seconds auth_lockout{60};
+    // Аутентифицированных зрителей трансляции; контроллер не ограничивается
+    size_t max_viewers = 0;
+};
+
+// Допуск соединений до дорогих операций: решение принимается сразу после
+// accept, до TLS-рукопожатия. Адреса loopback и Unix-сокет (пустой адрес)
+// не ограничиваются по IP - через них ходят локальные клиенты и прокси,
+// за которым все зрители выглядят одним адресом. Общие лимиты действуют
+// для всех.
+class AdmissionController : public std::enable_shared_from_this<AdmissionController> 
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Resource : uint8_t { Connection, Handshake, Viewer };
+
+    // Занятое место в одном из счетчиков; освобождается в деструкторе.
+    // Пустой Slot - в допуске отказано.
+    class Slot 
+    {
+    public:
+        Slot() = default;
+        Slot(Slot&& other) noexcept = default;
+        Slot& operator=(Slot&& other) noexcept;
+        ~Slot() { release(); }
+
+        explicit operator bool() const { return owner_ != nullptr; }
+        void release();
+
+    private:
+        friend class AdmissionController;
+        Slot(std::shared_ptr<AdmissionController> owner, Resource resource)
+            : owner_(std::move(owner)), resource_(resource) {}
+
+        std::shared_ptr<AdmissionController> owner_;
+        Resource resource_{Resource::Connection};
+        // Адрес, на который засчитано соединение; пустой - не засчитано
+        std::string address_;
+    };
+
+    explicit AdmissionController(AdmissionLimits limits = {});
+
+    Slot admit_connection(const std::string& address, Clock::time_point now = Clock::now());
+    Slot begin_handshake();
+    Slot admit_viewer();
+
+    // false - адрес заблокирован после неудачных auth
+    bool auth_allowed(const std::string& address, Clock::time_point now = Clock::now());
+    void record_auth_failure(const std::string& address, Clock::time_point now = Clock::now());
+    void record_auth_success(const std::string& address);
+
+    size_t active(Resource resource) const 
+    {
+        return counts_[static_cast<size_t>(resource)].load(std::memory_order_relaxed);
+    }
+    const AdmissionLimits& limits() const { return limits_; }
+    size_t tracked_peers() const;
+
+    static bool is_exempt(const std::string& address);
+
+private:
+    struct Peer 
+    {
+        double tokens = 0;
+        Clock::time_point refilled_at;
+        size_t connections = 0;
+        unsigned auth_failures = 0;
+        Clock::time_point first_failure_at;
+        Clock::time_point locked_until;
+    };
+
+    Slot acquire(Resource resource, size_t limit);
+    void release(Resource resource, const std::string& address);
+    // Вызываются под mutex_
+    Peer& peer(const std::string& address, Clock::time_point now);
+    void prune(Clock::time_point now);
+    void evict(Clock::time_point now);
+
+    // Сколько адресов помнить. При переполнении сначала забываются адреса
+    // без ограничений, а если таких нет - наименее активный из остальных
+    static constexpr size_t MAX_TRACKED_PEERS = 4096;
+    static constexpr size_t EVICT_BATCH = MAX_TRACKED_PEERS / 8;
+
+    const AdmissionLimits limits_;
+    std::array<std::atomic<size_t>, 3> counts_{};
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Peer> peers_;
+};
\ No newline at end of file
@@ -1,18 +1,54 @@
 #pragma once
 
 #include "ascii_converter_interface.hpp"
+#include <array>
+#include <chrono>
 #include <string>
+#include <vector>
 #include <opencv2/core/mat.hpp>
 
 class AsciiConverter : public IAsciiConverter 
 {
 public:
     AsciiConverter();
-    std::string convert(const cv::Mat& frame, int output_width, int output_height) override;
+    void convert(const cv::Mat& frame, int output_width, int output_height, std::string& output) override;
     void set_ascii_chars(const std::string& chars) override; 
+    void set_render_options(const RenderOptions& options) override;
+    StageTimings last_timings() const override;
+    using IAsciiConverter::convert;
+    
+    // Начиная с какого числа символов в кадре строки конвертируются параллельно
+    void set_parallel_threshold(size_t cells);
+    
+    static constexpr size_t DEFAULT_PARALLEL_THRESHOLD = 160 * 120;
+    static constexpr size_t BAND_ROWS = 16;
+    // Бюджет на всю цепочку стадий, превышение пишется в лог
+    static constexpr std::chrono::milliseconds FRAME_BUDGET{5};
     
 private:
     std::string ascii_chars_ = "@%#*+=-:. ";
-    cv::Mat resize_frame(const cv::Mat& frame, int width, int height);
-    cv::Mat convert_to_grayscale(const cv::Mat& frame);
+    const cv::Mat& resize_frame(const cv::Mat& frame, int width, int height);
+    const cv::Mat& convert_to_grayscale(const cv::Mat& frame);
+    // Таблица яркость -> символ пересчитывается только при смене набора символов
+    void build_lut();
+    
+    // Стадии RenderOptions, каждая возвращает свой результат или вход без изменений
+    const cv::Mat& apply_tone(const cv::Mat& luma);
+    const cv::Mat& apply_dither(const cv::Mat& luma);
+    void draw_edges(const cv::Mat& luma, std::string& output);
+
+    // Промежуточные буферы живут между кадрами, чтобы не выделять память заново
+    cv::Mat gray_;
+    cv::Mat resized_;
+    size_t parallel_threshold_{DEFAULT_PARALLEL_THRESHOLD};
+    std::array<char, 256> lut_{};
+    
+    RenderOptions options_;
+    StageTimings timings_;
+    cv::Mat gamma_lut_;
+    cv::Mat toned_;
+    cv::Mat dithered_;
+    cv::Mat grad_x_;
+    cv::Mat grad_y_;
+    std::vector<int> diffusion_error_;
 };
\ No newline at end of file
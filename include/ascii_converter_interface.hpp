@@ -1,5 +1,6 @@
 #pragma once
 
+#include "render_options.hpp"
 #include <string>
 #include <opencv2/core/mat.hpp>
 
@@ -7,6 +8,22 @@ class IAsciiConverter
 {
 public:
     virtual ~IAsciiConverter() = default;
-    virtual std::string convert(const cv::Mat& frame, int output_width, int output_height) = 0;
+    // Результат пишется в output; после первого кадра того же размера
+    // строка не перевыделяется
+    virtual void convert(const cv::Mat& frame, int output_width, int output_height, std::string& output) = 0;
     virtual void set_ascii_chars(const std::string& chars) = 0;
+
+    // Конвертеры без дополнительных стадий игнорируют настройки
+    virtual void set_render_options(const RenderOptions& options) {}
+    virtual StageTimings last_timings() const 
+    {
+        return {};
+    }
+
+    std::string convert(const cv::Mat& frame, int output_width, int output_height) 
+    {
+        std::string output;
+        convert(frame, output_width, output_height, output);
+        return output;
+    }
 };
\ No newline at end of file
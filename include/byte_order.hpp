@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Запись и чтение целых в little-endian независимо от порядка байт платформы.
+// Используется в двоичных заголовках сообщений WebSocket.
+template <typename T>
+void put_le(uint8_t* out, T value) 
+{
+    for (size_t i = 0; i < sizeof(T); ++i) 
+    {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+template <typename T>
+T get_le(const uint8_t* in) 
+{
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) 
+    {
+        value |= static_cast<T>(in[i]) << (8 * i);
+    }
+    return value;
+}
\ No newline at end of file
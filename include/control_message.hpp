@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Команды клиента из поля "type"
+enum class ControlCommand : uint8_t 
+{
+    Unknown,
+    Auth,
+    Config,
+    Stop,
+    PlaybackStart,
+    PlaybackPause,
+    PlaybackResume,
+    PlaybackStop,
+    PlaybackSpeed,
+    PlaybackNextActivity,
+    PlaybackPrevActivity,
+    RecordStart,
+    RecordStop,
+    AutoRecordStart,
+    AutoRecordStop,
+    SetRenderOptions,
+    SetTrace,
+    SetFraming
+};
+
+// Разбор управляющих сообщений WebSocket. Все команды клиента - плоские
+// JSON-объекты со строками, числами и true/false, поэтому вместо
+// nlohmann::json используется разбор без выделения памяти: значения -
+// string_view в исходный буфер, который должен жить, пока используется
+// сообщение. Строки с escape-последовательностями раскодируются в
+// собственный буфер, выделяемый один раз на объект.
+class ControlMessage 
+{
+public:
+    static constexpr size_t MAX_FIELDS = 16;
+
+    // false - не JSON-объект, вложенные объекты и массивы или больше MAX_FIELDS полей
+    bool parse(std::string_view text);
+
+    ControlCommand command() const { return command_; }
+    std::string_view type() const { return type_; }
+
+    // Отсутствующее поле или значение другого типа - значение по умолчанию
+    std::string_view string(std::string_view key, std::string_view fallback = {}) const;
+    int integer(std::string_view key, int fallback) const;
+    double number(std::string_view key, double fallback) const;
+    bool boolean(std::string_view key, bool fallback) const;
+
+    static ControlCommand parse_command(std::string_view type);
+
+private:
+    enum class Kind : uint8_t { String, Number, True, False, Null };
+
+    struct Field 
+    {
+        std::string_view key;
+        std::string_view value;
+        Kind kind;
+    };
+
+    const Field* find(std::string_view key) const;
+
+    std::array<Field, MAX_FIELDS> fields_{};
+    size_t field_count_ = 0;
+    ControlCommand command_ = ControlCommand::Unknown;
+    std::string_view type_;
+    std::string unescaped_;
+};
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "video_source_interface.hpp"
+#include "frame_pacer.hpp"
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Источник кадров из видеофайла или последовательности изображений
+// (шаблон вида frames/img_%03d.png). Файл проигрывается по кругу, кадры
+// декодируются отдельным потоком в кольцевой буфер в темпе fps.
+// capture_frame не ждет декодер: если новый кадр еще не готов, повторяется
+// предыдущий, как у камеры с меньшей частотой кадров. Кадр выдается без
+// копирования и делит данные со слотом кольца, поэтому только читается;
+// слот переиспользуется, когда потребитель отпустит кадр.
+class FileVideoSource : public IVideoSource 
+{
+public:
+    // fps > 0 - темп выдачи кадров, 0 - частота из файла, < 0 - без задержек
+    explicit FileVideoSource(std::string path, double fps = 0, size_t ring_size = DEFAULT_RING_SIZE);
+    ~FileVideoSource();
+    bool is_available() const override;
+    void capture_frame(cv::Mat& frame) override;
+    using IVideoSource::capture_frame;
+    void set_resolution(int width, int height) override;
+    void open(int index) override;
+    void close() override;
+    std::chrono::steady_clock::time_point last_capture_time() const override;
+
+    static constexpr size_t DEFAULT_RING_SIZE = 8;
+    static constexpr double FALLBACK_FPS = 30;
+
+private:
+    void decode_loop();
+    bool decode_next(cv::Mat& target);
+
+    std::string path_;
+    double fps_;
+    // cap_, decoded_ и pacer_ после open() использует только поток декодирования
+    cv::VideoCapture cap_;
+    cv::Mat decoded_;
+    FramePacer pacer_;
+    std::atomic<bool> opened_{false};
+
+    // Кольцо готовых кадров: поток декодирования пишет в хвост, capture_frame
+    // выдает голову заголовком на те же данные
+    std::vector<cv::Mat> ring_;
+    size_t head_{0};
+    size_t count_{0};
+    bool running_{false};
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::thread decoder_;
+    // Последний выданный кадр, для повтора; только поток capture_frame
+    cv::Mat last_frame_;
+
+    std::atomic<int> width_{640};
+    std::atomic<int> height_{480};
+    std::chrono::steady_clock::time_point last_capture_time_;
+};
\ No newline at end of file
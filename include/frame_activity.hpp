@@ -0,0 +1,10 @@
+#pragma once
+
+#include <string>
+
+// Доля изменившихся символов между соседними ASCII-кадрами в промилле (0..1000).
+// Кадры разного размера считаются полностью изменившимися.
+int frame_activity(const std::string& previous, const std::string& current);
+
+// Порог, начиная с которого кадр считается "активным"
+constexpr int DEFAULT_ACTIVITY_THRESHOLD = 20;
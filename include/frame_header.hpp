@@ -0,0 +1,67 @@
+#pragma once
+
+#include "frame_trace.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Двоичный формат сообщений WebSocket (команда set_framing). Каждое
+// сообщение - двоичное, заголовок FRAME_HEADER_SIZE байт и нагрузка.
+// Клиенту не нужно угадывать тип по тексту, а браузер не проверяет UTF-8.
+// Little-endian:
+//   0  u8   версия формата (FRAME_HEADER_VERSION)
+//   1  u8   тип сообщения (MessageType)
+//   2  u8   кодировка нагрузки (PayloadEncoding)
+//   3  u8   флаги: FRAME_FLAG_TRACED - клиент возвращает заголовок для
+//           замера времени до браузера и обратно; остальные биты
+//           зарезервированы (дельта-кадры, цвет, сжатие)
+//   4  u16  ширина кадра в символах
+//   6  u16  высота кадра в строках
+//   8  u64  номер кадра, 0 - без номера
+//   16 u64  время отправки по часам сервера, мкс
+//   24 u32  задержка от захвата до отправки, мкс
+//   28 u32  размер нагрузки в байтах
+constexpr size_t FRAME_HEADER_SIZE = 32;
+constexpr uint8_t FRAME_HEADER_VERSION = 1;
+constexpr uint8_t FRAME_FLAG_TRACED = 0x01;
+
+enum class MessageType : uint8_t 
+{
+    Frame = 1,
+    Heartbeat = 2,
+    // Служебный ответ сервера (AUTH_VIEWER_SUCCESS, CONFIG_APPLIED, ...)
+    Control = 3
+};
+
+enum class PayloadEncoding : uint8_t 
+{
+    Ascii = 0,
+    // Многобайтовые символы: конвертеры "braille" и "half_block"
+    Utf8 = 1
+};
+
+using FrameHeader = std::array<uint8_t, FRAME_HEADER_SIZE>;
+
+struct FrameHeaderFields 
+{
+    MessageType type{MessageType::Frame};
+    PayloadEncoding encoding{PayloadEncoding::Ascii};
+    uint8_t flags{0};
+    uint16_t width{0};
+    uint16_t height{0};
+    uint64_t sequence{0};
+    uint64_t sent_us{0};
+    uint32_t pipeline_us{0};
+    uint32_t payload_size{0};
+};
+
+// Размеры и кодировка кадра определяются по первой строке: все строки
+// кадра одной длины. Поля трассировки заполняются, если trace.valid().
+FrameHeader encode_frame_header(MessageType type, std::string_view payload, const FrameTrace& trace,
+                                bool traced, FrameTrace::Clock::time_point sent_at);
+bool decode_frame_header(const void* data, size_t size, FrameHeaderFields& fields);
+
+// Возвращенный клиентом заголовок кадра с флагом FRAME_FLAG_TRACED
+bool decode_frame_header_echo(const void* data, size_t size, TraceEcho& echo);
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <chrono>
+
+// Выдерживает заданную частоту кадров по абсолютным дедлайнам, поэтому
+// ошибка сна не накапливается. Если потребитель отстал больше чем на кадр,
+// расписание сдвигается без серии кадров "вдогонку", как у камеры.
+class FramePacer 
+{
+public:
+    explicit FramePacer(double fps = 0);
+
+    // fps <= 0 - без задержек
+    void set_fps(double fps);
+    void reset();
+    // Спит до следующего дедлайна; только для собственных потоков источников
+    void wait();
+    // Без ожидания: true и сдвиг расписания, если дедлайн наступил
+    bool due();
+
+private:
+    std::chrono::steady_clock::duration interval_{};
+    std::chrono::steady_clock::time_point next_;
+};
\ No newline at end of file
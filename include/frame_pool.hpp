@@ -0,0 +1,41 @@
+#pragma once
+
+#include "frame_trace.hpp"
+#include <opencv2/core/mat.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Буферы одного кадра: захваченное изображение и его ASCII-представление
+struct FrameBuffer 
+{
+    cv::Mat image;
+    std::string ascii;
+    FrameTrace trace;
+};
+
+// Пул заранее выделенных буферов кадров. Буфер свободен, когда на него
+// ссылается только сам пул: зрители держат shared_ptr, пока кадр стоит
+// в очереди на отправку, и после последней отправки буфер возвращается
+// в пул без освобождения памяти.
+//
+// Пока заняты все буферы, пул растет, но не больше max_size (по умолчанию
+// MAX_GROWTH * capacity). Сверх этого выдаются временные буферы, которые
+// не возвращаются в пул: зритель, который не успевает забирать кадры, не
+// может раздуть пул навсегда.
+class FramePool 
+{
+public:
+    explicit FramePool(size_t capacity, size_t max_size = 0);
+
+    std::shared_ptr<FrameBuffer> acquire();
+    size_t size() const { return buffers_.size(); }
+    size_t max_size() const { return max_size_; }
+
+    static constexpr size_t MAX_GROWTH = 4;
+
+private:
+    std::vector<std::shared_ptr<FrameBuffer>> buffers_;
+    size_t max_size_;
+    size_t next_{0};
+};
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Отметки времени кадра на пути от камеры до зрителя. Номер кадра 0 -
+// служебное сообщение или кадр без трассировки.
+struct FrameTrace 
+{
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t sequence{0};
+    Clock::time_point captured_at;
+    Clock::time_point converted_at;
+    Clock::time_point enqueued_at;
+
+    bool valid() const { return sequence != 0; }
+};
+
+// Двоичный заголовок перед кадром для клиентов, включивших трассировку.
+// Little-endian: номер кадра (u64), время отправки по часам сервера в
+// микросекундах (u64), задержка от захвата до отправки в микросекундах
+// (u32), резерв (u32). Клиент возвращает заголовок без изменений, и по
+// нему сервер считает время прохождения до браузера и обратно.
+constexpr size_t TRACE_HEADER_SIZE = 24;
+using TraceHeader = std::array<uint8_t, TRACE_HEADER_SIZE>;
+
+TraceHeader encode_trace_header(const FrameTrace& trace, FrameTrace::Clock::time_point sent_at);
+
+struct TraceEcho 
+{
+    uint64_t sequence{0};
+    FrameTrace::Clock::time_point sent_at;
+    // Задержка на сервере от захвата до отправки
+    std::chrono::microseconds pipeline{0};
+};
+
+bool decode_trace_echo(const void* data, size_t size, TraceEcho& echo);
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "frame_trace.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Получатель кадров трансляции: WebSocket-сессия зрителя или любой
+// другой потребитель, подписанный на StreamController
+class IFrameViewer 
+{
+public:
+    virtual ~IFrameViewer() = default;
+    // Вызывается из strand контроллера, поэтому только ставит кадр в очередь
+    virtual void send_frame(std::shared_ptr<const std::string> frame, const FrameTrace& trace = {}) = 0;
+    virtual uint64_t session_id() const = 0;
+};
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "ascii_converter_interface.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <opencv2/core/mat.hpp>
+
+// Конвертер, подбирающий символ по форме, а не только по средней яркости.
+// Каждая клетка делится на сетку 2x4, и выбирается символ, у которого
+// покрытие тех же подобластей ближе всего. Ближайший символ для каждого
+// квантованного набора из 8 отсчетов заранее записан в таблицу, поэтому
+// на кадр приходится один поиск в таблице на клетку.
+class GlyphMatchConverter : public IAsciiConverter 
+{
+public:
+    static constexpr int CELL_WIDTH = 2;
+    static constexpr int CELL_HEIGHT = 4;
+    static constexpr int SAMPLES = CELL_WIDTH * CELL_HEIGHT;
+    // 4 уровня на отсчет: ключ таблицы занимает 16 бит
+    static constexpr int LEVELS = 4;
+    static constexpr size_t TABLE_SIZE = size_t{1} << (2 * SAMPLES);
+
+    using GlyphVector = std::array<uint8_t, SAMPLES>;
+
+    GlyphMatchConverter();
+    void convert(const cv::Mat& frame, int output_width, int output_height, std::string& output) override;
+    void set_ascii_chars(const std::string& chars) override;
+    using IAsciiConverter::convert;
+
+    // Все печатные символы ASCII
+    static std::string printable_glyphs();
+    // Яркость подобластей символа, нарисованного темным на светлом
+    static std::vector<GlyphVector> render_glyphs(const std::string& glyphs);
+
+private:
+    void build_table();
+
+    std::string glyphs_;
+    std::vector<char> table_;
+    std::array<uint8_t, 256> quantize_{};
+
+    cv::Mat gray_;
+    cv::Mat samples_;
+};
\ No newline at end of file
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "session_stream.hpp"
+#include "admission_controller.hpp"
+
 #include <boost/beast.hpp>
 #include <boost/asio.hpp>
 #include <memory>
@@ -13,26 +16,46 @@ using tcp = net::ip::tcp;
 
 class Server;
 
-class HttpSession : public std::enable_shared_from_this<HttpSession> 
+// HTTP-сессия поверх TLS (TlsStream) или без шифрования (PlainStream,
+// LocalStream). При запросе upgrade поток передается WebSocketSession
+// того же типа.
+template <class Stream>
+class HttpSession : public std::enable_shared_from_this<HttpSession<Stream>> 
 {
 public:
     HttpSession(
-        tcp::socket socket,
-        net::ssl::context& ssl_ctx,
+        Stream stream,
         std::shared_ptr<Server> srv, 
-        std::string doc_root
+        std::string doc_root,
+        AdmissionController::Slot connection = {}
     );
     
     void run();
     
 private:
     void do_read();
+    void start_deadline(std::chrono::seconds timeout);
     void handle_request();
     std::string get_mime_type(const std::string& path) const;
     
-    net::ssl::stream<tcp::socket> stream_;
+    Stream stream_;
     std::shared_ptr<Server> server_;
     std::string doc_root_;
     beast::flat_buffer buffer_;
     http::request<http::string_body> request_;
-};
\ No newline at end of file
+    // Место в лимите соединений переходит к WebSocketSession при upgrade
+    AdmissionController::Slot connection_;
+    // Дедлайн TLS-рукопожатия, затем чтения запроса
+    net::steady_timer deadline_;
+    
+    // Клиент, не закончивший TLS-рукопожатие, не держит место в max_handshakes дольше
+    static constexpr std::chrono::seconds HANDSHAKE_TIMEOUT{10};
+    // Столько же ждем запрос целиком: медленный клиент не держит соединение
+    static constexpr std::chrono::seconds REQUEST_TIMEOUT{10};
+};
+
+extern template class HttpSession<TlsStream>;
+extern template class HttpSession<PlainStream>;
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+extern template class HttpSession<LocalStream>;
+#endif
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Слот "последнего значения" для одного писателя и одного читателя
+// (тройная буферизация). Писатель заполняет свой буфер и публикует его,
+// читатель забирает самый свежий, промежуточные значения пропускаются.
+// Блокировок нет: стороны обмениваются индексами буферов через один атомик.
+template <typename T>
+class LatestValueSlot 
+{
+public:
+    // Буфер писателя, доступен только потоку-писателю
+    T& back() 
+    {
+        return slots_[back_];
+    }
+
+    // Делает буфер писателя последним значением и выдает писателю свободный
+    void publish() 
+    {
+        back_ = state_.exchange(back_ | FRESH, std::memory_order_acq_rel) & INDEX;
+        state_.notify_one();
+    }
+
+    // Забирает последнее опубликованное значение, если читатель его еще не видел
+    bool update() 
+    {
+        if (!(state_.load(std::memory_order_relaxed) & FRESH)) 
+        {
+            return false;
+        }
+        front_ = state_.exchange(front_, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    // Буфер читателя, доступен только потоку-читателю
+    T& front() 
+    {
+        return slots_[front_];
+    }
+
+    // Ждет публикации нового значения или interrupt()
+    void wait_for_fresh() 
+    {
+        uint8_t state = state_.load(std::memory_order_acquire);
+        while (!(state & FRESH)) 
+        {
+            state_.wait(state, std::memory_order_acquire);
+            state = state_.load(std::memory_order_acquire);
+        }
+    }
+
+    // Будит ждущего читателя. Следующий update() может вернуть
+    // уже виденное значение, поэтому читатель проверяет причину сам.
+    void interrupt() 
+    {
+        state_.fetch_or(FRESH, std::memory_order_acq_rel);
+        state_.notify_all();
+    }
+
+private:
+    static constexpr uint8_t INDEX = 0x3;
+    static constexpr uint8_t FRESH = 0x4;
+
+    std::array<T, 3> slots_{};
+    std::atomic<uint8_t> state_{1};
+    uint8_t back_{0};
+    uint8_t front_{2};
+};
\ No newline at end of file
@@ -1,13 +1,59 @@
 #pragma once
 #include <spdlog/spdlog.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 
+// Логгер асинхронный: сообщение форматируется в вызывающем потоке и
+// кладется в заранее выделенную очередь, запись в консоль и файл идет
+// в отдельном потоке. На пути кадра отладочные сообщения пишутся через
+// SPDLOG_LOGGER_DEBUG и в сборках без Debug вырезаются при компиляции
+// (SPDLOG_ACTIVE_LEVEL задается в CMakeLists.txt).
 class Logger 
 {
 public:
     static void init();
-    static std::shared_ptr<spdlog::logger> get();
+    // Дописывает очередь и останавливает поток логгера
+    static void shutdown();
+    // Указатель без счетчика ссылок: логгер живет до shutdown()
+    static spdlog::logger* get() { return raw_logger_; }
+
+    // Сообщений в очереди; при переполнении вытесняются самые старые
+    static constexpr size_t QUEUE_SIZE = 8192;
 
 private:
     static std::shared_ptr<spdlog::logger> logger_;
+    static spdlog::logger* raw_logger_;
+};
+
+// Предупреждение не чаще раза в секунду для каждого места вызова
+#define LOG_WARN_RATE_LIMITED(...)                                                  \
+    do                                                                              \
+    {                                                                               \
+        static LogThrottle log_throttle_;                                           \
+        uint64_t log_suppressed_ = 0;                                               \
+        if (log_throttle_.allow(log_suppressed_))                                   \
+        {                                                                           \
+            Logger::get()->warn(__VA_ARGS__);                                       \
+            if (log_suppressed_ > 0)                                                \
+            {                                                                       \
+                Logger::get()->warn("{} similar warnings suppressed", log_suppressed_); \
+            }                                                                       \
+        }                                                                           \
+    } while (0)
+
+// Пропускает не больше одного сообщения за интервал, остальные считает
+class LogThrottle 
+{
+public:
+    explicit LogThrottle(std::chrono::milliseconds interval = std::chrono::seconds(1));
+
+    // true - сообщение можно писать; suppressed - сколько пропущено с прошлой записи
+    bool allow(uint64_t& suppressed);
+
+private:
+    const std::chrono::steady_clock::duration interval_;
+    std::atomic<std::chrono::steady_clock::rep> next_allowed_{0};
+    std::atomic<uint64_t> suppressed_{0};
 };
\ No newline at end of file
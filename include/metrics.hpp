@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Метрики горячего пути в формате Prometheus. Счетчики и гистограммы
+// разбиты на шарды по потокам: запись - одна relaxed-операция над
+// атомиком в своей кэш-линии, без блокировок и без общей линии между
+// потоками io_context. Шарды суммируются только при чтении (/metrics).
+namespace metrics {
+
+constexpr size_t SHARDS = 16;
+
+// Номер шарда закрепляется за потоком при первом обращении
+size_t shard_index();
+
+class Counter 
+{
+public:
+    Counter(std::string name, std::string help);
+
+    void inc(uint64_t n = 1) 
+    {
+        shards_[shard_index()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+    uint64_t value() const;
+
+    const std::string& name() const { return name_; }
+    const std::string& help() const { return help_; }
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+
+    std::string name_;
+    std::string help_;
+    Shard shards_[SHARDS];
+};
+
+// Текущее значение (число сессий и т.п.); меняется редко, поэтому без шардов
+class Gauge 
+{
+public:
+    Gauge(std::string name, std::string help);
+
+    void add(int64_t n) { value_.fetch_add(n, std::memory_order_relaxed); }
+    void set(int64_t n) { value_.store(n, std::memory_order_relaxed); }
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+    const std::string& name() const { return name_; }
+    const std::string& help() const { return help_; }
+
+private:
+    std::string name_;
+    std::string help_;
+    std::atomic<int64_t> value_{0};
+};
+
+// Гистограмма с фиксированными границами корзин. Значения пишутся в целых
+// единицах (для времени - микросекунды), при выводе умножаются на scale.
+class Histogram 
+{
+public:
+    Histogram(std::string name, std::string help, std::vector<uint64_t> bounds, double scale = 1.0);
+
+    void observe(uint64_t value);
+    void observe(std::chrono::microseconds duration) 
+    {
+        observe(static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0)));
+    }
+
+    struct Snapshot {
+        // Накопленные значения по корзинам, последняя - +Inf
+        std::vector<uint64_t> cumulative;
+        uint64_t count{0};
+        uint64_t sum{0};
+    };
+    Snapshot snapshot() const;
+    // Оценка квантиля с линейной интерполяцией внутри корзины, в единицах вывода
+    double quantile(const Snapshot& snapshot, double q) const;
+
+    const std::string& name() const { return name_; }
+    const std::string& help() const { return help_; }
+    const std::vector<uint64_t>& bounds() const { return bounds_; }
+    double scale() const { return scale_; }
+
+private:
+    struct alignas(64) Shard {
+        explicit Shard(size_t buckets) : counts(buckets) {}
+        std::vector<std::atomic<uint64_t>> counts;
+        std::atomic<uint64_t> sum{0};
+    };
+
+    std::string name_;
+    std::string help_;
+    std::vector<uint64_t> bounds_;
+    double scale_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+// Границы для времени в микросекундах: от 50 мкс до 1 с
+std::vector<uint64_t> latency_bounds_us();
+
+// Реестр всех метрик процесса. Метрики создаются один раз и живут до
+// конца программы, поэтому ссылки на них можно хранить в static-переменных.
+class Registry 
+{
+public:
+    static Registry& get();
+
+    Counter& counter(const std::string& name, const std::string& help);
+    Gauge& gauge(const std::string& name, const std::string& help);
+    Histogram& histogram(const std::string& name, const std::string& help, 
+                         std::vector<uint64_t> bounds, double scale = 1.0);
+    // Время в микросекундах, выводится в секундах
+    Histogram& latency(const std::string& name, const std::string& help);
+
+    // Текстовый формат Prometheus 0.0.4. Для гистограмм дополнительно
+    // выводятся оценки p50 и p99 отдельными метриками <name>_p50/<name>_p99.
+    std::string render() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Counter>> counters_;
+    std::vector<std::unique_ptr<Gauge>> gauges_;
+    std::vector<std::unique_ptr<Histogram>> histograms_;
+};
+
+} // namespace metrics
\ No newline at end of file
@@ -1,11 +1,14 @@
 #pragma once
 
+#include "recording_index.hpp"
+
 #include <fstream>
 #include <string>
 #include <chrono>
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <vector>
 #include <boost/asio.hpp>
 
 class PlaybackController 
@@ -29,12 +32,18 @@ public:
     void stop_playback();
     void set_playback_speed(double speed);
     
+    // Jumps to the start of the next/previous segment whose activity reaches
+    // the threshold. Requires the activity index written alongside the recording.
+    bool seek_to_activity(bool forward, int threshold);
+    bool has_activity_index() const;
+    
     bool is_playing() const;
     bool is_paused() const;
     RecordingInfo get_recording_info() const;
     
 private:
     void read_next_frame();
+    bool load_activity_index(const std::string& filename);
     
     boost::asio::io_context& ioc_;
     boost::asio::steady_timer playback_timer_;
@@ -48,4 +57,5 @@ private:
     RecordingInfo current_recording_info_;
     size_t current_frame_{0};
     long long next_frame_time_{0};
+    std::vector<IndexEntry> activity_index_;
 };
\ No newline at end of file
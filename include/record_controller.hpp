@@ -1,11 +1,19 @@
 #pragma once
 
+#include "frame_activity.hpp"
+#include "recording_index.hpp"
+
 #include <fstream>
 #include <string>
 #include <chrono>
 #include <atomic>
 #include <memory>
 #include <filesystem>
+#include <list>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
 #include <boost/asio.hpp>
 
 class RecordController 
@@ -14,17 +22,128 @@ public:
     RecordController(boost::asio::io_context& ioc);
     ~RecordController();
     
+    struct PreviewFrame {
+        long long timestamp;
+        std::string frame;
+    };
+    
+    struct RecordingPreview {
+        std::string filename;
+        size_t frame_count;
+        std::vector<PreviewFrame> frames;
+    };
+    
     bool start_recording();
     void stop_recording();
-    void write_frame(const std::string& frame);
+    void write_frame(const std::string& frame, int activity = 0);
     bool is_recording() const;
     std::string get_current_filename() const;
     
+    enum class PreviewStatus { Ready, Pending, Missing };
+    
+    // Previews are served from a cache bounded by preview_cache_limit bytes,
+    // least recently requested first out. A preview that is not cached
+    // (recordings made before the server started, or evicted ones) is parsed
+    // on a worker thread and reported as Pending until it is ready
+    PreviewStatus get_preview(const std::string& filename, RecordingPreview& preview);
+    void remove_preview(const std::string& filename);
+    void set_preview_cache_limit(size_t bytes);
+    size_t preview_cache_bytes() const;
+    
+    static constexpr size_t PREVIEW_SNAPSHOTS = 8;
+    static constexpr size_t DEFAULT_PREVIEW_CACHE_BYTES = 64 * 1024 * 1024;
+    
+    // Motion-triggered recording: the last pre_roll_seconds of frames are kept
+    // in a ring bounded both in frames and in bytes; once activity reaches the
+    // threshold the ring is flushed into a new recording, which stops after
+    // cooldown_seconds of calm
+    struct AutoRecordSettings {
+        int pre_roll_seconds = 5;
+        int fps = 10;
+        int threshold = DEFAULT_ACTIVITY_THRESHOLD;
+        int cooldown_seconds = 10;
+    };
+    
+    void enable_auto_record(const AutoRecordSettings& settings);
+    void disable_auto_record();
+    bool is_auto_record_enabled() const;
+    // Resizes the pre-roll ring for a new capture rate, keeping the newest frames
+    void set_auto_record_fps(int fps);
+    
+    // Memory the ring may hold, frame buffers included; when a frame does not
+    // fit, the oldest frames are dropped, so large grids get a shorter pre-roll
+    void set_pre_roll_budget(size_t bytes);
+    size_t pre_roll_bytes() const { return pre_roll_bytes_; }
+    
+    // Upper bound on the ring size whatever the settings are
+    static constexpr size_t MAX_PRE_ROLL_FRAMES = 3600;
+    static constexpr size_t DEFAULT_PRE_ROLL_BYTES = 64 * 1024 * 1024;
+    
+    // Entry point for the capture loop: records the frame if a recording is
+    // active and drives the auto-record state machine
+    void process_frame(const std::string& frame, int activity);
+    
 private:
+    struct RingFrame {
+        std::chrono::steady_clock::time_point captured_at;
+        std::string frame;
+        int activity;
+    };
+    
+    void write_frame_at(std::chrono::steady_clock::time_point captured_at, 
+                        const std::string& frame, int activity);
+    void flush_pre_roll();
+    void push_pre_roll(std::chrono::steady_clock::time_point captured_at, 
+                       const std::string& frame, int activity);
+    void release_pre_roll_buffers();
+    static size_t buffer_bytes(const std::string& frame);
+    static size_t pre_roll_capacity(const AutoRecordSettings& settings);
+    void write_index() const;
+    void sample_preview_frame(long long timestamp, const std::string& frame);
+    RecordingPreview finish_preview() const;
+    static bool build_preview_from_file(const std::string& path, RecordingPreview& preview);
+    void build_preview_async(const std::string& filename);
+    // Called under catalog_mutex_
+    void cache_preview(RecordingPreview preview);
+    static size_t preview_bytes(const RecordingPreview& preview);
+    // Frame numbers sampled for a recording of frame_count frames, last frame included
+    static std::vector<size_t> sampled_frames(size_t frame_count);
+    // Positions of count evenly spaced items out of size
+    static std::vector<size_t> pick_evenly(size_t size, size_t count);
+    static bool read_frame_at(std::istream& file, std::streamoff offset, PreviewFrame& frame);
+    
     boost::asio::io_context& ioc_;
     std::ofstream record_file_;
     std::atomic<bool> is_recording_{false};
     std::string filename_;
     std::chrono::steady_clock::time_point start_time_;
     size_t frame_count_{0};
+    std::vector<IndexEntry> index_;
+    
+    std::vector<PreviewFrame> preview_samples_;
+    size_t preview_stride_{1};
+    
+    std::atomic<bool> auto_record_{false};
+    bool auto_started_{false};
+    AutoRecordSettings auto_settings_;
+    std::chrono::steady_clock::time_point last_activity_;
+    std::vector<RingFrame> pre_roll_;
+    size_t pre_roll_head_{0};
+    size_t pre_roll_size_{0};
+    // Heap memory held by the slots' buffers
+    size_t pre_roll_bytes_{0};
+    size_t pre_roll_budget_{DEFAULT_PRE_ROLL_BYTES};
+    
+    mutable std::mutex catalog_mutex_;
+    // Most recently requested first
+    std::list<RecordingPreview> preview_lru_;
+    std::unordered_map<std::string, std::list<RecordingPreview>::iterator> preview_catalog_;
+    size_t preview_bytes_{0};
+    size_t preview_cache_limit_{DEFAULT_PREVIEW_CACHE_BYTES};
+    // Previews queued on the worker, and recordings that could not be parsed
+    std::set<std::string> preview_building_;
+    std::set<std::string> preview_failed_;
+    
+    // Declared last so that it stops before the catalog it fills is destroyed
+    boost::asio::thread_pool preview_builder_{1};
 };
\ No newline at end of file
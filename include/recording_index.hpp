@@ -0,0 +1,20 @@
+#pragma once
+
+#include <ios>
+#include <string>
+#include <vector>
+
+// Activity index of a recording, stored next to it as <name>.idx.
+// One entry per frame, written by RecordController and read by PlaybackController.
+struct IndexEntry 
+{
+    long long timestamp;
+    std::streamoff offset;
+    int activity;
+};
+
+std::string index_filename(const std::string& recording);
+
+bool write_recording_index(const std::string& path, const std::vector<IndexEntry>& entries);
+// false if the file is missing, malformed or empty
+bool read_recording_index(const std::string& path, std::vector<IndexEntry>& entries);
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "frame_pool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+
+namespace net = boost::asio;
+
+class StreamController;
+
+// Подписка ретранслятора на исходный сервер. Ретранслятор подключается
+// к origin как один обычный зритель и передает полученные кадры своему
+// StreamController, который раздает их локальным зрителям. Нагрузка на
+// origin не зависит от числа зрителей ретранслятора.
+class RelayClient : public std::enable_shared_from_this<RelayClient> 
+{
+public:
+    RelayClient(
+        net::io_context& ioc,
+        std::string upstream,
+        std::shared_ptr<StreamController> controller,
+        const std::string& ca_file = {},
+        bool insecure_localhost = false
+    );
+
+    void run();
+    void stop();
+    bool is_connected() const { return connected_.load(); }
+
+    // "host:port" -> {host, port}; без порта используется 8080
+    static std::pair<std::string, std::string> parse_upstream(const std::string& upstream);
+    // "localhost", 127.0.0.0/8 или ::1
+    static bool is_loopback_host(const std::string& host);
+
+    static constexpr std::chrono::seconds MIN_RETRY_DELAY{1};
+    static constexpr std::chrono::seconds MAX_RETRY_DELAY{10};
+
+private:
+    net::awaitable<void> run_loop();
+    net::awaitable<std::string> fetch_api_key();
+    net::awaitable<void> relay_frames();
+
+    net::strand<net::io_context::executor_type> strand_;
+    net::ssl::context ssl_ctx_;
+    std::string host_;
+    std::string port_;
+    std::shared_ptr<StreamController> controller_;
+    FramePool frame_pool_;
+    net::steady_timer retry_timer_;
+    std::atomic<bool> connected_{false};
+    std::atomic<bool> stop_requested_{false};
+
+    // Текущий кадр, последний у StreamController и очереди локальных зрителей
+    static constexpr size_t FRAME_POOL_SIZE = 12;
+};
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <string_view>
+
+// Дополнительные стадии обработки кадра перед подбором символов.
+// Все стадии работают на уменьшенной сетке яркости размером с ASCII-кадр.
+struct RenderOptions 
+{
+    enum class Tone {
+        Linear,     // яркость как есть
+        Gamma,      // степенная коррекция с показателем gamma
+        Equalize    // выравнивание гистограммы каждого кадра
+    };
+
+    enum class Dither {
+        None,
+        Ordered,        // матрица Байера 4x4
+        FloydSteinberg  // диффузия ошибки
+    };
+
+    Tone tone = Tone::Linear;
+    double gamma = 2.2;
+    Dither dither = Dither::None;
+    // Границы рисуются символами / \ | -
+    bool edges = false;
+    // Порог |Gx| + |Gy| оператора Собеля
+    int edge_threshold = 200;
+
+    static Tone parse_tone(std::string_view name);
+    static Dither parse_dither(std::string_view name);
+};
+
+// Время стадий последней конвертации
+struct StageTimings 
+{
+    std::chrono::microseconds resize{0};
+    std::chrono::microseconds tone{0};
+    std::chrono::microseconds dither{0};
+    std::chrono::microseconds edges{0};
+    std::chrono::microseconds map{0};
+    std::chrono::microseconds total{0};
+};
\ No newline at end of file
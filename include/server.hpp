@@ -2,10 +2,13 @@
 
 #include "ascii_converter_interface.hpp"
 #include "video_source_interface.hpp"
+#include "session_stream.hpp"
+#include "admission_controller.hpp"
 
 #include <boost/asio.hpp>
 #include <boost/asio/ssl.hpp>
 #include <memory>
+#include <optional>
 #include <string>
 
 namespace net = boost::asio;
@@ -34,10 +37,25 @@ public:
     net::ssl::context& ssl_context() { return ssl_ctx_; }
 
     std::string cloud_tunnel_url() const { return cloud_tunnel_url_; }
+    // Сжатие permessage-deflate для новых WebSocket-соединений
+    void set_websocket_compression(bool enabled) { websocket_compression_ = enabled; }
+    bool websocket_compression() const { return websocket_compression_; }
+    // Ограничения на соединения и auth; задаются до run()
+    void set_admission_limits(const AdmissionLimits& limits);
+    AdmissionController& admission() { return *admission_; }
     void setup_cloud_tunnel();
     
+    // Дополнительный слушатель того же HTTP/WebSocket без TLS - для прокси,
+    // который сам завершает TLS, и локальных клиентов: "host:port" или
+    // "unix:/path/to.sock"
+    void listen_plain(const std::string& address);
+    // Адрес WebSocket для клиентов внутреннего слушателя (в ответе /api)
+    std::string plain_stream_url() const { return plain_stream_url_; }
+    
 private:
     void do_accept();
+    template <class Session, class Acceptor>
+    void do_accept_plain(Acceptor& acceptor);
     
     net::io_context& ioc_;
     net::ssl::context ssl_ctx_;
@@ -48,6 +66,15 @@ private:
     std::shared_ptr<IVideoSource> video_source_;
     std::shared_ptr<IAsciiConverter> ascii_converter_;
     std::string cloud_tunnel_url_;
+    bool websocket_compression_{false};
+    std::shared_ptr<AdmissionController> admission_;
+    
+    std::optional<tcp::acceptor> plain_acceptor_;
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+    std::optional<net::local::stream_protocol::acceptor> local_acceptor_;
+#endif
+    std::string local_socket_path_;
+    std::string plain_stream_url_;
 };
 
 std::shared_ptr<Server> make_server(net::io_context& ioc, 
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Настройки сервера. Загружаются из JSON-файла, отсутствующие поля
+// остаются со значениями по умолчанию.
+struct ServerConfig 
+{
+    std::string address = "0.0.0.0";
+    unsigned short port = 8080;
+    std::string doc_root = "../web";
+    bool enable_cloud_tunnel = true;
+
+    // Через сколько секунд без зрителей и записи захват ставится на паузу
+    int idle_linger_seconds = 10;
+    // Освобождать ли камеру на время паузы
+    bool release_camera_when_idle = true;
+
+    // Источник кадров: "opencv" (cv::VideoCapture), "v4l2" (только Linux),
+    // "file" (видеофайл по кругу) или "synthetic" (генератор для тестов)
+    std::string video_backend = "opencv";
+    std::string video_file;
+    std::string synthetic_pattern = "gradient";
+    // Частота кадров файла/генератора: 0 - родная, < 0 - без задержек
+    double source_fps = 0;
+
+    // Конвертер: "brightness" (символ по средней яркости), "glyph" (по форме),
+    // "braille" или "half_block" (символы Unicode, 3 байта UTF-8 на клетку)
+    std::string converter = "brightness";
+    // Набор символов; пустая строка - набор по умолчанию для выбранного конвертера
+    std::string ascii_chars;
+    // Сжатие кадров в WebSocket (permessage-deflate)
+    bool websocket_compression = false;
+    // Дополнительный слушатель без TLS: "127.0.0.1:8081" или
+    // "unix:/run/ascii_streamer.sock"; пустая строка - только HTTPS/WSS
+    std::string plain_listen;
+
+    // Адрес исходного сервера "host:port". Если задан, сервер работает
+    // ретранслятором: подписывается на origin как один зритель и раздает
+    // его кадры своим зрителям, камера и video_backend не используются
+    std::string relay_upstream;
+    // Сертификат origin проверяется всегда: по этому файлу CA (PEM) или,
+    // если он не задан, по системному хранилищу
+    std::string relay_ca_file;
+    // Отключить проверку сертификата; допускается только для origin на
+    // loopback-адресе (самоподписанный сертификат при тестах на одной машине)
+    bool relay_insecure_localhost = false;
+
+    // Имя сегмента разделяемой памяти для локальных потребителей кадров
+    // (например "/ascii_frames"); пустая строка - шина выключена
+    std::string frame_bus_name;
+    unsigned frame_bus_slots = 8;
+    // Емкость слота: кадр 320x240 "braille" занимает около 230 КБ
+    size_t frame_bus_slot_bytes = 256 * 1024;
+
+    // Допуск соединений (AdmissionLimits), 0 - без ограничения. Лимиты по
+    // адресу не действуют для loopback и Unix-сокета
+    size_t max_connections = 1024;
+    size_t max_handshakes = 64;
+    double connections_per_ip_per_second = 10;
+    double connection_burst_per_ip = 20;
+    size_t max_connections_per_ip = 64;
+    unsigned max_auth_failures = 5;
+    int auth_lockout_seconds = 60;
+    size_t max_viewers = 0;
+    
+    // Память буфера предзаписи авто-записи, МБ
+    size_t auto_record_pre_roll_mb = 64;
+};
+
+ServerConfig load_config(const std::string& path);
\ No newline at end of file
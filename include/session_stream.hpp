@@ -0,0 +1,60 @@
+#pragma once
+
+#include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+#include <string>
+
+namespace net = boost::asio;
+using tcp = net::ip::tcp;
+
+// Транспорты, поверх которых работают HttpSession и WebSocketSession.
+// Протокол HTTP/WebSocket один и тот же, отличается только наличие TLS.
+using TlsStream = net::ssl::stream<tcp::socket>;
+using PlainStream = tcp::socket;
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+using LocalStream = net::local::stream_protocol::socket;
+#endif
+
+template <class Stream>
+struct StreamTraits 
+{
+    static constexpr bool secure = false;
+    static constexpr const char* name = "tcp";
+};
+
+template <class NextLayer>
+struct StreamTraits<net::ssl::stream<NextLayer>> 
+{
+    static constexpr bool secure = true;
+    static constexpr const char* name = "tls";
+};
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+template <>
+struct StreamTraits<LocalStream> 
+{
+    static constexpr bool secure = false;
+    static constexpr const char* name = "unix";
+};
+#endif
+
+// Адрес клиента для ограничений по IP (AdmissionController). У Unix-сокета
+// и у уже отключившегося клиента - пустая строка.
+inline std::string peer_address(const tcp::socket& socket) 
+{
+    boost::system::error_code ec;
+    const auto endpoint = socket.remote_endpoint(ec);
+    return ec ? std::string() : endpoint.address().to_string();
+}
+
+inline std::string peer_address(const TlsStream& stream) 
+{
+    return peer_address(stream.next_layer());
+}
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+inline std::string peer_address(const LocalStream&) 
+{
+    return {};
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Шина кадров в разделяемой памяти POSIX для процессов на той же машине.
+// Один писатель (сервер) и любое число читателей без блокировок: сегмент
+// содержит кольцо из slot_count слотов, каждый слот защищен seqlock -
+// писатель делает версию нечетной на время записи, читатель копирует кадр
+// и проверяет, что версия до и после копирования одна и та же и четная.
+// Читатели не пишут в сегмент и не задерживают сервер; отставший больше
+// чем на кольцо читатель теряет старые кадры.
+//
+// Раскладка сегмента (все поля little-endian, выравнивание 64 байта):
+//   Header | слот 0 | слот 1 | ... | слот slot_count-1
+//   слот: SlotHeader, затем slot_capacity байт кадра, шаг slot_stride
+// Кадр с номером N лежит в слоте (N - 1) % slot_count, номера начинаются с 1.
+namespace frame_bus {
+
+constexpr uint64_t MAGIC = 0x5355424949435341ULL; // "ASCIIBUS"
+constexpr uint32_t LAYOUT_VERSION = 1;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "frame bus needs lock-free 64-bit atomics");
+
+struct alignas(64) Header 
+{
+    uint64_t magic;
+    uint32_t version;
+    uint32_t slot_count;
+    uint64_t slot_capacity;
+    uint64_t slot_stride;
+    // Номер последнего опубликованного кадра, 0 - кадров еще не было
+    std::atomic<uint64_t> latest;
+};
+
+struct alignas(64) SlotHeader 
+{
+    // seqlock: нечетное значение - слот переписывается
+    std::atomic<uint64_t> version;
+    std::atomic<uint64_t> sequence;
+    // steady_clock (CLOCK_MONOTONIC) - общие часы для процессов одной машины
+    std::atomic<int64_t> timestamp_ns;
+    std::atomic<uint64_t> size;
+};
+
+struct Frame 
+{
+    uint64_t sequence = 0;
+    std::chrono::steady_clock::time_point published_at;
+    std::string data;
+};
+
+// Сторона сервера. Создает сегмент заново (оставшийся после аварийного
+// завершения удаляется) и удаляет его в деструкторе.
+class Writer 
+{
+public:
+    Writer(std::string name, uint32_t slot_count, size_t slot_capacity);
+    ~Writer();
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    // false - кадр не помещается в слот и не опубликован
+    bool publish(std::string_view frame, std::chrono::steady_clock::time_point timestamp);
+    uint64_t published() const { return next_sequence_; }
+    const std::string& name() const { return name_; }
+    size_t slot_capacity() const;
+
+private:
+    std::string name_;
+    int fd_{-1};
+    unsigned char* base_{nullptr};
+    size_t mapped_size_{0};
+    Header* header_{nullptr};
+    uint64_t next_sequence_{0};
+};
+
+// Сторона потребителя. Отображает сегмент только для чтения.
+class Reader 
+{
+public:
+    explicit Reader(std::string name);
+    ~Reader();
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    // Следующий кадр после прочитанного; false - новых кадров нет.
+    // Отставший читатель перескакивает на самый старый кадр в кольце,
+    // пропущенные кадры считаются в dropped()
+    bool read_next(Frame& frame);
+    // Последний опубликованный кадр, без учета позиции читателя
+    bool read_latest(Frame& frame);
+
+    uint64_t latest_sequence() const;
+    uint64_t dropped() const { return dropped_; }
+    uint32_t slot_count() const { return header_->slot_count; }
+
+    static constexpr int MAX_READ_ATTEMPTS = 64;
+
+private:
+    bool read_slot(uint64_t sequence, Frame& frame) const;
+    uint64_t oldest_available(uint64_t latest) const;
+
+    std::string name_;
+    int fd_{-1};
+    const unsigned char* base_{nullptr};
+    size_t mapped_size_{0};
+    const Header* header_{nullptr};
+    uint64_t cursor_{0};
+    uint64_t dropped_{0};
+};
+
+} // namespace frame_bus
\ No newline at end of file
@@ -4,6 +4,9 @@
 #include "ascii_converter_interface.hpp"
 #include "record_controller.hpp"
 #include "playback_controller.hpp"
+#include "frame_pool.hpp"
+#include "frame_viewer_interface.hpp"
+#include "shm_frame_bus.hpp"
 
 #include <memory>
 #include <string>
@@ -17,8 +20,6 @@ namespace net = boost::asio;
 using net::as_tuple;
 using namespace net::experimental::awaitable_operators;
 
-class WebSocketSession;
-
 class StreamController : public std::enable_shared_from_this<StreamController> 
 {
 public:
@@ -33,45 +34,111 @@ public:
     net::awaitable<void> stop_streaming();
     bool is_streaming() const;
     
-    void add_viewer(std::shared_ptr<WebSocketSession> viewer);
-    net::awaitable<void> remove_viewer(std::shared_ptr<WebSocketSession> viewer);
+    void add_viewer(std::shared_ptr<IFrameViewer> viewer);
+    // Сессия контроллера получает кадры как зритель, но не держит захват:
+    // без других зрителей и записи он приостанавливается
+    void add_controller(std::shared_ptr<IFrameViewer> controller);
+    net::awaitable<void> remove_viewer(std::shared_ptr<IFrameViewer> viewer);
     net::awaitable<void> remove_viewer_by_id(uint64_t session_id);
+    // Раздает кадр всем зрителям без копирования
+    net::awaitable<void> broadcast_frame(std::shared_ptr<const std::string> frame, FrameTrace trace = {});
+    
+    // Режим ретранслятора: кадры приходят от исходного сервера через
+    // relay_frame, собственный источник видео не открывается
+    void set_relay_mode(bool enabled);
+    bool is_relay() const { return relay_mode_.load(); }
+    // Идет ли трансляция на исходном сервере - по его STREAM_ACTIVE и
+    // STREAM_INACTIVE, а не по наличию подключения. Смена состояния
+    // пересылается локальным зрителям
+    void set_upstream_active(bool active);
+    net::awaitable<void> relay_frame(std::shared_ptr<const std::string> frame);
+    
+    // Каждый разосланный кадр дополнительно публикуется в разделяемую память
+    // для локальных процессов. Читатели шины не считаются зрителями и не
+    // будят приостановленный захват.
+    void set_frame_bus(std::shared_ptr<frame_bus::Writer> writer);
     
     std::string get_status() const;
+    bool is_idle() const;
+    // Время от снятия последнего разосланного кадра до постановки его в очереди зрителей
+    std::chrono::microseconds capture_latency() const;
+    
+    // Захват приостанавливается, если linger времени нет ни зрителей, ни записи
+    void set_idle_policy(std::chrono::seconds linger, bool release_device);
+    void set_render_options(const RenderOptions& options);
+    // Набор символов, который получит конвертер при запуске трансляции
+    void set_ascii_chars(const std::string& chars);
 
     void start_recording();
     void stop_recording();
     bool is_recording() const;
+    void enable_auto_record(int pre_roll_seconds, int threshold, int cooldown_seconds);
+    void disable_auto_record();
+    std::shared_ptr<RecordController> record_controller() { return record_controller_; }
 
     net::awaitable<void> start_playback(const std::string& filename, 
-                                       std::shared_ptr<WebSocketSession> session);
+                                       std::shared_ptr<IFrameViewer> session);
     net::awaitable<void> pause_playback();
     net::awaitable<void> resume_playback();
     net::awaitable<void> stop_playback();
     net::awaitable<void> set_playback_speed(double speed);
+    net::awaitable<bool> seek_playback_activity(bool forward, int threshold);
 
 private:
     net::awaitable<void> capture_loop();
-    net::awaitable<void> broadcast_frame(const std::string& frame);
+    net::awaitable<void> wait_for_consumers();
+    bool has_consumers();
+    // Сообщает зрителям о начале и конце трансляции; вызывается в strand_
+    void broadcast_status(bool active);
+    void wake_up();
     void cleanup();
 
     net::io_context& ioc_;
     net::strand<net::io_context::executor_type> strand_;
     std::shared_ptr<IVideoSource> video_source_;
     std::shared_ptr<IAsciiConverter> ascii_converter_;
-    std::vector<std::weak_ptr<WebSocketSession>> viewers_;
+    std::vector<std::weak_ptr<IFrameViewer>> viewers_;
+    std::weak_ptr<IFrameViewer> controller_viewer_;
+    std::shared_ptr<FrameBuffer> last_frame_;
+    std::shared_ptr<const std::string> last_relayed_;
+    std::chrono::steady_clock::time_point last_broadcast_;
     
     std::atomic<int> frame_width_{120};
     std::atomic<int> frame_height_{90};
     std::atomic<int> fps_{10};
     std::atomic<bool> is_streaming_{false};
     std::atomic<bool> stop_requested_{false};
+    std::atomic<bool> is_idle_{false};
+    std::atomic<bool> relay_mode_{false};
+    std::atomic<bool> upstream_active_{false};
+    std::atomic<long long> capture_latency_us_{0};
+    int camera_index_{0};
+    uint64_t next_sequence_{0};
+    std::string ascii_chars_{DEFAULT_ASCII_CHARS};
+    std::chrono::seconds idle_linger_{10};
+    bool release_device_when_idle_{true};
+    std::chrono::steady_clock::time_point no_consumers_since_;
     
     net::steady_timer frame_timer_;
+    net::steady_timer idle_timer_;
+    FramePool frame_pool_;
+    std::shared_ptr<const std::string> heartbeat_;
+    std::shared_ptr<const std::string> stream_active_;
+    std::shared_ptr<const std::string> stream_inactive_;
+    std::shared_ptr<frame_bus::Writer> frame_bus_;
     net::cancellation_signal capture_cancel_;
 
     std::shared_ptr<RecordController> record_controller_;
 
     std::shared_ptr<PlaybackController> playback_controller_;
-    std::shared_ptr<WebSocketSession> playback_session_;
+    std::shared_ptr<IFrameViewer> playback_session_;
+
+    static constexpr const char* DEFAULT_ASCII_CHARS = "@%#*+=-:. ";
+    static constexpr std::chrono::seconds KEEPALIVE_INTERVAL{2};
+    static constexpr const char* HEARTBEAT_MESSAGE = "HEARTBEAT";
+    static constexpr int MAX_FPS = 60;
+    static constexpr int MAX_PRE_ROLL_SECONDS = 60;
+    static constexpr int MAX_AUTO_RECORD_COOLDOWN_SECONDS = 3600;
+    // Текущий кадр, предыдущий и по одному на каждое место в очереди зрителя
+    static constexpr size_t FRAME_POOL_SIZE = 12;
 };
\ No newline at end of file
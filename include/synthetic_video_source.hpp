@@ -0,0 +1,46 @@
+#pragma once
+
+#include "video_source_interface.hpp"
+#include "frame_pacer.hpp"
+#include <opencv2/opencv.hpp>
+#include <string>
+
+// Генератор тестовых кадров для нагрузочных тестов без камеры.
+// Содержимое зависит только от номера кадра, поэтому прогоны воспроизводимы.
+class SyntheticVideoSource : public IVideoSource 
+{
+public:
+    enum class Pattern {
+        Gradient,   // диагональный градиент, сдвигается каждый кадр
+        Noise,      // равномерный шум с фиксированным зерном
+        Static      // неподвижный градиент
+    };
+
+    static Pattern parse_pattern(const std::string& name);
+
+    // fps > 0 - темп смены кадров, 0 - DEFAULT_FPS, < 0 - новый кадр на каждый вызов
+    explicit SyntheticVideoSource(Pattern pattern, double fps = 0);
+    bool is_available() const override;
+    void capture_frame(cv::Mat& frame) override;
+    using IVideoSource::capture_frame;
+    void set_resolution(int width, int height) override;
+    void open(int index) override;
+    void close() override;
+    std::chrono::steady_clock::time_point last_capture_time() const override;
+
+    static constexpr double DEFAULT_FPS = 30;
+    static constexpr uint64_t NOISE_SEED = 0x5eed;
+
+private:
+    void draw_gradient(cv::Mat& frame, int shift) const;
+
+    Pattern pattern_;
+    FramePacer pacer_;
+    int width_{640};
+    int height_{480};
+    long long frame_index_{0};
+    // Номер кадра, который выдается сейчас
+    long long current_{0};
+    bool is_opened_{false};
+    std::chrono::steady_clock::time_point last_capture_time_;
+};
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "ascii_converter_interface.hpp"
+#include <string>
+#include <opencv2/core/mat.hpp>
+
+// Конвертер в символы Unicode: шрифт Брайля (2x4 точки в клетке) или
+// полублоки (2 "пикселя" в клетке). При той же сетке символов разрешение
+// выше, но каждый символ занимает 3 байта UTF-8.
+class UnicodeConverter : public IAsciiConverter 
+{
+public:
+    enum class Mode {
+        Braille,
+        HalfBlock
+    };
+
+    static Mode parse_mode(const std::string& name);
+
+    explicit UnicodeConverter(Mode mode = Mode::Braille);
+    void convert(const cv::Mat& frame, int output_width, int output_height, std::string& output) override;
+    // Набор символов задан режимом, строка символов не используется
+    void set_ascii_chars(const std::string& chars) override;
+    using IAsciiConverter::convert;
+
+    // Все символы режимов лежат в диапазоне U+0800..U+FFFF, поэтому каждая
+    // клетка занимает ровно 3 байта и размер кадра известен заранее
+    static constexpr size_t GLYPH_BYTES = 3;
+    static size_t frame_size(int output_width, int output_height);
+
+private:
+    void emit_braille(int output_width, int output_height, int threshold, char* out) const;
+    void emit_half_blocks(int output_width, int output_height, int threshold, char* out) const;
+
+    Mode mode_;
+    cv::Mat gray_;
+    cv::Mat samples_;
+};
\ No newline at end of file
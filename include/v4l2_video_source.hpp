@@ -0,0 +1,81 @@
+#pragma once
+
+#include "video_source_interface.hpp"
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+// Системные вызовы, через которые идет работа с устройством.
+// В тестах подменяются эмулятором драйвера.
+struct V4l2DeviceOps 
+{
+    std::function<int(const std::string& path)> open;
+    std::function<int(int fd)> close;
+    std::function<int(int fd, unsigned long request, void* arg)> ioctl;
+    std::function<void*(int fd, size_t length, off_t offset)> mmap;
+    std::function<int(void* addr, size_t length)> munmap;
+    // > 0 - есть кадр, 0 - таймаут, < 0 - ошибка
+    std::function<int(int fd, int timeout_ms)> wait_frame;
+
+    static V4l2DeviceOps system();
+};
+
+// Захват напрямую через V4L2 с буферами драйвера, отображенными в память.
+// Цвет для ASCII не нужен, поэтому из кадра берется только яркость:
+// YUYV - канал Y, NV12/GREY - плоскость Y без копирования, MJPEG -
+// декодирование в оттенках серого с уменьшением (при масштабе 1/8
+// libjpeg использует только DC-коэффициенты).
+class V4l2VideoSource : public IVideoSource 
+{
+public:
+    explicit V4l2VideoSource(V4l2DeviceOps ops = V4l2DeviceOps::system());
+    ~V4l2VideoSource();
+    bool is_available() const override;
+    // Для NV12/GREY кадр ссылается на буфер драйвера и действителен
+    // до следующего вызова capture_frame или close
+    void capture_frame(cv::Mat& frame) override;
+    using IVideoSource::capture_frame;
+    void set_resolution(int width, int height) override;
+    void open(int index) override;
+    void close() override;
+    std::chrono::steady_clock::time_point last_capture_time() const override;
+
+    uint32_t pixel_format() const;
+
+    static constexpr unsigned BUFFER_COUNT = 4;
+    static constexpr int CAPTURE_TIMEOUT_MS = 1000;
+
+private:
+    struct MappedBuffer {
+        void* data{nullptr};
+        size_t length{0};
+    };
+
+    void configure();
+    void release_buffers();
+    void requeue_pending();
+    void extract_luma(const MappedBuffer& buffer, size_t bytes_used, cv::Mat& frame);
+    int mjpeg_decode_flags() const;
+    int xioctl(unsigned long request, void* arg);
+
+    V4l2DeviceOps ops_;
+    int fd_{-1};
+    int camera_index_{-1};
+    int width_{640};
+    int height_{480};
+
+    // Параметры, которые согласовал драйвер
+    uint32_t pixel_format_{0};
+    int frame_width_{0};
+    int frame_height_{0};
+    size_t bytes_per_line_{0};
+
+    std::vector<MappedBuffer> buffers_;
+    int pending_index_{-1};
+    bool is_streaming_{false};
+    std::chrono::steady_clock::time_point last_capture_time_;
+};
\ No newline at end of file
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "video_source_interface.hpp"
+#include "latest_value_slot.hpp"
 #include <opencv2/opencv.hpp>
+#include <atomic>
 #include <memory>
+#include <thread>
 
 class VideoSource : public IVideoSource 
 {
@@ -10,10 +13,15 @@ public:
     VideoSource();
     ~VideoSource();
     bool is_available() const override;
-    cv::Mat capture_frame() override;
+    // Отдает самый свежий кадр, снятый фоновым потоком. Буфер frame
+    // забирается источником для следующих кадров, поэтому других ссылок
+    // на его данные держать не нужно.
+    void capture_frame(cv::Mat& frame) override;
+    using IVideoSource::capture_frame;
     void set_resolution(int width, int height) override;
     void open(int index) override;
     void close() override;
+    std::chrono::steady_clock::time_point last_capture_time() const override;
 
     struct CameraInfo {
         int index;
@@ -22,9 +30,25 @@ public:
     static std::vector<CameraInfo> list_cameras();
     
 private:
+    struct CapturedFrame {
+        cv::Mat image;
+        std::chrono::steady_clock::time_point captured_at;
+    };
+
+    void start_grabber();
+    void stop_grabber();
+    void grab_loop();
+
     cv::VideoCapture cap_;
     int camera_index_{-1};
     int width_{640};
     int height_{480};
     bool is_opened_{false};
+
+    // Камера читается в отдельном потоке, чтобы в очереди драйвера
+    // не копились старые кадры, пока идет конвертация
+    LatestValueSlot<CapturedFrame> latest_;
+    std::thread grabber_;
+    std::atomic<bool> grabbing_{false};
+    std::chrono::steady_clock::time_point last_capture_time_;
 };
\ No newline at end of file
@@ -1,14 +1,31 @@
 #pragma once
 
 #include <opencv2/opencv.hpp>
+#include <chrono>
 
 class IVideoSource 
 {
 public:
     virtual ~IVideoSource() = default;
     virtual bool is_available() const = 0;
-    virtual cv::Mat capture_frame() = 0;
+    // Кадр пишется в переданный буфер, чтобы его память переиспользовалась
+    // между кадрами. При ошибке захвата буфер остается пустым.
+    virtual void capture_frame(cv::Mat& frame) = 0;
     virtual void set_resolution(int width, int height) = 0;
     virtual void open(int index) = 0;
     virtual void close() = 0;
+
+    // Когда был снят последний выданный кадр. Пустое значение -
+    // источник время захвата не знает.
+    virtual std::chrono::steady_clock::time_point last_capture_time() const 
+    {
+        return {};
+    }
+
+    cv::Mat capture_frame() 
+    {
+        cv::Mat frame;
+        capture_frame(frame);
+        return frame;
+    }
 };
\ No newline at end of file
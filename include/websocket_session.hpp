@@ -1,7 +1,13 @@
 #pragma once
 
 #include "stream_controller.hpp"
+#include "frame_viewer_interface.hpp"
+#include "session_stream.hpp"
+#include "frame_header.hpp"
+#include "control_message.hpp"
+#include "admission_controller.hpp"
 
+#include <array>
 #include <memory>
 #include <deque>
 #include <boost/beast.hpp>
@@ -16,42 +22,96 @@ using tcp = net::ip::tcp;
 
 class Server;
 
-class WebSocketSession : public std::enable_shared_from_this<WebSocketSession> 
+// Сессия одинакова для всех транспортов: Stream - TlsStream, PlainStream
+// или LocalStream. Реализация в websocket_session.cpp, экземпляры для этих
+// типов создаются там же явно.
+template <class Stream>
+class WebSocketSession : public IFrameViewer, public std::enable_shared_from_this<WebSocketSession<Stream>> 
 {
 public:
     WebSocketSession(
-        net::ssl::stream<tcp::socket> stream,
+        Stream stream,
         std::shared_ptr<StreamController> controller, 
-        std::shared_ptr<Server> server
+        std::shared_ptr<Server> server,
+        AdmissionController::Slot connection = {}
     );
     ~WebSocketSession();
     
     void run(http::request<http::string_body> req);
     void send_frame(const std::string& frame);
+    // Кадр разделяется между всеми зрителями без копирования
+    void send_frame(std::shared_ptr<const std::string> frame, const FrameTrace& trace = {}) override;
     void close();
+    // Закрывает соединение после отправки уже поставленных в очередь сообщений
+    void close_after_drain();
 
-    uint64_t session_id() const { return session_id_; }
+    uint64_t session_id() const override { return session_id_; }
 
 private:
     net::awaitable<void> do_run(http::request<http::string_body> req);
     net::awaitable<void> do_read();
-    net::awaitable<void> handle_message(const std::string& message);
+    net::awaitable<void> handle_message(std::string_view message);
     net::awaitable<void> do_write();
+    void enqueue(std::shared_ptr<const std::string> payload, const FrameTrace& trace, MessageType type);
+    void handle_trace_echo();
+    void record_written(const FrameTrace& trace);
+    void remember_sent_trace(uint64_t sequence, std::chrono::steady_clock::time_point sent_at);
 
     size_t get_queue_size() const { return write_queue_.size(); }
     bool is_authenticated() const { return is_authenticated_; }
     bool is_controller() const { return is_controller_; }
     uint64_t generate_session_id();
     
-    websocket::stream<net::ssl::stream<tcp::socket>> ws_;
+    websocket::stream<Stream> ws_;
     std::shared_ptr<StreamController> controller_;
     std::shared_ptr<Server> server_;
     beast::flat_buffer buffer_;
-    std::deque<std::string> write_queue_;
+    // Поля разобранной команды указывают в buffer_ до следующего чтения
+    ControlMessage control_message_;
+    struct QueuedFrame {
+        std::shared_ptr<const std::string> payload;
+        FrameTrace trace;
+        MessageType type;
+    };
+
+    std::deque<QueuedFrame> write_queue_;
     bool is_writing_ = false;
+    // После close_after_drain новые сообщения не принимаются
+    bool close_pending_ = false;
+    // Кадры уходят двоичными сообщениями с заголовком трассировки
+    bool trace_enabled_ = false;
+    // Все сообщения уходят двоичными с заголовком FrameHeader (set_framing)
+    bool binary_framing_ = false;
+    // Время отправки последних кадров с трассировкой: RTT считается по нему,
+    // из ответа клиента берется только номер кадра
+    struct SentTrace {
+        uint64_t sequence = 0;
+        std::chrono::steady_clock::time_point sent_at;
+    };
+    std::array<SentTrace, 64> sent_traces_{};
+    size_t sent_traces_next_ = 0;
     bool is_authenticated_ = false;
     bool is_controller_ = false;
+    // Неудачные auth в этом соединении, считаются и для адресов без блокировки
+    unsigned auth_failures_ = 0;
     uint64_t session_id_;
+    std::string peer_address_;
+    AdmissionController::Slot connection_;
+    // Место в max_viewers, занимается при auth зрителя
+    AdmissionController::Slot viewer_;
+    net::steady_timer auth_timer_;
 
     static constexpr size_t MAX_QUEUE_SIZE = 10;
-};
\ No newline at end of file
+    // Столько клиент может не присылать успешный auth после подключения
+    static constexpr std::chrono::seconds AUTH_TIMEOUT{10};
+    // После стольких неудачных auth соединение закрывается
+    static constexpr unsigned MAX_AUTH_FAILURES_PER_CONNECTION = 3;
+    // Кадры дольше этого от захвата до отправки попадают в лог
+    static constexpr std::chrono::milliseconds OUTLIER_LATENCY{250};
+};
+
+extern template class WebSocketSession<TlsStream>;
+extern template class WebSocketSession<PlainStream>;
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+extern template class WebSocketSession<LocalStream>;
+#endif
\ No newline at end of file
@@ -0,0 +1,305 @@
+#include "admission_controller.hpp"
+#include "logger.hpp"
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+struct AdmissionMetrics 
+{
+    std::array<metrics::Gauge*, 3> active{
+        &metrics::Registry::get().gauge(
+            "ascii_admission_connections", "Admitted connections currently open"),
+        &metrics::Registry::get().gauge(
+            "ascii_admission_handshakes", "TLS handshakes currently in flight"),
+        &metrics::Registry::get().gauge(
+            "ascii_admission_viewers", "Authenticated viewers currently admitted")};
+    std::array<metrics::Counter*, 3> rejected{
+        &metrics::Registry::get().counter(
+            "ascii_admission_connections_rejected_total", "Connections refused because max_connections was reached"),
+        &metrics::Registry::get().counter(
+            "ascii_admission_handshakes_rejected_total", "Connections refused because max_handshakes were in flight"),
+        &metrics::Registry::get().counter(
+            "ascii_admission_viewers_rejected_total", "Viewers refused because max_viewers was reached")};
+    metrics::Counter& rate_limited = metrics::Registry::get().counter(
+        "ascii_admission_rate_limited_total", "Connections refused by the per-address rate limit");
+    metrics::Counter& per_ip_rejected = metrics::Registry::get().counter(
+        "ascii_admission_per_ip_rejected_total", "Connections refused because max_connections_per_ip were open");
+    metrics::Counter& peers_evicted = metrics::Registry::get().counter(
+        "ascii_admission_peers_evicted_total", "Tracked addresses forgotten while still limited to stay within the cap");
+    metrics::Counter& locked_out = metrics::Registry::get().counter(
+        "ascii_admission_locked_out_total", "Connections and auth attempts refused from locked out addresses");
+    metrics::Counter& auth_failures = metrics::Registry::get().counter(
+        "ascii_admission_auth_failures_total", "Failed auth attempts");
+    metrics::Counter& lockouts = metrics::Registry::get().counter(
+        "ascii_admission_lockouts_total", "Addresses locked out after repeated auth failures");
+};
+
+AdmissionMetrics& admission_metrics() 
+{
+    static AdmissionMetrics instance;
+    return instance;
+}
+
+} // namespace
+
+AdmissionController::Slot& AdmissionController::Slot::operator=(Slot&& other) noexcept 
+{
+    if (this != &other) 
+    {
+        release();
+        owner_ = std::move(other.owner_);
+        resource_ = other.resource_;
+        address_ = std::move(other.address_);
+    }
+    return *this;
+}
+
+void AdmissionController::Slot::release() 
+{
+    if (owner_) 
+    {
+        owner_->release(resource_, address_);
+        owner_.reset();
+        address_.clear();
+    }
+}
+
+AdmissionController::AdmissionController(AdmissionLimits limits)
+    : limits_(limits) 
+{
+}
+
+AdmissionController::Slot AdmissionController::admit_connection(const std::string& address, Clock::time_point now) 
+{
+    if (is_exempt(address)) 
+    {
+        return acquire(Resource::Connection, limits_.max_connections);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Peer& state = peer(address, now);
+
+    if (now < state.locked_until) 
+    {
+        admission_metrics().locked_out.inc();
+        return {};
+    }
+
+    // Корзина токенов: пополняется со скоростью connections_per_second
+    // до connection_burst, каждое соединение забирает один токен
+    if (limits_.connections_per_second > 0) 
+    {
+        const double elapsed = std::chrono::duration<double>(now - state.refilled_at).count();
+        state.tokens = std::min(limits_.connection_burst, state.tokens + elapsed * limits_.connections_per_second);
+        state.refilled_at = now;
+        if (state.tokens < 1) 
+        {
+            admission_metrics().rate_limited.inc();
+            LOG_WARN_RATE_LIMITED("Connection rate limit exceeded by {}", address);
+            return {};
+        }
+        state.tokens -= 1;
+    }
+
+    // Медленные соединения не тратят токены, поэтому один адрес мог бы
+    // занять все max_connections, открывая их в пределах скорости
+    if (limits_.max_connections_per_ip != 0 && state.connections >= limits_.max_connections_per_ip) 
+    {
+        admission_metrics().per_ip_rejected.inc();
+        LOG_WARN_RATE_LIMITED("Too many open connections from {}", address);
+        return {};
+    }
+
+    Slot slot = acquire(Resource::Connection, limits_.max_connections);
+    if (slot) 
+    {
+        ++state.connections;
+        slot.address_ = address;
+    }
+    return slot;
+}
+
+AdmissionController::Slot AdmissionController::begin_handshake() 
+{
+    return acquire(Resource::Handshake, limits_.max_handshakes);
+}
+
+AdmissionController::Slot AdmissionController::admit_viewer() 
+{
+    return acquire(Resource::Viewer, limits_.max_viewers);
+}
+
+bool AdmissionController::auth_allowed(const std::string& address, Clock::time_point now) 
+{
+    if (is_exempt(address)) 
+    {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = peers_.find(address);
+    if (it != peers_.end() && now < it->second.locked_until) 
+    {
+        admission_metrics().locked_out.inc();
+        return false;
+    }
+    return true;
+}
+
+void AdmissionController::record_auth_failure(const std::string& address, Clock::time_point now) 
+{
+    admission_metrics().auth_failures.inc();
+    if (is_exempt(address) || limits_.max_auth_failures == 0) 
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Peer& state = peer(address, now);
+
+    // Неудачи считаются в окне auth_lockout от первой из них
+    if (state.auth_failures == 0 || now - state.first_failure_at > limits_.auth_lockout) 
+    {
+        state.auth_failures = 0;
+        state.first_failure_at = now;
+    }
+
+    if (++state.auth_failures >= limits_.max_auth_failures) 
+    {
+        state.auth_failures = 0;
+        state.locked_until = now + limits_.auth_lockout;
+        admission_metrics().lockouts.inc();
+        Logger::get()->warn("Address {} locked out for {} s after repeated auth failures",
+                            address, limits_.auth_lockout.count());
+    }
+}
+
+void AdmissionController::record_auth_success(const std::string& address) 
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = peers_.find(address);
+    if (it != peers_.end()) 
+    {
+        it->second.auth_failures = 0;
+    }
+}
+
+size_t AdmissionController::tracked_peers() const 
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peers_.size();
+}
+
+bool AdmissionController::is_exempt(const std::string& address) 
+{
+    return address.empty() || address.rfind("127.", 0) == 0 || address == "::1" ||
+           address.rfind("::ffff:127.", 0) == 0;
+}
+
+AdmissionController::Slot AdmissionController::acquire(Resource resource, size_t limit) 
+{
+    const auto index = static_cast<size_t>(resource);
+    const size_t previous = counts_[index].fetch_add(1, std::memory_order_relaxed);
+    if (limit != 0 && previous >= limit) 
+    {
+        counts_[index].fetch_sub(1, std::memory_order_relaxed);
+        admission_metrics().rejected[index]->inc();
+        return {};
+    }
+
+    admission_metrics().active[index]->add(1);
+    return Slot(shared_from_this(), resource);
+}
+
+void AdmissionController::release(Resource resource, const std::string& address) 
+{
+    const auto index = static_cast<size_t>(resource);
+    counts_[index].fetch_sub(1, std::memory_order_relaxed);
+    admission_metrics().active[index]->add(-1);
+
+    if (!address.empty()) 
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Запись могла быть вытеснена, тогда счетчик уже забыт
+        const auto it = peers_.find(address);
+        if (it != peers_.end() && it->second.connections > 0) 
+        {
+            --it->second.connections;
+        }
+    }
+}
+
+AdmissionController::Peer& AdmissionController::peer(const std::string& address, Clock::time_point now) 
+{
+    auto it = peers_.find(address);
+    if (it != peers_.end()) 
+    {
+        return it->second;
+    }
+
+    if (peers_.size() >= MAX_TRACKED_PEERS) 
+    {
+        prune(now);
+    }
+    // Пока корзины пополняются, prune может ничего не освободить,
+    // а память под адреса должна оставаться ограниченной
+    if (peers_.size() >= MAX_TRACKED_PEERS) 
+    {
+        evict(now);
+    }
+
+    Peer fresh;
+    fresh.tokens = limits_.connection_burst;
+    fresh.refilled_at = now;
+    return peers_.emplace(address, fresh).first->second;
+}
+
+void AdmissionController::prune(Clock::time_point now) 
+{
+    // Адрес можно забыть, если его корзина уже полна, а неудачных auth
+    // и блокировки нет: новая запись для него будет такой же
+    const auto refill_time = std::chrono::duration<double>(
+        limits_.connections_per_second > 0 ? limits_.connection_burst / limits_.connections_per_second : 0);
+
+    for (auto it = peers_.begin(); it != peers_.end(); ) 
+    {
+        const Peer& state = it->second;
+        const bool idle = now - state.refilled_at >= refill_time && state.connections == 0 &&
+                          state.auth_failures == 0 && now >= state.locked_until;
+        it = idle ? peers_.erase(it) : std::next(it);
+    }
+}
+
+void AdmissionController::evict(Clock::time_point now) 
+{
+    // Заблокированные адреса и адреса с открытыми соединениями забываются
+    // в последнюю очередь, среди равных - дольше всех не подключавшиеся.
+    // Освобождается сразу часть таблицы, чтобы не перебирать ее на каждый
+    // новый адрес
+    using Entry = decltype(peers_)::iterator;
+    const auto rank = [now](Entry it) 
+    {
+        const Peer& state = it->second;
+        return std::make_tuple(now < state.locked_until, state.connections != 0, state.refilled_at);
+    };
+
+    std::vector<Entry> entries;
+    entries.reserve(peers_.size());
+    for (auto it = peers_.begin(); it != peers_.end(); ++it) 
+    {
+        entries.push_back(it);
+    }
+
+    const size_t count = std::min(entries.size(), EVICT_BATCH);
+    std::nth_element(entries.begin(), entries.begin() + count, entries.end(),
+                     [&rank](Entry a, Entry b) { return rank(a) < rank(b); });
+    for (size_t i = 0; i < count; ++i) 
+    {
+        peers_.erase(entries[i]);
+    }
+    admission_metrics().peers_evicted.inc(count);
+}
\ No newline at end of file
@@ -1,82 +1,387 @@
 #include "ascii_converter.hpp"
 #include "logger.hpp"
+#include "metrics.hpp"
 
 #include <opencv2/opencv.hpp>
+#include <cmath>
+#include <cstdlib>
 
-AsciiConverter::AsciiConverter() {}
+namespace {
 
-cv::Mat AsciiConverter::resize_frame(const cv::Mat& frame, int width, int height) 
+using Clock = std::chrono::steady_clock;
+
+std::chrono::microseconds elapsed_us(Clock::time_point from, Clock::time_point to) 
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(to - from);
+}
+
+struct ConverterMetrics 
+{
+    metrics::Histogram& resize = metrics::Registry::get().latency(
+        "ascii_convert_resize_seconds", "Conversion stage: grayscale and resize");
+    metrics::Histogram& tone = metrics::Registry::get().latency(
+        "ascii_convert_tone_seconds", "Conversion stage: tone mapping");
+    metrics::Histogram& dither = metrics::Registry::get().latency(
+        "ascii_convert_dither_seconds", "Conversion stage: dithering");
+    metrics::Histogram& map = metrics::Registry::get().latency(
+        "ascii_convert_map_seconds", "Conversion stage: brightness to character mapping");
+    metrics::Histogram& edges = metrics::Registry::get().latency(
+        "ascii_convert_edges_seconds", "Conversion stage: edge overlay");
+    metrics::Counter& over_budget = metrics::Registry::get().counter(
+        "ascii_convert_over_budget_total", "Frames whose conversion exceeded the frame budget");
+};
+
+ConverterMetrics& converter_metrics() 
+{
+    static ConverterMetrics instance;
+    return instance;
+}
+
+// Матрица Байера 4x4 для упорядоченного дизеринга
+const int BAYER_4X4[4][4] = {
+    { 0,  8,  2, 10},
+    {12,  4, 14,  6},
+    { 3, 11,  1,  9},
+    {15,  7, 13,  5}
+};
+
+using RowKernel = void (*)(const cv::Mat& processed, const char* lut, int begin, int end, char* out);
+
+// Ширина известна при компиляции: у внутреннего цикла постоянное число
+// итераций, компилятор его разворачивает
+template <int Cols>
+void map_rows_fixed(const cv::Mat& processed, const char* lut, int begin, int end, char* out) 
+{
+    for (int y = begin; y < end; ++y) 
+    {
+        const uchar* row_ptr = processed.ptr<uchar>(y);
+        
+        for (int x = 0; x < Cols; ++x) 
+        {
+            out[x] = lut[row_ptr[x]];
+        }
+        
+        out[Cols] = '\n';
+        out += Cols + 1;
+    }
+}
+
+void map_rows_generic(const cv::Mat& processed, const char* lut, int begin, int end, char* out) 
+{
+    const int cols = processed.cols;
+    
+    // Быстрая конвертация с использованием указателей
+    for (int y = begin; y < end; ++y) 
+    {
+        const uchar* row_ptr = processed.ptr<uchar>(y);
+        
+        for (int x = 0; x < cols; ++x) 
+        {
+            *out++ = lut[row_ptr[x]];
+        }
+        
+        *out++ = '\n';
+    }
+}
+
+// Специализации для ширин из списка разрешений в интерфейсе
+RowKernel select_kernel(int cols) 
+{
+    switch (cols) 
+    {
+        case 80: return map_rows_fixed<80>;
+        case 120: return map_rows_fixed<120>;
+        case 160: return map_rows_fixed<160>;
+        case 320: return map_rows_fixed<320>;
+        default: return map_rows_generic;
+    }
+}
+
+} // namespace
+
+AsciiConverter::AsciiConverter() 
 {
-    cv::Mat resized;
-    cv::resize(frame, resized, cv::Size(width, height));
-    return resized;
+    build_lut();
 }
 
-cv::Mat AsciiConverter::convert_to_grayscale(const cv::Mat& frame) 
+const cv::Mat& AsciiConverter::resize_frame(const cv::Mat& frame, int width, int height) 
 {
-    cv::Mat gray;
-    cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
-    return gray;
+    if (frame.cols == width && frame.rows == height) 
+    {
+        return frame;
+    }
+
+    cv::resize(frame, resized_, cv::Size(width, height));
+    return resized_;
+}
+
+const cv::Mat& AsciiConverter::convert_to_grayscale(const cv::Mat& frame) 
+{
+    // Источник может сразу отдавать яркость (например, Y-плоскость с камеры)
+    if (frame.channels() == 1) 
+    {
+        return frame;
+    }
+
+    cv::cvtColor(frame, gray_, cv::COLOR_BGR2GRAY);
+    return gray_;
 }
 
 void AsciiConverter::set_ascii_chars(const std::string& chars) 
 {
     ascii_chars_ = chars;
+    build_lut();
 }
 
-std::string AsciiConverter::convert(const cv::Mat& frame, int output_width, int output_height) 
+void AsciiConverter::build_lut() 
+{
+    if (ascii_chars_.empty()) 
+    {
+        return;
+    }
+    
+    const size_t num_chars = ascii_chars_.size();
+    const double char_step = num_chars > 1 ? 255.0 / (num_chars - 1) : 256.0;
+    for (int i = 0; i < 256; ++i) 
+    {
+        int index = static_cast<int>(i / char_step + 0.5);  // Округление
+        lut_[i] = ascii_chars_[std::clamp(index, 0, static_cast<int>(num_chars - 1))];
+    }
+}
+
+void AsciiConverter::convert(const cv::Mat& frame, int output_width, int output_height, std::string& output) 
 {
     auto logger = Logger::get();
 
     if (frame.empty()) 
     {
-        logger->warn("Attempted to convert empty frame");
-        return "";
+        LOG_WARN_RATE_LIMITED("Attempted to convert empty frame");
+        output.clear();
+        return;
     }
 
     if (ascii_chars_.empty()) 
     {
         logger->error("ASCII characters not set");
-        return "CONFIG ERROR";
+        output = "CONFIG ERROR";
+        return;
     }
 
-    logger->debug("Converting frame to ASCII: {}x{}", output_width, output_height);
+    SPDLOG_LOGGER_DEBUG(logger, "Converting frame to ASCII: {}x{}", output_width, output_height);
     
     // Обработка кадра
-    cv::Mat processed = convert_to_grayscale(frame);
-    processed = resize_frame(processed, output_width, output_height);
+    const auto started = Clock::now();
+    const cv::Mat& luma = resize_frame(convert_to_grayscale(frame), output_width, output_height);
+    const auto resized = Clock::now();
+    const cv::Mat& toned = apply_tone(luma);
+    const auto tone_mapped = Clock::now();
+    const cv::Mat& processed = apply_dither(toned);
+    const auto dithered = Clock::now();
     
-    // Создаем lookup table (LUT)
-    const size_t num_chars = ascii_chars_.size();
-    const double char_step = 255.0 / (num_chars - 1);
-    std::array<char, 256> lut;
-    for (int i = 0; i < 256; ++i) 
-    {
-        int index = static_cast<int>(i / char_step + 0.5);  // Округление
-        lut[i] = ascii_chars_[std::clamp(index, 0, static_cast<int>(num_chars - 1))];
-    }
-
     // Рассчитываем необходимый размер буфера
     const size_t rows = processed.rows;
     const size_t cols = processed.cols;
     const size_t buffer_size = rows * (cols + 1);  // +1 для '\n' в каждой строке
     
-    // Резервируем память (+1 для null-terminator)
-    std::string ascii_frame;
-    ascii_frame.reserve(buffer_size + 1);
+    // Размер строки меняется только при смене разрешения,
+    // в остальных случаях resize() не трогает память
+    output.resize(buffer_size);
+    char* out = output.data();
+    const char* lut = lut_.data();
+    const RowKernel map_rows = select_kernel(static_cast<int>(cols));
     
-    // Быстрая конвертация с использованием указателей
-    for (int y = 0; y < rows; ++y) 
+    // Большие кадры делятся на полосы строк. Смещение каждой полосы
+    // в выходном буфере известно заранее, поэтому полосы пишут без синхронизации.
+    if (rows * cols >= parallel_threshold_ && rows >= 2 * BAND_ROWS) 
     {
-        const uchar* row_ptr = processed.ptr<uchar>(y);
+        const int bands = static_cast<int>(rows / BAND_ROWS);
+        cv::parallel_for_(cv::Range(0, static_cast<int>(rows)), 
+            [&](const cv::Range& range) {
+                map_rows(processed, lut, range.start, range.end, out + range.start * (cols + 1));
+            }, 
+            bands);
+    } 
+    else 
+    {
+        map_rows(processed, lut, 0, static_cast<int>(rows), out);
+    }
+    const auto mapped = Clock::now();
+    
+    if (options_.edges) 
+    {
+        draw_edges(toned, output);
+    }
+    const auto finished = Clock::now();
+    
+    timings_.resize = elapsed_us(started, resized);
+    timings_.tone = elapsed_us(resized, tone_mapped);
+    timings_.dither = elapsed_us(tone_mapped, dithered);
+    timings_.map = elapsed_us(dithered, mapped);
+    timings_.edges = elapsed_us(mapped, finished);
+    timings_.total = elapsed_us(started, finished);
+    
+    auto& stages = converter_metrics();
+    stages.resize.observe(timings_.resize);
+    stages.tone.observe(timings_.tone);
+    stages.dither.observe(timings_.dither);
+    stages.map.observe(timings_.map);
+    stages.edges.observe(timings_.edges);
+    
+    // Предупреждение нужно и в Release: по нему видно, какая стадия не укладывается
+    if (timings_.total > FRAME_BUDGET) 
+    {
+        stages.over_budget.inc();
+        LOG_WARN_RATE_LIMITED("ASCII conversion took {} us (resize {}, tone {}, dither {}, map {}, edges {})", 
+                              timings_.total.count(), timings_.resize.count(), timings_.tone.count(), 
+                              timings_.dither.count(), timings_.map.count(), timings_.edges.count());
+    }
+}
+
+void AsciiConverter::set_render_options(const RenderOptions& options) 
+{
+    options_ = options;
+    
+    if (options_.tone == RenderOptions::Tone::Gamma) 
+    {
+        gamma_lut_.create(1, 256, CV_8U);
+        uchar* table = gamma_lut_.ptr<uchar>();
+        const double exponent = 1.0 / std::max(options_.gamma, 0.01);
+        for (int i = 0; i < 256; ++i) 
+        {
+            table[i] = cv::saturate_cast<uchar>(std::lround(255.0 * std::pow(i / 255.0, exponent)));
+        }
+    }
+}
+
+StageTimings AsciiConverter::last_timings() const 
+{
+    return timings_;
+}
+
+const cv::Mat& AsciiConverter::apply_tone(const cv::Mat& luma) 
+{
+    switch (options_.tone) 
+    {
+        case RenderOptions::Tone::Gamma:
+            cv::LUT(luma, gamma_lut_, toned_);
+            return toned_;
+        case RenderOptions::Tone::Equalize:
+            cv::equalizeHist(luma, toned_);
+            return toned_;
+        default:
+            return luma;
+    }
+}
+
+const cv::Mat& AsciiConverter::apply_dither(const cv::Mat& luma) 
+{
+    const int levels = static_cast<int>(ascii_chars_.size());
+    if (options_.dither == RenderOptions::Dither::None || levels < 2) 
+    {
+        return luma;
+    }
+    
+    // Шаг между соседними символами в единицах яркости, как в build_lut()
+    const double step = 255.0 / (levels - 1);
+    dithered_.create(luma.rows, luma.cols, CV_8UC1);
+    
+    if (options_.dither == RenderOptions::Dither::Ordered) 
+    {
+        // Смещение в пределах половины шага: после округления в LUT
+        // соседние клетки получают соседние символы пропорционально яркости
+        int offsets[4][4];
+        for (int i = 0; i < 4; ++i) 
+        {
+            for (int j = 0; j < 4; ++j) 
+            {
+                offsets[i][j] = static_cast<int>(std::lround(((BAYER_4X4[i][j] + 0.5) / 16.0 - 0.5) * step));
+            }
+        }
         
-        for (int x = 0; x < cols; ++x) 
+        for (int y = 0; y < luma.rows; ++y) 
         {
-            ascii_frame += lut[row_ptr[x]];
+            const uchar* src = luma.ptr<uchar>(y);
+            uchar* dst = dithered_.ptr<uchar>(y);
+            const int* offset = offsets[y & 3];
+            
+            for (int x = 0; x < luma.cols; ++x) 
+            {
+                dst[x] = cv::saturate_cast<uchar>(src[x] + offset[x & 3]);
+            }
+        }
+        return dithered_;
+    }
+    
+    // Флойд-Стейнберг: ошибка квантования в 1/16 раскладывается на соседей
+    // справа и снизу. Две строки ошибок с полями по краям.
+    const int stride = luma.cols + 2;
+    diffusion_error_.assign(2 * stride, 0);
+    int* current = diffusion_error_.data() + 1;
+    int* next = current + stride;
+    
+    for (int y = 0; y < luma.rows; ++y) 
+    {
+        const uchar* src = luma.ptr<uchar>(y);
+        uchar* dst = dithered_.ptr<uchar>(y);
+        std::fill(next - 1, next + luma.cols + 1, 0);
+        
+        for (int x = 0; x < luma.cols; ++x) 
+        {
+            const int value = std::clamp(src[x] + current[x] / 16, 0, 255);
+            const int quantized = static_cast<int>(std::lround(std::lround(value / step) * step));
+            const int error = value - quantized;
+            dst[x] = static_cast<uchar>(quantized);
+            
+            current[x + 1] += error * 7;
+            next[x - 1] += error * 3;
+            next[x] += error * 5;
+            next[x + 1] += error;
         }
         
-        ascii_frame += '\n';
+        std::swap(current, next);
     }
+    return dithered_;
+}
+
+void AsciiConverter::draw_edges(const cv::Mat& luma, std::string& output) 
+{
+    cv::Sobel(luma, grad_x_, CV_16S, 1, 0, 3);
+    cv::Sobel(luma, grad_y_, CV_16S, 0, 1, 3);
     
-    return ascii_frame;
+    const int threshold = options_.edge_threshold;
+    for (int y = 0; y < luma.rows; ++y) 
+    {
+        const short* gx = grad_x_.ptr<short>(y);
+        const short* gy = grad_y_.ptr<short>(y);
+        char* out = output.data() + static_cast<size_t>(y) * (luma.cols + 1);
+        
+        for (int x = 0; x < luma.cols; ++x) 
+        {
+            const int ax = std::abs(gx[x]);
+            const int ay = std::abs(gy[x]);
+            if (ax + ay < threshold) 
+            {
+                continue;
+            }
+            
+            // Граница перпендикулярна градиенту яркости
+            if (ax > 2 * ay) 
+            {
+                out[x] = '|';
+            } 
+            else if (ay > 2 * ax) 
+            {
+                out[x] = '-';
+            } 
+            else 
+            {
+                out[x] = (gx[x] > 0) == (gy[x] > 0) ? '/' : '\\';
+            }
+        }
+    }
+}
+
+void AsciiConverter::set_parallel_threshold(size_t cells) 
+{
+    parallel_threshold_ = cells;
 }
\ No newline at end of file
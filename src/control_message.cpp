@@ -0,0 +1,413 @@
+#include "control_message.hpp"
+
+#include <charconv>
+
+namespace {
+
+struct CommandName 
+{
+    std::string_view name;
+    ControlCommand command;
+};
+
+constexpr std::array<CommandName, 17> COMMANDS{{
+    {"auth", ControlCommand::Auth},
+    {"config", ControlCommand::Config},
+    {"stop", ControlCommand::Stop},
+    {"playback_start", ControlCommand::PlaybackStart},
+    {"playback_pause", ControlCommand::PlaybackPause},
+    {"playback_resume", ControlCommand::PlaybackResume},
+    {"playback_stop", ControlCommand::PlaybackStop},
+    {"playback_speed", ControlCommand::PlaybackSpeed},
+    {"playback_next_activity", ControlCommand::PlaybackNextActivity},
+    {"playback_prev_activity", ControlCommand::PlaybackPrevActivity},
+    {"record_start", ControlCommand::RecordStart},
+    {"record_stop", ControlCommand::RecordStop},
+    {"auto_record_start", ControlCommand::AutoRecordStart},
+    {"auto_record_stop", ControlCommand::AutoRecordStop},
+    {"set_render_options", ControlCommand::SetRenderOptions},
+    {"set_trace", ControlCommand::SetTrace},
+    {"set_framing", ControlCommand::SetFraming}
+}};
+
+int hex_digit(char c) 
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+void append_utf8(std::string& out, uint32_t code_point) 
+{
+    if (code_point < 0x80) 
+    {
+        out += static_cast<char>(code_point);
+    }
+    else if (code_point < 0x800) 
+    {
+        out += static_cast<char>(0xC0 | (code_point >> 6));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+    else if (code_point < 0x10000) 
+    {
+        out += static_cast<char>(0xE0 | (code_point >> 12));
+        out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+    else 
+    {
+        out += static_cast<char>(0xF0 | (code_point >> 18));
+        out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+}
+
+// Позиция в разбираемом тексте
+class Cursor 
+{
+public:
+    Cursor(std::string_view text, std::string& unescaped)
+        : begin_(text.data()), pos_(text.data()), end_(text.data() + text.size()), unescaped_(unescaped) 
+    {
+    }
+
+    char peek() 
+    {
+        skip_whitespace();
+        return pos_ < end_ ? *pos_ : '\0';
+    }
+
+    bool consume(char c) 
+    {
+        if (peek() != c) 
+        {
+            return false;
+        }
+        ++pos_;
+        return true;
+    }
+
+    bool at_end() 
+    {
+        skip_whitespace();
+        return pos_ == end_;
+    }
+
+    bool literal(std::string_view word) 
+    {
+        if (std::string_view(pos_, end_ - pos_).substr(0, word.size()) != word) 
+        {
+            return false;
+        }
+        pos_ += word.size();
+        return true;
+    }
+
+    // Проверяется только набор символов, сам формат числа - при чтении значения
+    bool number(std::string_view& out) 
+    {
+        const char* start = pos_;
+        bool digits = false;
+        while (pos_ < end_) 
+        {
+            const char c = *pos_;
+            if (c >= '0' && c <= '9') digits = true;
+            else if (c != '-' && c != '+' && c != '.' && c != 'e' && c != 'E') break;
+            ++pos_;
+        }
+        out = std::string_view(start, pos_ - start);
+        return digits;
+    }
+
+    bool string(std::string_view& out) 
+    {
+        if (!consume('"')) 
+        {
+            return false;
+        }
+
+        // Обычный случай - строка без escape-последовательностей
+        const char* start = pos_;
+        while (pos_ < end_ && *pos_ != '"' && *pos_ != '\\') 
+        {
+            if (static_cast<uint8_t>(*pos_) < 0x20) 
+            {
+                return false;
+            }
+            ++pos_;
+        }
+        if (pos_ == end_) 
+        {
+            return false;
+        }
+        if (*pos_ == '"') 
+        {
+            out = std::string_view(start, pos_++ - start);
+            return true;
+        }
+
+        // Раскодированная строка не длиннее исходной, поэтому буфер
+        // резервируется под весь текст и ранее выданные string_view
+        // не инвалидируются
+        if (unescaped_.capacity() < static_cast<size_t>(end_ - begin_)) 
+        {
+            unescaped_.reserve(end_ - begin_);
+        }
+        const size_t offset = unescaped_.size();
+        unescaped_.append(start, pos_);
+
+        while (pos_ < end_ && *pos_ != '"') 
+        {
+            const char c = *pos_++;
+            if (static_cast<uint8_t>(c) < 0x20) 
+            {
+                return false;
+            }
+            if (c != '\\') 
+            {
+                unescaped_ += c;
+                continue;
+            }
+            if (pos_ == end_ || !unescape(*pos_++)) 
+            {
+                return false;
+            }
+        }
+        if (pos_ == end_) 
+        {
+            return false;
+        }
+
+        ++pos_;
+        out = std::string_view(unescaped_).substr(offset);
+        return true;
+    }
+
+private:
+    void skip_whitespace() 
+    {
+        while (pos_ < end_ && (*pos_ == ' ' || *pos_ == '\t' || *pos_ == '\n' || *pos_ == '\r')) 
+        {
+            ++pos_;
+        }
+    }
+
+    bool unescape(char c) 
+    {
+        switch (c) 
+        {
+            case '"': unescaped_ += '"'; return true;
+            case '\\': unescaped_ += '\\'; return true;
+            case '/': unescaped_ += '/'; return true;
+            case 'b': unescaped_ += '\b'; return true;
+            case 'f': unescaped_ += '\f'; return true;
+            case 'n': unescaped_ += '\n'; return true;
+            case 'r': unescaped_ += '\r'; return true;
+            case 't': unescaped_ += '\t'; return true;
+            case 'u': break;
+            default: return false;
+        }
+
+        uint32_t code_point = 0;
+        if (!hex4(code_point) || (code_point >= 0xDC00 && code_point <= 0xDFFF)) 
+        {
+            return false;
+        }
+        if (code_point >= 0xD800 && code_point <= 0xDBFF) 
+        {
+            // Символ вне BMP передается суррогатной парой
+            uint32_t low = 0;
+            if (!literal("\\u") || !hex4(low) || low < 0xDC00 || low > 0xDFFF) 
+            {
+                return false;
+            }
+            code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+        }
+        append_utf8(unescaped_, code_point);
+        return true;
+    }
+
+    bool hex4(uint32_t& value) 
+    {
+        if (end_ - pos_ < 4) 
+        {
+            return false;
+        }
+        for (int i = 0; i < 4; ++i) 
+        {
+            const int digit = hex_digit(*pos_++);
+            if (digit < 0) 
+            {
+                return false;
+            }
+            value = (value << 4) | digit;
+        }
+        return true;
+    }
+
+    const char* begin_;
+    const char* pos_;
+    const char* end_;
+    std::string& unescaped_;
+};
+
+} // namespace
+
+bool ControlMessage::parse(std::string_view text) 
+{
+    field_count_ = 0;
+    command_ = ControlCommand::Unknown;
+    type_ = {};
+    unescaped_.clear();
+
+    Cursor in(text, unescaped_);
+    if (!in.consume('{')) 
+    {
+        return false;
+    }
+
+    if (!in.consume('}')) 
+    {
+        do 
+        {
+            if (field_count_ == MAX_FIELDS) 
+            {
+                return false;
+            }
+
+            Field& field = fields_[field_count_];
+            if (!in.string(field.key) || !in.consume(':')) 
+            {
+                return false;
+            }
+
+            bool valid = false;
+            switch (in.peek()) 
+            {
+                case '"':
+                    field.kind = Kind::String;
+                    valid = in.string(field.value);
+                    break;
+                case 't':
+                    field.kind = Kind::True;
+                    valid = in.literal("true");
+                    break;
+                case 'f':
+                    field.kind = Kind::False;
+                    valid = in.literal("false");
+                    break;
+                case 'n':
+                    field.kind = Kind::Null;
+                    valid = in.literal("null");
+                    break;
+                case '-':
+                case '0': case '1': case '2': case '3': case '4':
+                case '5': case '6': case '7': case '8': case '9':
+                    field.kind = Kind::Number;
+                    valid = in.number(field.value);
+                    break;
+                default:
+                    // Вложенные объекты и массивы командам не нужны
+                    break;
+            }
+            if (!valid) 
+            {
+                return false;
+            }
+            ++field_count_;
+        }
+        while (in.consume(','));
+
+        if (!in.consume('}')) 
+        {
+            return false;
+        }
+    }
+
+    if (!in.at_end()) 
+    {
+        return false;
+    }
+
+    type_ = string("type");
+    command_ = parse_command(type_);
+    return true;
+}
+
+ControlCommand ControlMessage::parse_command(std::string_view type) 
+{
+    for (const auto& entry : COMMANDS) 
+    {
+        if (entry.name == type) 
+        {
+            return entry.command;
+        }
+    }
+    return ControlCommand::Unknown;
+}
+
+const ControlMessage::Field* ControlMessage::find(std::string_view key) const 
+{
+    // Как и в nlohmann::json, из повторяющихся ключей действует последний
+    for (size_t i = field_count_; i > 0; --i) 
+    {
+        if (fields_[i - 1].key == key) 
+        {
+            return &fields_[i - 1];
+        }
+    }
+    return nullptr;
+}
+
+std::string_view ControlMessage::string(std::string_view key, std::string_view fallback) const 
+{
+    const Field* field = find(key);
+    return field && field->kind == Kind::String ? field->value : fallback;
+}
+
+int ControlMessage::integer(std::string_view key, int fallback) const 
+{
+    const Field* field = find(key);
+    if (!field || field->kind != Kind::Number) 
+    {
+        return fallback;
+    }
+
+    const char* end = field->value.data() + field->value.size();
+    int value = 0;
+    const auto [ptr, ec] = std::from_chars(field->value.data(), end, value);
+    if (ec == std::errc() && ptr == end) 
+    {
+        return value;
+    }
+
+    // Дробное число или экспонента: отбрасываем дробную часть
+    const double real = number(key, fallback);
+    return real >= INT32_MIN && real <= INT32_MAX ? static_cast<int>(real) : fallback;
+}
+
+double ControlMessage::number(std::string_view key, double fallback) const 
+{
+    const Field* field = find(key);
+    if (!field || field->kind != Kind::Number) 
+    {
+        return fallback;
+    }
+
+    const char* end = field->value.data() + field->value.size();
+    double value = 0;
+    const auto [ptr, ec] = std::from_chars(field->value.data(), end, value);
+    return ec == std::errc() && ptr == end ? value : fallback;
+}
+
+bool ControlMessage::boolean(std::string_view key, bool fallback) const 
+{
+    const Field* field = find(key);
+    if (!field || (field->kind != Kind::True && field->kind != Kind::False)) 
+    {
+        return fallback;
+    }
+    return field->kind == Kind::True;
+}
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "file_video_source.hpp"
+#include "logger.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+FileVideoSource::FileVideoSource(std::string path, double fps, size_t ring_size)
+    : path_(std::move(path)),
+      fps_(fps),
+      ring_(std::max<size_t>(ring_size, 1)) 
+{
+    auto logger = Logger::get();
+    logger->debug("FileVideoSource created for {}", path_);
+}
+
+FileVideoSource::~FileVideoSource() 
+{
+    close();
+}
+
+void FileVideoSource::open(int index) 
+{
+    auto logger = Logger::get();
+
+    close();
+
+    if (!cap_.open(path_)) 
+    {
+        logger->error("Could not open video file {}", path_);
+        throw std::runtime_error("Could not open video source");
+    }
+
+    double fps = fps_;
+    if (fps == 0) 
+    {
+        fps = cap_.get(cv::CAP_PROP_FPS);
+        if (fps <= 0) 
+        {
+            fps = FALLBACK_FPS;
+        }
+    }
+    pacer_.set_fps(fps);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        head_ = 0;
+        count_ = 0;
+        running_ = true;
+    }
+    last_frame_.release();
+    opened_ = true;
+    decoder_ = std::thread([this] { decode_loop(); });
+
+    logger->info("Video file {} opened ({} fps)", path_, fps);
+}
+
+void FileVideoSource::close() 
+{ 
+    opened_ = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    not_full_.notify_all();
+    not_empty_.notify_all();
+
+    if (decoder_.joinable()) 
+    {
+        decoder_.join();
+    }
+
+    if (cap_.isOpened()) 
+    {
+        auto logger = Logger::get();
+        logger->info("Releasing video file {}", path_);
+        cap_.release();
+    }
+}
+
+bool FileVideoSource::is_available() const 
+{
+    // cap_ переоткрывается потоком декодирования в конце файла,
+    // поэтому состояние читается из отдельного флага
+    return opened_;
+}
+
+void FileVideoSource::set_resolution(int width, int height) 
+{
+    // Уже декодированные кадры остаются в старом размере,
+    // конвертер все равно масштабирует их сам
+    width_ = width;
+    height_ = height;
+}
+
+std::chrono::steady_clock::time_point FileVideoSource::last_capture_time() const 
+{
+    return last_capture_time_;
+}
+
+void FileVideoSource::capture_frame(cv::Mat& frame) 
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!running_) 
+    {
+        lock.unlock();
+        frame.release();
+
+        LOG_WARN_RATE_LIMITED("Captured empty frame from video source");
+        return;
+    }
+
+    if (count_ > 0) 
+    {
+        // Заголовок, а не копия: слот и выданный кадр делят одни данные
+        last_frame_ = ring_[head_];
+        head_ = (head_ + 1) % ring_.size();
+        --count_;
+        lock.unlock();
+        not_full_.notify_one();
+
+        last_capture_time_ = std::chrono::steady_clock::now();
+    } 
+    else 
+    {
+        lock.unlock();
+    }
+
+    // Повтор кадра - тоже только заголовок. До первого декодированного
+    // кадра frame пустой.
+    frame = last_frame_;
+}
+
+void FileVideoSource::decode_loop() 
+{
+    auto logger = Logger::get();
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (running_) 
+    {
+        not_full_.wait(lock, [this] { return !running_ || count_ < ring_.size(); });
+        if (!running_) 
+        {
+            break;
+        }
+
+        // Слот за хвостом не виден читателю, пока count_ не увеличен
+        cv::Mat& slot = ring_[(head_ + count_) % ring_.size()];
+        lock.unlock();
+        // Данные слота еще у потребителя (выданный кадр или last_frame_):
+        // слот отпускает их и получает новый буфер. Новых ссылок на
+        // прочитанный слот не появляется, поэтому проверка без гонки
+        if (slot.u && std::atomic_ref<int>(slot.u->refcount).load() > 1) 
+        {
+            slot.release();
+        }
+        bool decoded = decode_next(slot);
+        // Темп выдерживается здесь, а не в capture_frame, чтобы не спать
+        // в потоке ввода-вывода сервера
+        if (decoded) 
+        {
+            pacer_.wait();
+        }
+        lock.lock();
+
+        if (!decoded) 
+        {
+            logger->error("Failed to decode frames from {}", path_);
+            running_ = false;
+            opened_ = false;
+            not_empty_.notify_all();
+            break;
+        }
+
+        ++count_;
+        not_empty_.notify_one();
+    }
+}
+
+bool FileVideoSource::decode_next(cv::Mat& target) 
+{
+    if (!cap_.read(decoded_)) 
+    {
+        // Конец файла: переоткрываем, перемотка поддерживается не всеми бэкендами
+        cap_.release();
+        if (!cap_.open(path_) || !cap_.read(decoded_)) 
+        {
+            return false;
+        }
+    }
+
+    cv::resize(decoded_, target, cv::Size(width_, height_), 0, 0, cv::INTER_AREA);
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#include "frame_activity.hpp"
+
+int frame_activity(const std::string& previous, const std::string& current) 
+{
+    if (previous.size() != current.size() || current.empty()) 
+    {
+        return 1000;
+    }
+    
+    // Простой цикл без ветвлений, компилятор его векторизует
+    const char* a = previous.data();
+    const char* b = current.data();
+    const size_t size = current.size();
+    size_t changed = 0;
+    for (size_t i = 0; i < size; ++i) 
+    {
+        changed += a[i] != b[i];
+    }
+    
+    return static_cast<int>(changed * 1000 / size);
+}
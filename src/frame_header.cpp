@@ -0,0 +1,121 @@
+#include "frame_header.hpp"
+#include "byte_order.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+struct FrameShape 
+{
+    PayloadEncoding encoding{PayloadEncoding::Ascii};
+    uint16_t width{0};
+    uint16_t height{0};
+};
+
+uint16_t clamp_u16(size_t value) 
+{
+    return static_cast<uint16_t>(std::min<size_t>(value, std::numeric_limits<uint16_t>::max()));
+}
+
+FrameShape frame_shape(std::string_view payload) 
+{
+    FrameShape shape;
+    const size_t line = payload.find('\n');
+    if (line == std::string_view::npos || line == 0) 
+    {
+        return shape;
+    }
+
+    // Ширина - число символов, а не байт: продолжения UTF-8 (10xxxxxx) не считаются
+    const std::string_view first = payload.substr(0, line);
+    size_t width = 0;
+    bool ascii = true;
+    for (const char c : first) 
+    {
+        const auto byte = static_cast<uint8_t>(c);
+        ascii = ascii && byte < 0x80;
+        width += (byte & 0xC0) != 0x80;
+    }
+
+    shape.encoding = ascii ? PayloadEncoding::Ascii : PayloadEncoding::Utf8;
+    shape.width = clamp_u16(width);
+    shape.height = clamp_u16(payload.size() / (line + 1));
+    return shape;
+}
+
+} // namespace
+
+FrameHeader encode_frame_header(MessageType type, std::string_view payload, const FrameTrace& trace,
+                                bool traced, FrameTrace::Clock::time_point sent_at) 
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    FrameHeader header{};
+    header[0] = FRAME_HEADER_VERSION;
+    header[1] = static_cast<uint8_t>(type);
+
+    if (type == MessageType::Frame) 
+    {
+        const FrameShape shape = frame_shape(payload);
+        header[2] = static_cast<uint8_t>(shape.encoding);
+        put_le<uint16_t>(header.data() + 4, shape.width);
+        put_le<uint16_t>(header.data() + 6, shape.height);
+    }
+
+    if (trace.valid()) 
+    {
+        const auto sent_us = duration_cast<microseconds>(sent_at.time_since_epoch()).count();
+        const auto pipeline_us = std::clamp<long long>(
+            duration_cast<microseconds>(sent_at - trace.captured_at).count(), 0, UINT32_MAX);
+
+        header[3] = traced ? FRAME_FLAG_TRACED : 0;
+        put_le<uint64_t>(header.data() + 8, trace.sequence);
+        put_le<uint64_t>(header.data() + 16, static_cast<uint64_t>(sent_us));
+        put_le<uint32_t>(header.data() + 24, static_cast<uint32_t>(pipeline_us));
+    }
+
+    put_le<uint32_t>(header.data() + 28, static_cast<uint32_t>(payload.size()));
+    return header;
+}
+
+bool decode_frame_header(const void* data, size_t size, FrameHeaderFields& fields) 
+{
+    if (size < FRAME_HEADER_SIZE) 
+    {
+        return false;
+    }
+
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    if (bytes[0] != FRAME_HEADER_VERSION) 
+    {
+        return false;
+    }
+
+    fields.type = static_cast<MessageType>(bytes[1]);
+    fields.encoding = static_cast<PayloadEncoding>(bytes[2]);
+    fields.flags = bytes[3];
+    fields.width = get_le<uint16_t>(bytes + 4);
+    fields.height = get_le<uint16_t>(bytes + 6);
+    fields.sequence = get_le<uint64_t>(bytes + 8);
+    fields.sent_us = get_le<uint64_t>(bytes + 16);
+    fields.pipeline_us = get_le<uint32_t>(bytes + 24);
+    fields.payload_size = get_le<uint32_t>(bytes + 28);
+    return true;
+}
+
+bool decode_frame_header_echo(const void* data, size_t size, TraceEcho& echo) 
+{
+    FrameHeaderFields fields;
+    if (size != FRAME_HEADER_SIZE || !decode_frame_header(data, size, fields) ||
+        !(fields.flags & FRAME_FLAG_TRACED) || fields.sequence == 0) 
+    {
+        return false;
+    }
+
+    echo.sequence = fields.sequence;
+    echo.sent_at = FrameTrace::Clock::time_point(std::chrono::microseconds(fields.sent_us));
+    echo.pipeline = std::chrono::microseconds(fields.pipeline_us);
+    return true;
+}
\ No newline at end of file
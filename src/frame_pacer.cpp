@@ -0,0 +1,63 @@
+#include "frame_pacer.hpp"
+
+#include <thread>
+
+FramePacer::FramePacer(double fps) 
+{
+    set_fps(fps);
+}
+
+void FramePacer::set_fps(double fps) 
+{
+    interval_ = fps > 0 
+        ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / fps))
+        : std::chrono::steady_clock::duration::zero();
+    reset();
+}
+
+void FramePacer::reset() 
+{
+    next_ = {};
+}
+
+void FramePacer::wait() 
+{
+    if (interval_ == std::chrono::steady_clock::duration::zero()) 
+    {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (next_ == std::chrono::steady_clock::time_point{} || now - next_ > interval_) 
+    {
+        next_ = now;
+    } 
+    else 
+    {
+        std::this_thread::sleep_until(next_);
+    }
+
+    next_ += interval_;
+}
+
+bool FramePacer::due() 
+{
+    if (interval_ == std::chrono::steady_clock::duration::zero()) 
+    {
+        return true;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (next_ == std::chrono::steady_clock::time_point{} || now - next_ > interval_) 
+    {
+        next_ = now + interval_;
+        return true;
+    }
+    if (now < next_) 
+    {
+        return false;
+    }
+
+    next_ += interval_;
+    return true;
+}
\ No newline at end of file
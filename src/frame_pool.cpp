@@ -0,0 +1,65 @@
+#include "frame_pool.hpp"
+#include "logger.hpp"
+#include "metrics.hpp"
+
+#include <algorithm>
+
+namespace {
+
+struct PoolMetrics 
+{
+    metrics::Counter& grown = metrics::Registry::get().counter(
+        "ascii_frame_pool_grown_total", "Buffers added to frame pools because all buffers were held");
+    metrics::Counter& overflow = metrics::Registry::get().counter(
+        "ascii_frame_pool_overflow_total", "Temporary frame buffers handed out because a pool reached its max size");
+};
+
+PoolMetrics& pool_metrics() 
+{
+    static PoolMetrics instance;
+    return instance;
+}
+
+} // namespace
+
+FramePool::FramePool(size_t capacity, size_t max_size) 
+    : max_size_(max_size ? std::max(max_size, capacity) : capacity * MAX_GROWTH) 
+{
+    buffers_.reserve(capacity);
+    for (size_t i = 0; i < capacity; ++i) 
+    {
+        buffers_.push_back(std::make_shared<FrameBuffer>());
+    }
+}
+
+std::shared_ptr<FrameBuffer> FramePool::acquire() 
+{
+    // Обход по кругу, чтобы буферы использовались равномерно
+    for (size_t i = 0; i < buffers_.size(); ++i) 
+    {
+        auto& buffer = buffers_[(next_ + i) % buffers_.size()];
+        if (buffer.use_count() == 1) 
+        {
+            next_ = (next_ + i + 1) % buffers_.size();
+            return buffer;
+        }
+    }
+
+    // Буферы держат зрители, которые не успевают забирать кадры
+    if (buffers_.size() >= max_size_) 
+    {
+        pool_metrics().overflow.inc();
+        LOG_WARN_RATE_LIMITED("Frame pool reached its limit of {} buffers, allocating a temporary one", max_size_);
+        return std::make_shared<FrameBuffer>();
+    }
+
+    // Все буферы заняты медленными зрителями - пул растет. После прогрева
+    // размер стабилизируется на максимальной глубине очередей.
+    auto logger = Logger::get();
+    logger->debug("Frame pool exhausted, growing to {} buffers", buffers_.size() + 1);
+    pool_metrics().grown.inc();
+
+    buffers_.push_back(std::make_shared<FrameBuffer>());
+    next_ = 0;
+    return buffers_.back();
+}
\ No newline at end of file
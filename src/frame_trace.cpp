@@ -0,0 +1,34 @@
+#include "frame_trace.hpp"
+#include "byte_order.hpp"
+
+#include <algorithm>
+
+TraceHeader encode_trace_header(const FrameTrace& trace, FrameTrace::Clock::time_point sent_at) 
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    const auto sent_us = duration_cast<microseconds>(sent_at.time_since_epoch()).count();
+    const auto pipeline_us = std::clamp<long long>(
+        duration_cast<microseconds>(sent_at - trace.captured_at).count(), 0, UINT32_MAX);
+
+    TraceHeader header{};
+    put_le<uint64_t>(header.data(), trace.sequence);
+    put_le<uint64_t>(header.data() + 8, static_cast<uint64_t>(sent_us));
+    put_le<uint32_t>(header.data() + 16, static_cast<uint32_t>(pipeline_us));
+    return header;
+}
+
+bool decode_trace_echo(const void* data, size_t size, TraceEcho& echo) 
+{
+    if (size != TRACE_HEADER_SIZE) 
+    {
+        return false;
+    }
+
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    echo.sequence = get_le<uint64_t>(bytes);
+    echo.sent_at = FrameTrace::Clock::time_point(std::chrono::microseconds(get_le<uint64_t>(bytes + 8)));
+    echo.pipeline = std::chrono::microseconds(get_le<uint32_t>(bytes + 16));
+    return echo.sequence != 0;
+}
\ No newline at end of file
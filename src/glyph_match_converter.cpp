@@ -0,0 +1,201 @@
+#include "glyph_match_converter.hpp"
+#include "logger.hpp"
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+// Холст для одного символа: пропорции клетки терминала 1:2
+const int GLYPH_CANVAS_WIDTH = 24;
+const int GLYPH_CANVAS_HEIGHT = 48;
+
+static_assert(GlyphMatchConverter::CELL_WIDTH == 2, "convert() reads two samples per cell row");
+
+int level_value(int level) 
+{
+    return level * 255 / (GlyphMatchConverter::LEVELS - 1);
+}
+
+} // namespace
+
+GlyphMatchConverter::GlyphMatchConverter() 
+{
+    for (int i = 0; i < 256; ++i) 
+    {
+        quantize_[i] = static_cast<uint8_t>((i * (LEVELS - 1) + 127) / 255);
+    }
+    set_ascii_chars(printable_glyphs());
+}
+
+std::string GlyphMatchConverter::printable_glyphs() 
+{
+    std::string glyphs;
+    for (char c = 32; c < 127; ++c) 
+    {
+        glyphs += c;
+    }
+    return glyphs;
+}
+
+std::vector<GlyphMatchConverter::GlyphVector> GlyphMatchConverter::render_glyphs(const std::string& glyphs) 
+{
+    const int block_width = GLYPH_CANVAS_WIDTH / CELL_WIDTH;
+    const int block_height = GLYPH_CANVAS_HEIGHT / CELL_HEIGHT;
+
+    // Доля "чернил" в каждой подобласти
+    std::vector<std::array<double, SAMPLES>> ink(glyphs.size());
+    double max_ink = 0;
+    cv::Mat canvas(GLYPH_CANVAS_HEIGHT, GLYPH_CANVAS_WIDTH, CV_8UC1);
+
+    for (size_t g = 0; g < glyphs.size(); ++g) 
+    {
+        canvas.setTo(cv::Scalar(255));
+        const std::string text(1, glyphs[g]);
+        int baseline = 0;
+        cv::Size size = cv::getTextSize(text, cv::FONT_HERSHEY_PLAIN, 2.0, 2, &baseline);
+        cv::Point origin((GLYPH_CANVAS_WIDTH - size.width) / 2, 
+                         (GLYPH_CANVAS_HEIGHT + size.height) / 2 - baseline / 2);
+        cv::putText(canvas, text, origin, cv::FONT_HERSHEY_PLAIN, 2.0, cv::Scalar(0), 2, cv::LINE_AA);
+
+        for (int by = 0; by < CELL_HEIGHT; ++by) 
+        {
+            for (int bx = 0; bx < CELL_WIDTH; ++bx) 
+            {
+                cv::Mat block = canvas(cv::Rect(bx * block_width, by * block_height, block_width, block_height));
+                double value = 1.0 - cv::mean(block)[0] / 255.0;
+                ink[g][by * CELL_WIDTH + bx] = value;
+                max_ink = std::max(max_ink, value);
+            }
+        }
+    }
+
+    // Штрихи шрифта тонкие: растягиваем покрытие, чтобы самая плотная
+    // подобласть соответствовала черному
+    std::vector<GlyphVector> vectors(glyphs.size());
+    for (size_t g = 0; g < glyphs.size(); ++g) 
+    {
+        for (int i = 0; i < SAMPLES; ++i) 
+        {
+            double scaled = max_ink > 0 ? ink[g][i] / max_ink : 0;
+            vectors[g][i] = cv::saturate_cast<uint8_t>(255.0 * (1.0 - scaled));
+        }
+    }
+    return vectors;
+}
+
+void GlyphMatchConverter::set_ascii_chars(const std::string& chars) 
+{
+    // Набор передается при каждом запуске трансляции, а таблица
+    // соответствует ему всегда, поэтому перестраивать ее незачем
+    if (chars == glyphs_) 
+    {
+        return;
+    }
+
+    glyphs_ = chars;
+    build_table();
+}
+
+void GlyphMatchConverter::build_table() 
+{
+    auto logger = Logger::get();
+
+    table_.clear();
+    if (glyphs_.empty()) 
+    {
+        return;
+    }
+
+    const std::vector<GlyphVector> vectors = render_glyphs(glyphs_);
+    table_.resize(TABLE_SIZE);
+
+    // Полный перебор 65536 ключей на каждый символ выполняется только
+    // при смене набора символов
+    for (size_t key = 0; key < TABLE_SIZE; ++key) 
+    {
+        int samples[SAMPLES];
+        for (int i = 0; i < SAMPLES; ++i) 
+        {
+            samples[i] = level_value(static_cast<int>((key >> (2 * i)) & 0x3));
+        }
+
+        int best_distance = std::numeric_limits<int>::max();
+        char best_glyph = glyphs_[0];
+        for (size_t g = 0; g < vectors.size(); ++g) 
+        {
+            int distance = 0;
+            for (int i = 0; i < SAMPLES; ++i) 
+            {
+                int diff = samples[i] - vectors[g][i];
+                distance += diff * diff;
+            }
+            if (distance < best_distance) 
+            {
+                best_distance = distance;
+                best_glyph = glyphs_[g];
+            }
+        }
+        table_[key] = best_glyph;
+    }
+
+    logger->debug("Glyph lookup table built for {} glyphs", glyphs_.size());
+}
+
+void GlyphMatchConverter::convert(const cv::Mat& frame, int output_width, int output_height, std::string& output) 
+{
+    auto logger = Logger::get();
+
+    if (frame.empty()) 
+    {
+        LOG_WARN_RATE_LIMITED("Attempted to convert empty frame");
+        output.clear();
+        return;
+    }
+
+    if (table_.empty()) 
+    {
+        logger->error("ASCII characters not set");
+        output = "CONFIG ERROR";
+        return;
+    }
+
+    const cv::Mat* luma = &frame;
+    if (frame.channels() != 1) 
+    {
+        cv::cvtColor(frame, gray_, cv::COLOR_BGR2GRAY);
+        luma = &gray_;
+    }
+
+    // Каждая клетка - CELL_WIDTH x CELL_HEIGHT отсчетов усредненной яркости
+    cv::resize(*luma, samples_, cv::Size(output_width * CELL_WIDTH, output_height * CELL_HEIGHT), 
+               0, 0, cv::INTER_AREA);
+
+    output.resize(static_cast<size_t>(output_height) * (output_width + 1));
+    char* out = output.data();
+    const uint8_t* quantize = quantize_.data();
+
+    for (int y = 0; y < output_height; ++y) 
+    {
+        const uchar* rows[CELL_HEIGHT];
+        for (int r = 0; r < CELL_HEIGHT; ++r) 
+        {
+            rows[r] = samples_.ptr<uchar>(y * CELL_HEIGHT + r);
+        }
+
+        for (int x = 0; x < output_width; ++x) 
+        {
+            const int sx = x * CELL_WIDTH;
+            unsigned key = 0;
+            for (int r = 0; r < CELL_HEIGHT; ++r) 
+            {
+                key |= static_cast<unsigned>(quantize[rows[r][sx]]) << (2 * (r * CELL_WIDTH));
+                key |= static_cast<unsigned>(quantize[rows[r][sx + 1]]) << (2 * (r * CELL_WIDTH + 1));
+            }
+            *out++ = table_[key];
+        }
+
+        *out++ = '\n';
+    }
+}
\ No newline at end of file
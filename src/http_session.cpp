@@ -5,47 +5,96 @@
 #include "logger.hpp"
 #include "network_utils.hpp"
 #include "api_key_manager.hpp"
+#include "metrics.hpp"
 
 #include <nlohmann/json.hpp>
 #include <fstream>
 #include <sstream>
 #include <filesystem>
 
-HttpSession::HttpSession(
-    tcp::socket socket,
-    net::ssl::context& ssl_ctx,
+template <class Stream>
+HttpSession<Stream>::HttpSession(
+    Stream stream,
     std::shared_ptr<Server> srv, 
-    std::string doc_root
+    std::string doc_root,
+    AdmissionController::Slot connection
 )
-    : stream_(std::move(socket), ssl_ctx),
+    : stream_(std::move(stream)),
     server_(srv), 
-    doc_root_(std::move(doc_root)) 
+    doc_root_(std::move(doc_root)),
+    connection_(std::move(connection)),
+    deadline_(stream_.get_executor()) 
 {}
 
-void HttpSession::run() 
+template <class Stream>
+void HttpSession<Stream>::run() 
 {
-    auto self = shared_from_this();
-    stream_.async_handshake(
-        boost::asio::ssl::stream_base::server,
-        [self](boost::system::error_code ec) {
-            if(ec) 
-            {
-                auto logger = Logger::get();
-                logger->error("SSL handshake failed: {} (category: {})", 
-                                 ec.message(), ec.category().name());
-                return;
-            }
-            self->do_read();
-        });
+    if constexpr (!StreamTraits<Stream>::secure) 
+    {
+        do_read();
+    } 
+    else 
+    {
+        static auto& handshake_time = metrics::Registry::get().latency(
+            "ascii_tls_handshake_seconds", "TLS handshake duration");
+        static auto& handshake_failures = metrics::Registry::get().counter(
+            "ascii_tls_handshake_failures_total", "Failed TLS handshakes");
+
+        // Рукопожатие - самая дорогая часть соединения, число одновременных ограничено
+        auto handshake = server_->admission().begin_handshake();
+        if (!handshake) 
+        {
+            LOG_WARN_RATE_LIMITED("Too many TLS handshakes in flight, dropping connection");
+            return;
+        }
+
+        auto self = this->shared_from_this();
+        start_deadline(HANDSHAKE_TIMEOUT);
+
+        stream_.async_handshake(
+            boost::asio::ssl::stream_base::server,
+            [self, started = std::chrono::steady_clock::now(), 
+             handshake = std::move(handshake)](boost::system::error_code ec) mutable {
+                handshake.release();
+                self->deadline_.cancel();
+                handshake_time.observe(std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - started));
+                if(ec) 
+                {
+                    handshake_failures.inc();
+                    auto logger = Logger::get();
+                    logger->error("SSL handshake failed: {} (category: {})", 
+                                     ec.message(), ec.category().name());
+                    return;
+                }
+                self->do_read();
+            });
+    }
+}
+
+template <class Stream>
+void HttpSession<Stream>::start_deadline(std::chrono::seconds timeout) 
+{
+    deadline_.expires_after(timeout);
+    deadline_.async_wait([self = this->shared_from_this()](boost::system::error_code ec) {
+        if (!ec) 
+        {
+            // Незавершенная операция прерывается закрытием сокета
+            beast::get_lowest_layer(self->stream_).close(ec);
+        }
+    });
 }
 
-void HttpSession::do_read() 
+template <class Stream>
+void HttpSession<Stream>::do_read() 
 {
     auto logger = Logger::get();
 
     request_ = {};
+    start_deadline(REQUEST_TIMEOUT);
     http::async_read(stream_, buffer_, request_,
-        [self = shared_from_this(), logger](beast::error_code ec, size_t bytes) {
+        [self = this->shared_from_this(), logger](beast::error_code ec, size_t bytes) {
+            self->deadline_.cancel();
             if(ec) 
             {
                 logger->warn("HTTP read error: {}", ec.message());
@@ -56,11 +105,12 @@ void HttpSession::do_read()
             {
                 logger->debug("WebSocket upgrade requested");
                 
-                // Создаем WebSocket сессию с SSL потоком
-                auto ws_session = std::make_shared<WebSocketSession>(
+                // WebSocket-сессия получает тот же поток (с TLS или без)
+                auto ws_session = std::make_shared<WebSocketSession<Stream>>(
                     std::move(self->stream_),
                     self->server_->stream_controller(),
-                    self->server_);
+                    self->server_,
+                    std::move(self->connection_));
                     
                 ws_session->run(self->request_);
                 return;
@@ -70,7 +120,8 @@ void HttpSession::do_read()
         });
 }
 
-std::string HttpSession::get_mime_type(const std::string& path) const 
+template <class Stream>
+std::string HttpSession<Stream>::get_mime_type(const std::string& path) const 
 {
     if (path.size() > 5 && path.compare(path.size() - 5, 5, ".html") == 0)
         return "text/html";
@@ -96,7 +147,8 @@ std::string HttpSession::get_mime_type(const std::string& path) const
     return "application/octet-stream";
 }
 
-void HttpSession::handle_request() 
+template <class Stream>
+void HttpSession<Stream>::handle_request() 
 {
     auto logger = Logger::get();
     logger->debug("HTTP request: {}", request_.target());
@@ -145,6 +197,17 @@ void HttpSession::handle_request()
         return;
     }
 
+    if (request_.target() == "/metrics" && request_.method() == http::verb::get) 
+    {
+        res.result(http::status::ok);
+        res.set(http::field::content_type, "text/plain; version=0.0.4");
+        res.body() = metrics::Registry::get().render();
+        
+        res.prepare_payload();
+        http::write(stream_, res);
+        return;
+    }
+
     if (request_.target() == "/api") 
     {
         logger->debug("Handling /api request");
@@ -160,7 +223,12 @@ void HttpSession::handle_request()
         unsigned short port = endpoint.port();
         std::string address;
 
-        if (!tunnel_url.empty())
+        // Клиенты внутреннего слушателя подключаются к нему же, без TLS
+        if (!StreamTraits<Stream>::secure)
+        {
+            j["endpoint"] = server_->plain_stream_url();
+        }
+        else if (!tunnel_url.empty())
         {
             address = server_->cloud_tunnel_url();
             size_t pos = address.find("https://");
@@ -297,6 +365,59 @@ void HttpSession::handle_request()
         return;
     }
 
+    if (request_.target().starts_with("/recordings/") && request_.target().ends_with("/preview") &&
+        request_.method() == http::verb::get) 
+    {
+        auto target = request_.target();
+        std::string filename(target.substr(12, target.size() - 12 - 8)); // Remove "/recordings/" and "/preview"
+        
+        RecordController::RecordingPreview preview;
+        RecordController::PreviewStatus status = RecordController::PreviewStatus::Missing;
+        if (filename.find("..") != std::string::npos || filename.find("/") != std::string::npos) 
+        {
+            res.result(http::status::bad_request);
+            res.set(http::field::content_type, "text/plain");
+            res.body() = "Invalid filename";
+        } 
+        else if ((status = server_->stream_controller()->record_controller()->get_preview(filename, preview)) ==
+                 RecordController::PreviewStatus::Ready) 
+        {
+            nlohmann::json j;
+            j["filename"] = preview.filename;
+            j["frame_count"] = preview.frame_count;
+            j["frames"] = nlohmann::json::array();
+            for (const auto& frame : preview.frames) 
+            {
+                j["frames"].push_back({
+                    {"timestamp", frame.timestamp},
+                    {"frame", frame.frame}
+                });
+            }
+            
+            res.result(http::status::ok);
+            res.set(http::field::content_type, "application/json");
+            res.body() = j.dump();
+        } 
+        else if (status == RecordController::PreviewStatus::Pending) 
+        {
+            // Превью строится в фоне, клиент повторяет запрос
+            res.result(http::status::accepted);
+            res.set(http::field::retry_after, "1");
+            res.set(http::field::content_type, "text/plain");
+            res.body() = "Preview is being built";
+        } 
+        else 
+        {
+            res.result(http::status::not_found);
+            res.set(http::field::content_type, "text/plain");
+            res.body() = "Preview not available";
+        }
+        
+        res.prepare_payload();
+        http::write(stream_, res);
+        return;
+    }
+
     if (request_.target().starts_with("/recordings/") && request_.method() == http::verb::delete_) 
     {
         auto logger = Logger::get();
@@ -315,6 +436,8 @@ void HttpSession::handle_request()
             if (std::filesystem::exists(filepath)) 
             {
                 std::filesystem::remove(filepath);
+                std::filesystem::remove(index_filename(filepath));
+                server_->stream_controller()->record_controller()->remove_preview(filename);
                 res.result(http::status::ok);
                 res.body() = "File deleted";
                 logger->info("Deleted recording: {}", filename);
@@ -362,4 +485,10 @@ void HttpSession::handle_request()
     logger->debug("Sending HTTP response");
     res.prepare_payload();
     http::write(stream_, res);
-}
\ No newline at end of file
+}
+
+template class HttpSession<TlsStream>;
+template class HttpSession<PlainStream>;
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+template class HttpSession<LocalStream>;
+#endif
\ No newline at end of file
@@ -1,29 +1,42 @@
 #include "logger.hpp"
 
+#include <spdlog/async.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/rotating_file_sink.h>
 #include <iostream>
 
 std::shared_ptr<spdlog::logger> Logger::logger_ = nullptr;
+spdlog::logger* Logger::raw_logger_ = nullptr;
 
 void Logger::init() 
 {
+    if (logger_) 
+    {
+        return;
+    }
+
     try 
     {
+        // Очередь выделяется один раз; пишет в синки один поток
+        spdlog::init_thread_pool(QUEUE_SIZE, 1);
+
         auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
         auto file_sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>("logs/server.log", 1024 * 1024 * 5, 3);
         
         spdlog::sinks_init_list sinks = {console_sink, file_sink};
-        logger_ = std::make_shared<spdlog::logger>("main", sinks);
+        logger_ = std::make_shared<spdlog::async_logger>("main", sinks, spdlog::thread_pool(), 
+                                                         spdlog::async_overflow_policy::overrun_oldest);
         
         #ifdef DEBUG
         logger_->set_level(spdlog::level::debug);
         #else
         logger_->set_level(spdlog::level::info);
         #endif
+        logger_->flush_on(spdlog::level::err);
         
         spdlog::register_logger(logger_);
         spdlog::set_default_logger(logger_);
+        raw_logger_ = logger_.get();
     } 
     catch (const spdlog::spdlog_ex& ex) 
     {
@@ -31,7 +44,31 @@ void Logger::init()
     }
 }
 
-std::shared_ptr<spdlog::logger> Logger::get() 
+void Logger::shutdown() 
 {
-    return logger_;
+    spdlog::shutdown();
+    raw_logger_ = nullptr;
+    logger_.reset();
 }
+
+LogThrottle::LogThrottle(std::chrono::milliseconds interval)
+    : interval_(interval) 
+{
+}
+
+bool LogThrottle::allow(uint64_t& suppressed) 
+{
+    const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+    auto next = next_allowed_.load(std::memory_order_relaxed);
+    
+    // Из нескольких потоков в интервал проходит только один
+    if (now < next || !next_allowed_.compare_exchange_strong(next, now + interval_.count(), 
+                                                             std::memory_order_relaxed)) 
+    {
+        suppressed_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    
+    suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+    return true;
+}
\ No newline at end of file
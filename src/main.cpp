@@ -1,11 +1,22 @@
 #include "server.hpp"
+#include "stream_controller.hpp"
 #include "video_source.hpp"
+#include "file_video_source.hpp"
+#include "synthetic_video_source.hpp"
 #include "ascii_converter.hpp"
+#include "glyph_match_converter.hpp"
+#include "unicode_converter.hpp"
 #include "logger.hpp"
 #include "network_utils.hpp"
+#include "server_config.hpp"
+#include "relay_client.hpp"
 
+#ifdef __linux__
+#include "v4l2_video_source.hpp"
+#endif
 
-int main() 
+
+int main(int argc, char* argv[]) 
 {
     Logger::init();
     auto logger = Logger::get();
@@ -15,18 +26,105 @@ int main()
         logger->info("Starting ASCII streamer server");
 
         // Конфигурация сервера
-        const std::string address = "0.0.0.0";
-        const unsigned short port = 8080;
-        const std::string doc_root = "../web";
-        const bool enable_cloud_tunnel = true;
+        const ServerConfig config = load_config(argc > 1 ? argv[1] : "config.json");
+        const std::string& address = config.address;
+        const unsigned short port = config.port;
+        const std::string& doc_root = config.doc_root;
+        const bool enable_cloud_tunnel = config.enable_cloud_tunnel;
 
-        auto video_source = std::make_shared<VideoSource>();
-        auto ascii_converter = std::make_shared<AsciiConverter>();
+        std::shared_ptr<IVideoSource> video_source;
+        if (config.video_backend == "file") 
+        {
+            logger->info("Using video file {} as the frame source", config.video_file);
+            video_source = std::make_shared<FileVideoSource>(config.video_file, config.source_fps);
+        } 
+        else if (config.video_backend == "synthetic") 
+        {
+            logger->info("Using synthetic '{}' frames as the frame source", config.synthetic_pattern);
+            video_source = std::make_shared<SyntheticVideoSource>(
+                SyntheticVideoSource::parse_pattern(config.synthetic_pattern), config.source_fps);
+        }
+        #ifdef __linux__
+        else if (config.video_backend == "v4l2") 
+        {
+            logger->info("Using native V4L2 capture");
+            video_source = std::make_shared<V4l2VideoSource>();
+        }
+        #endif
+        if (!video_source) 
+        {
+            video_source = std::make_shared<VideoSource>();
+        }
+        std::shared_ptr<IAsciiConverter> ascii_converter;
+        std::string ascii_chars = config.ascii_chars;
+        if (config.converter == "glyph") 
+        {
+            logger->info("Using glyph shape matching converter");
+            ascii_converter = std::make_shared<GlyphMatchConverter>();
+            if (ascii_chars.empty()) 
+            {
+                ascii_chars = GlyphMatchConverter::printable_glyphs();
+            }
+        } 
+        else if (config.converter == "braille" || config.converter == "half_block") 
+        {
+            logger->info("Using unicode '{}' converter", config.converter);
+            ascii_converter = std::make_shared<UnicodeConverter>(
+                UnicodeConverter::parse_mode(config.converter));
+        } 
+        else 
+        {
+            ascii_converter = std::make_shared<AsciiConverter>();
+        }
         
         // Запуск сервера
         net::io_context ioc;
         auto server = make_server(ioc, tcp::endpoint(
             net::ip::make_address(address), port), doc_root, video_source, ascii_converter, enable_cloud_tunnel);
+
+        if (!ascii_chars.empty()) 
+        {
+            server->stream_controller()->set_ascii_chars(ascii_chars);
+        }
+        server->set_websocket_compression(config.websocket_compression);
+        
+        AdmissionLimits admission;
+        admission.max_connections = config.max_connections;
+        admission.max_handshakes = config.max_handshakes;
+        admission.connections_per_second = config.connections_per_ip_per_second;
+        admission.connection_burst = config.connection_burst_per_ip;
+        admission.max_connections_per_ip = config.max_connections_per_ip;
+        admission.max_auth_failures = config.max_auth_failures;
+        admission.auth_lockout = std::chrono::seconds(config.auth_lockout_seconds);
+        admission.max_viewers = config.max_viewers;
+        server->set_admission_limits(admission);
+        
+        if (!config.plain_listen.empty()) 
+        {
+            server->listen_plain(config.plain_listen);
+        }
+        server->stream_controller()->set_idle_policy(
+            std::chrono::seconds(config.idle_linger_seconds), config.release_camera_when_idle);
+        server->stream_controller()->record_controller()->set_pre_roll_budget(
+            config.auto_record_pre_roll_mb * 1024 * 1024);
+        
+        if (!config.frame_bus_name.empty()) 
+        {
+            logger->info("Publishing frames to shared memory {} ({} slots of {} bytes)", 
+                         config.frame_bus_name, config.frame_bus_slots, config.frame_bus_slot_bytes);
+            server->stream_controller()->set_frame_bus(std::make_shared<frame_bus::Writer>(
+                config.frame_bus_name, config.frame_bus_slots, config.frame_bus_slot_bytes));
+        }
+        
+        std::shared_ptr<RelayClient> relay;
+        if (!config.relay_upstream.empty()) 
+        {
+            logger->info("Relay mode: subscribing to upstream {}", config.relay_upstream);
+            server->stream_controller()->set_relay_mode(true);
+            relay = std::make_shared<RelayClient>(ioc, config.relay_upstream, server->stream_controller(), 
+                                                  config.relay_ca_file, config.relay_insecure_localhost);
+            relay->run();
+        }
         
         logger->info("SSL/TLS enabled - using HTTPS/WSS protocol");
         logger->info("Go to the page: https://{}:{}", address, port);
@@ -47,8 +145,10 @@ int main()
     catch (const std::exception& e) 
     {
         logger->critical("Fatal error: {}", e.what());
+        Logger::shutdown();
         return 1;
     }
     
+    Logger::shutdown();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,229 @@
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+namespace metrics {
+
+namespace {
+
+template <typename Metric>
+Metric* find(const std::vector<std::unique_ptr<Metric>>& metrics, const std::string& name) 
+{
+    for (const auto& metric : metrics) 
+    {
+        if (metric->name() == name) 
+        {
+            return metric.get();
+        }
+    }
+    return nullptr;
+}
+
+void write_header(std::ostringstream& out, const std::string& name, const std::string& help, const char* type) 
+{
+    out << "# HELP " << name << " " << help << "\n";
+    out << "# TYPE " << name << " " << type << "\n";
+}
+
+} // namespace
+
+size_t shard_index() 
+{
+    static std::atomic<size_t> next_shard{0};
+    thread_local const size_t index = next_shard.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+    return index;
+}
+
+Counter::Counter(std::string name, std::string help)
+    : name_(std::move(name)),
+      help_(std::move(help)) 
+{
+}
+
+uint64_t Counter::value() const 
+{
+    uint64_t total = 0;
+    for (const auto& shard : shards_) 
+    {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+Gauge::Gauge(std::string name, std::string help)
+    : name_(std::move(name)),
+      help_(std::move(help)) 
+{
+}
+
+Histogram::Histogram(std::string name, std::string help, std::vector<uint64_t> bounds, double scale)
+    : name_(std::move(name)),
+      help_(std::move(help)),
+      bounds_(std::move(bounds)),
+      scale_(scale) 
+{
+    std::sort(bounds_.begin(), bounds_.end());
+    shards_.reserve(SHARDS);
+    for (size_t i = 0; i < SHARDS; ++i) 
+    {
+        shards_.push_back(std::make_unique<Shard>(bounds_.size() + 1));
+    }
+}
+
+void Histogram::observe(uint64_t value) 
+{
+    // Корзин немного (до двух десятков), линейный поиск по ним быстрее бинарного
+    size_t bucket = 0;
+    while (bucket < bounds_.size() && value > bounds_[bucket]) 
+    {
+        ++bucket;
+    }
+
+    Shard& shard = *shards_[shard_index()];
+    shard.counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+Histogram::Snapshot Histogram::snapshot() const 
+{
+    Snapshot result;
+    result.cumulative.assign(bounds_.size() + 1, 0);
+
+    for (const auto& shard : shards_) 
+    {
+        for (size_t i = 0; i < shard->counts.size(); ++i) 
+        {
+            result.cumulative[i] += shard->counts[i].load(std::memory_order_relaxed);
+        }
+        result.sum += shard->sum.load(std::memory_order_relaxed);
+    }
+
+    for (size_t i = 1; i < result.cumulative.size(); ++i) 
+    {
+        result.cumulative[i] += result.cumulative[i - 1];
+    }
+    result.count = result.cumulative.back();
+    return result;
+}
+
+double Histogram::quantile(const Snapshot& snapshot, double q) const 
+{
+    if (snapshot.count == 0) 
+    {
+        return 0.0;
+    }
+
+    const double rank = q * static_cast<double>(snapshot.count);
+    for (size_t i = 0; i < bounds_.size(); ++i) 
+    {
+        if (static_cast<double>(snapshot.cumulative[i]) >= rank) 
+        {
+            const uint64_t below = i > 0 ? snapshot.cumulative[i - 1] : 0;
+            const double lower = i > 0 ? static_cast<double>(bounds_[i - 1]) : 0.0;
+            const double upper = static_cast<double>(bounds_[i]);
+            const uint64_t in_bucket = snapshot.cumulative[i] - below;
+            const double fraction = in_bucket > 0 ? (rank - below) / in_bucket : 0.0;
+            return (lower + (upper - lower) * fraction) * scale_;
+        }
+    }
+
+    // Значение за последней границей: точнее оценить нельзя
+    return bounds_.empty() ? 0.0 : bounds_.back() * scale_;
+}
+
+std::vector<uint64_t> latency_bounds_us() 
+{
+    return {50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000};
+}
+
+Registry& Registry::get() 
+{
+    static Registry registry;
+    return registry;
+}
+
+Counter& Registry::counter(const std::string& name, const std::string& help) 
+{
+    std::lock_guard lock(mutex_);
+    if (auto* existing = find(counters_, name)) 
+    {
+        return *existing;
+    }
+    counters_.push_back(std::make_unique<Counter>(name, help));
+    return *counters_.back();
+}
+
+Gauge& Registry::gauge(const std::string& name, const std::string& help) 
+{
+    std::lock_guard lock(mutex_);
+    if (auto* existing = find(gauges_, name)) 
+    {
+        return *existing;
+    }
+    gauges_.push_back(std::make_unique<Gauge>(name, help));
+    return *gauges_.back();
+}
+
+Histogram& Registry::histogram(const std::string& name, const std::string& help, 
+                               std::vector<uint64_t> bounds, double scale) 
+{
+    std::lock_guard lock(mutex_);
+    if (auto* existing = find(histograms_, name)) 
+    {
+        return *existing;
+    }
+    histograms_.push_back(std::make_unique<Histogram>(name, help, std::move(bounds), scale));
+    return *histograms_.back();
+}
+
+Histogram& Registry::latency(const std::string& name, const std::string& help) 
+{
+    return histogram(name, help, latency_bounds_us(), 1e-6);
+}
+
+std::string Registry::render() const 
+{
+    std::lock_guard lock(mutex_);
+    std::ostringstream out;
+
+    for (const auto& counter : counters_) 
+    {
+        write_header(out, counter->name(), counter->help(), "counter");
+        out << counter->name() << " " << counter->value() << "\n";
+    }
+
+    for (const auto& gauge : gauges_) 
+    {
+        write_header(out, gauge->name(), gauge->help(), "gauge");
+        out << gauge->name() << " " << gauge->value() << "\n";
+    }
+
+    for (const auto& histogram : histograms_) 
+    {
+        const auto snapshot = histogram->snapshot();
+        const auto& bounds = histogram->bounds();
+        const double scale = histogram->scale();
+
+        write_header(out, histogram->name(), histogram->help(), "histogram");
+        for (size_t i = 0; i < bounds.size(); ++i) 
+        {
+            out << histogram->name() << "_bucket{le=\"" << bounds[i] * scale << "\"} " 
+                << snapshot.cumulative[i] << "\n";
+        }
+        out << histogram->name() << "_bucket{le=\"+Inf\"} " << snapshot.count << "\n";
+        out << histogram->name() << "_sum " << snapshot.sum * scale << "\n";
+        out << histogram->name() << "_count " << snapshot.count << "\n";
+
+        for (const auto& [suffix, q] : {std::pair{"_p50", 0.5}, std::pair{"_p99", 0.99}}) 
+        {
+            const std::string name = histogram->name() + suffix;
+            write_header(out, name, histogram->help() + " (estimated quantile)", "gauge");
+            out << name << " " << histogram->quantile(snapshot, q) << "\n";
+        }
+    }
+
+    return out.str();
+}
+
+} // namespace metrics
\ No newline at end of file
@@ -76,6 +76,11 @@ bool PlaybackController::load_recording(const std::string& filename)
         // Continue until we find the frames section
     }
     
+    if (!load_activity_index(filename)) 
+    {
+        logger->debug("No activity index for recording: {}", filename);
+    }
+    
     logger->info("Loaded recording: {} ({} frames, {}s)", 
                 filename, current_recording_info_.frame_count, current_recording_info_.duration);
     
@@ -147,6 +152,73 @@ void PlaybackController::set_playback_speed(double speed)
     playback_speed_ = std::max(0.1, std::min(10.0, speed));
 }
 
+bool PlaybackController::load_activity_index(const std::string& filename) 
+{
+    return read_recording_index(index_filename(filename), activity_index_);
+}
+
+bool PlaybackController::has_activity_index() const 
+{
+    return !activity_index_.empty();
+}
+
+bool PlaybackController::seek_to_activity(bool forward, int threshold) 
+{
+    if (!playback_file_.is_open() || activity_index_.empty()) 
+    {
+        return false;
+    }
+    
+    auto is_segment_start = [&](size_t i) {
+        return activity_index_[i].activity >= threshold &&
+               (i == 0 || activity_index_[i - 1].activity < threshold);
+    };
+    
+    // current_frame_ points past the frame on screen
+    size_t shown = current_frame_ > 0 ? current_frame_ - 1 : 0;
+    size_t target = activity_index_.size();
+    
+    if (forward) 
+    {
+        for (size_t i = shown + 1; i < activity_index_.size(); ++i) 
+        {
+            if (is_segment_start(i)) 
+            {
+                target = i;
+                break;
+            }
+        }
+    } 
+    else 
+    {
+        for (size_t i = shown; i-- > 0; ) 
+        {
+            if (is_segment_start(i)) 
+            {
+                target = i;
+                break;
+            }
+        }
+    }
+    
+    if (target == activity_index_.size()) 
+    {
+        return false;
+    }
+    
+    playback_timer_.cancel();
+    playback_file_.clear();
+    playback_file_.seekg(activity_index_[target].offset);
+    current_frame_ = target;
+    next_frame_time_ = activity_index_[target].timestamp;
+    
+    auto logger = Logger::get();
+    logger->debug("Seeked playback to frame {} ({} ms)", target, next_frame_time_);
+    
+    read_next_frame();
+    return true;
+}
+
 bool PlaybackController::is_playing() const 
 {
     return is_playing_;
@@ -1,7 +1,9 @@
 #include "record_controller.hpp"
 #include "logger.hpp"
+#include "metrics.hpp"
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
 
 RecordController::RecordController(boost::asio::io_context& ioc) 
     : ioc_(ioc) 
@@ -13,6 +15,8 @@ RecordController::RecordController(boost::asio::io_context& ioc)
 RecordController::~RecordController() 
 {
     stop_recording();
+    preview_builder_.stop();
+    preview_builder_.join();
 }
 
 bool RecordController::start_recording() 
@@ -49,6 +53,9 @@ bool RecordController::start_recording()
     is_recording_ = true;
     start_time_ = std::chrono::steady_clock::now();
     frame_count_ = 0;
+    index_.clear();
+    preview_samples_.clear();
+    preview_stride_ = 1;
     
     logger->info("Started recording to file: {}", filename_);
     return true;
@@ -66,25 +73,613 @@ void RecordController::stop_recording()
         record_file_ << "end_time:" << seconds << "\n";
         record_file_ << "frame_count:" << frame_count_ << "\n";
         record_file_.close();
+        write_index();
         
         is_recording_ = false;
         logger->info("Stopped recording to file: {} (duration: {}s, frames: {})", 
                     filename_, seconds, frame_count_);
+        
+        auto preview = finish_preview();
+        std::lock_guard<std::mutex> lock(catalog_mutex_);
+        cache_preview(std::move(preview));
     }
 }
 
-void RecordController::write_frame(const std::string& frame) 
+void RecordController::write_frame(const std::string& frame, int activity) 
+{
+    write_frame_at(std::chrono::steady_clock::now(), frame, activity);
+}
+
+void RecordController::write_frame_at(std::chrono::steady_clock::time_point captured_at, 
+                                      const std::string& frame, int activity) 
 {
+    static auto& write_latency = metrics::Registry::get().latency(
+        "ascii_record_write_seconds", "Time to append a frame to the active recording");
+
     if (is_recording_ && record_file_.is_open()) 
     {
-        auto now = std::chrono::steady_clock::now();
+        const auto started = std::chrono::steady_clock::now();
         auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now - start_time_).count();
+            captured_at - start_time_).count();
         
+        index_.push_back({timestamp, static_cast<std::streamoff>(record_file_.tellp()), activity});
         record_file_ << "frame:" << timestamp << ":" << frame.length() << "\n";
         record_file_ << frame << "\n";
+        
+        sample_preview_frame(timestamp, frame);
         frame_count_++;
+        
+        write_latency.observe(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started));
+    }
+}
+
+void RecordController::enable_auto_record(const AutoRecordSettings& settings) 
+{
+    auto logger = Logger::get();
+    
+    auto_settings_ = settings;
+    
+    // Slots are allocated once here; their buffers are reused afterwards
+    pre_roll_.clear();
+    pre_roll_.resize(pre_roll_capacity(settings));
+    pre_roll_head_ = 0;
+    pre_roll_size_ = 0;
+    pre_roll_bytes_ = 0;
+    auto_started_ = false;
+    auto_record_ = true;
+    
+    logger->info("Auto-record enabled (pre-roll: {}s, threshold: {}, cooldown: {}s)", 
+                settings.pre_roll_seconds, settings.threshold, settings.cooldown_seconds);
+}
+
+void RecordController::disable_auto_record() 
+{
+    if (!auto_record_) 
+    {
+        return;
+    }
+    
+    auto_record_ = false;
+    if (auto_started_) 
+    {
+        stop_recording();
+        auto_started_ = false;
+    }
+    
+    pre_roll_.clear();
+    pre_roll_.shrink_to_fit();
+    pre_roll_size_ = 0;
+    pre_roll_bytes_ = 0;
+    
+    auto logger = Logger::get();
+    logger->info("Auto-record disabled");
+}
+
+void RecordController::set_auto_record_fps(int fps) 
+{
+    if (!auto_record_ || fps == auto_settings_.fps) 
+    {
+        return;
+    }
+    
+    auto_settings_.fps = fps;
+    
+    // Keep the most recent frames that still fit into the resized ring
+    std::vector<RingFrame> resized(pre_roll_capacity(auto_settings_));
+    const size_t kept = std::min(pre_roll_size_, resized.size());
+    for (size_t i = 0; i < kept; ++i) 
+    {
+        resized[i] = std::move(pre_roll_[(pre_roll_head_ + pre_roll_size_ - kept + i) % pre_roll_.size()]);
+    }
+    pre_roll_ = std::move(resized);
+    pre_roll_head_ = 0;
+    pre_roll_size_ = kept;
+    
+    pre_roll_bytes_ = 0;
+    for (const RingFrame& slot : pre_roll_) 
+    {
+        pre_roll_bytes_ += buffer_bytes(slot.frame);
+    }
+}
+
+void RecordController::set_pre_roll_budget(size_t bytes) 
+{
+    pre_roll_budget_ = bytes;
+}
+
+size_t RecordController::pre_roll_capacity(const AutoRecordSettings& settings) 
+{
+    const long long frames = static_cast<long long>(settings.pre_roll_seconds) * settings.fps;
+    return static_cast<size_t>(std::clamp<long long>(frames, 0, MAX_PRE_ROLL_FRAMES));
+}
+
+bool RecordController::is_auto_record_enabled() const 
+{
+    return auto_record_;
+}
+
+void RecordController::process_frame(const std::string& frame, int activity) 
+{
+    if (!auto_record_) 
+    {
+        write_frame(frame, activity);
+        return;
+    }
+    
+    auto now = std::chrono::steady_clock::now();
+    bool active = activity >= auto_settings_.threshold;
+    
+    if (is_recording_) 
+    {
+        write_frame_at(now, frame, activity);
+        
+        if (active) 
+        {
+            last_activity_ = now;
+        } 
+        else if (auto_started_ && 
+                 now - last_activity_ >= std::chrono::seconds(auto_settings_.cooldown_seconds)) 
+        {
+            auto logger = Logger::get();
+            logger->info("Activity calmed down, stopping auto-recording");
+            stop_recording();
+            auto_started_ = false;
+        }
+        return;
+    }
+    
+    if (active) 
+    {
+        if (start_recording()) 
+        {
+            auto logger = Logger::get();
+            logger->info("Activity detected ({}), auto-recording with {} pre-roll frames", 
+                        activity, pre_roll_size_);
+            
+            auto_started_ = true;
+            last_activity_ = now;
+            flush_pre_roll();
+            write_frame_at(now, frame, activity);
+        }
+        return;
+    }
+    
+    push_pre_roll(now, frame, activity);
+}
+
+void RecordController::push_pre_roll(std::chrono::steady_clock::time_point captured_at, 
+                                     const std::string& frame, int activity) 
+{
+    if (pre_roll_.empty()) 
+    {
+        return;
+    }
+    
+    // A full ring gives up its oldest slot, whose buffer is reused by assign()
+    if (pre_roll_size_ == pre_roll_.size()) 
+    {
+        pre_roll_head_ = (pre_roll_head_ + 1) % pre_roll_.size();
+        --pre_roll_size_;
+    }
+    RingFrame& slot = pre_roll_[(pre_roll_head_ + pre_roll_size_) % pre_roll_.size()];
+    pre_roll_bytes_ -= buffer_bytes(slot.frame);
+    if (slot.frame.capacity() < frame.size()) 
+    {
+        // An exact allocation instead of the string's geometric growth
+        std::string().swap(slot.frame);
+    }
+    
+    // Free the oldest frames' buffers until the new frame fits the budget
+    const size_t needed = std::max(buffer_bytes(slot.frame), frame.size());
+    while (pre_roll_size_ > 0 && pre_roll_bytes_ + needed > pre_roll_budget_) 
+    {
+        RingFrame& oldest = pre_roll_[pre_roll_head_];
+        pre_roll_bytes_ -= buffer_bytes(oldest.frame);
+        std::string().swap(oldest.frame);
+        pre_roll_head_ = (pre_roll_head_ + 1) % pre_roll_.size();
+        --pre_roll_size_;
+    }
+    if (pre_roll_bytes_ + needed > pre_roll_budget_) 
+    {
+        // A single frame larger than the budget is not kept
+        std::string().swap(slot.frame);
+        return;
+    }
+    
+    slot.captured_at = captured_at;
+    slot.frame.assign(frame);
+    slot.activity = activity;
+    pre_roll_bytes_ += buffer_bytes(slot.frame);
+    ++pre_roll_size_;
+}
+
+size_t RecordController::buffer_bytes(const std::string& frame) 
+{
+    // Short strings live inside the slot itself
+    return frame.capacity() > std::string().capacity() ? frame.capacity() : 0;
+}
+
+void RecordController::release_pre_roll_buffers() 
+{
+    for (RingFrame& slot : pre_roll_) 
+    {
+        std::string().swap(slot.frame);
+    }
+    pre_roll_bytes_ = 0;
+}
+
+void RecordController::flush_pre_roll() 
+{
+    if (pre_roll_size_ == 0) 
+    {
+        return;
+    }
+    
+    // Timestamps in the file start from the oldest buffered frame
+    start_time_ = pre_roll_[pre_roll_head_].captured_at;
+    
+    for (size_t i = 0; i < pre_roll_size_; ++i) 
+    {
+        const RingFrame& slot = pre_roll_[(pre_roll_head_ + i) % pre_roll_.size()];
+        write_frame_at(slot.captured_at, slot.frame, slot.activity);
+    }
+    
+    // Slots outside the live range must not hold buffers, otherwise they
+    // would count against the budget without ever being freed
+    pre_roll_head_ = 0;
+    pre_roll_size_ = 0;
+    release_pre_roll_buffers();
+}
+
+void RecordController::write_index() const 
+{
+    if (!write_recording_index(index_filename(filename_), index_)) 
+    {
+        auto logger = Logger::get();
+        logger->error("Failed to write activity index for: {}", filename_);
+    }
+}
+
+void RecordController::sample_preview_frame(long long timestamp, const std::string& frame) 
+{
+    // Keep every stride-th frame; once twice the needed number of samples is
+    // collected, drop every other one and double the stride. This keeps the
+    // samples evenly spaced without knowing the recording length in advance.
+    if (frame_count_ % preview_stride_ != 0) 
+    {
+        return;
+    }
+    
+    preview_samples_.push_back({timestamp, frame});
+    
+    if (preview_samples_.size() >= 2 * (PREVIEW_SNAPSHOTS + 1)) 
+    {
+        size_t kept = 1;
+        for (size_t i = 2; i < preview_samples_.size(); i += 2) 
+        {
+            preview_samples_[kept++] = std::move(preview_samples_[i]);
+        }
+        preview_samples_.resize(kept);
+        preview_stride_ *= 2;
+    }
+}
+
+RecordController::RecordingPreview RecordController::finish_preview() const 
+{
+    RecordingPreview preview;
+    preview.filename = std::filesystem::path(filename_).filename().string();
+    preview.frame_count = frame_count_;
+    
+    if (frame_count_ == 0) 
+    {
+        return preview;
+    }
+    
+    // The first sample is always the first frame of the recording; the last
+    // frame is appended unless the stride happened to land on it
+    const bool last_sampled = (frame_count_ - 1) % preview_stride_ == 0;
+    const size_t sample_count = preview_samples_.size() + (last_sampled ? 0 : 1);
+    
+    for (size_t position : pick_evenly(sample_count, PREVIEW_SNAPSHOTS + 1)) 
+    {
+        if (position < preview_samples_.size()) 
+        {
+            preview.frames.push_back(preview_samples_[position]);
+            continue;
+        }
+        
+        // The last frame is not kept in memory; the file is already complete
+        std::ifstream file(filename_, std::ios::in | std::ios::binary);
+        PreviewFrame frame;
+        if (file.is_open() && !index_.empty() && read_frame_at(file, index_.back().offset, frame)) 
+        {
+            preview.frames.push_back(std::move(frame));
+        }
+    }
+    return preview;
+}
+
+std::vector<size_t> RecordController::sampled_frames(size_t frame_count) 
+{
+    // Same decisions as sample_preview_frame, on frame numbers only
+    std::vector<size_t> sampled;
+    size_t stride = 1;
+    for (size_t i = 0; i < frame_count; ++i) 
+    {
+        if (i % stride != 0) 
+        {
+            continue;
+        }
+        
+        sampled.push_back(i);
+        if (sampled.size() >= 2 * (PREVIEW_SNAPSHOTS + 1)) 
+        {
+            size_t kept = 1;
+            for (size_t j = 2; j < sampled.size(); j += 2) 
+            {
+                sampled[kept++] = sampled[j];
+            }
+            sampled.resize(kept);
+            stride *= 2;
+        }
+    }
+    
+    if (frame_count > 0 && sampled.back() != frame_count - 1) 
+    {
+        sampled.push_back(frame_count - 1);
     }
+    return sampled;
+}
+
+std::vector<size_t> RecordController::pick_evenly(size_t size, size_t count) 
+{
+    std::vector<size_t> picked;
+    if (size <= count) 
+    {
+        for (size_t i = 0; i < size; ++i) 
+        {
+            picked.push_back(i);
+        }
+        return picked;
+    }
+    
+    picked.reserve(count);
+    for (size_t i = 0; i < count; ++i) 
+    {
+        picked.push_back(i * (size - 1) / (count - 1));
+    }
+    return picked;
+}
+
+bool RecordController::read_frame_at(std::istream& file, std::streamoff offset, PreviewFrame& frame) 
+{
+    std::string line;
+    file.seekg(offset);
+    if (!std::getline(file, line) || line.rfind("frame:", 0) != 0) 
+    {
+        return false;
+    }
+    
+    size_t colon1 = line.find(':');
+    size_t colon2 = line.find(':', colon1 + 1);
+    if (colon2 == std::string::npos) 
+    {
+        return false;
+    }
+    size_t length = std::stoul(line.substr(colon2 + 1));
+    
+    frame.timestamp = std::stoll(line.substr(colon1 + 1, colon2 - colon1 - 1));
+    frame.frame.resize(length);
+    file.read(&frame.frame[0], length);
+    return static_cast<bool>(file);
+}
+
+bool RecordController::build_preview_from_file(const std::string& path, RecordingPreview& preview) 
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open()) 
+    {
+        return false;
+    }
+    
+    std::string line;
+    std::getline(file, line);
+    if (line != "ASCII_STREAM_RECORD") 
+    {
+        return false;
+    }
+    
+    // Skip to frames section
+    while (std::getline(file, line) && line != "frames:") 
+    {
+    }
+    
+    // First pass: frame offsets only, frame data is skipped
+    std::vector<std::streampos> offsets;
+    while (true) 
+    {
+        std::streampos pos = file.tellg();
+        if (!std::getline(file, line) || line.rfind("frame:", 0) != 0) 
+        {
+            break;
+        }
+        
+        size_t colon2 = line.find(':', 6);
+        if (colon2 == std::string::npos) 
+        {
+            break;
+        }
+        
+        offsets.push_back(pos);
+        file.seekg(std::stoull(line.substr(colon2 + 1)) + 1, std::ios::cur);
+    }
+    
+    preview.filename = std::filesystem::path(path).filename().string();
+    preview.frame_count = offsets.size();
+    preview.frames.clear();
+    
+    // Second pass: read only the frames the live preview would have picked
+    file.clear();
+    const std::vector<size_t> sampled = sampled_frames(offsets.size());
+    for (size_t position : pick_evenly(sampled.size(), PREVIEW_SNAPSHOTS + 1)) 
+    {
+        PreviewFrame frame;
+        if (!read_frame_at(file, offsets[sampled[position]], frame)) 
+        {
+            return false;
+        }
+        preview.frames.push_back(std::move(frame));
+    }
+    
+    return true;
+}
+
+RecordController::PreviewStatus RecordController::get_preview(const std::string& filename, 
+                                                              RecordingPreview& preview) 
+{
+    {
+        std::lock_guard<std::mutex> lock(catalog_mutex_);
+        auto it = preview_catalog_.find(filename);
+        if (it != preview_catalog_.end()) 
+        {
+            preview_lru_.splice(preview_lru_.begin(), preview_lru_, it->second);
+            preview = *it->second;
+            return PreviewStatus::Ready;
+        }
+        if (preview_building_.count(filename)) 
+        {
+            return PreviewStatus::Pending;
+        }
+        if (preview_failed_.count(filename)) 
+        {
+            return PreviewStatus::Missing;
+        }
+    }
+    
+    // The recording in progress has no preview yet
+    if (is_recording_ && std::filesystem::path(filename_).filename() == filename) 
+    {
+        return PreviewStatus::Missing;
+    }
+    
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file("recordings/" + filename, ec)) 
+    {
+        return PreviewStatus::Missing;
+    }
+    
+    build_preview_async(filename);
+    return PreviewStatus::Pending;
+}
+
+void RecordController::build_preview_async(const std::string& filename) 
+{
+    {
+        std::lock_guard<std::mutex> lock(catalog_mutex_);
+        if (!preview_building_.insert(filename).second) 
+        {
+            return;
+        }
+    }
+    
+    // Parsing reads the whole frame index of the file, so it is kept off
+    // the thread serving the HTTP request
+    boost::asio::post(preview_builder_, 
+        [this, filename] {
+            RecordingPreview built;
+            bool ok = false;
+            try 
+            {
+                ok = build_preview_from_file("recordings/" + filename, built);
+            } 
+            catch (const std::exception& e) 
+            {
+                auto logger = Logger::get();
+                logger->error("Failed to build preview for {}: {}", filename, e.what());
+            }
+            
+            std::lock_guard<std::mutex> lock(catalog_mutex_);
+            // remove_preview while parsing: the recording is gone
+            if (preview_building_.erase(filename) == 0) 
+            {
+                return;
+            }
+            if (ok) 
+            {
+                cache_preview(std::move(built));
+            }
+            else 
+            {
+                preview_failed_.insert(filename);
+            }
+        });
+}
+
+void RecordController::cache_preview(RecordingPreview preview) 
+{
+    auto it = preview_catalog_.find(preview.filename);
+    if (it != preview_catalog_.end()) 
+    {
+        preview_bytes_ -= preview_bytes(*it->second);
+        preview_lru_.erase(it->second);
+        preview_catalog_.erase(it);
+    }
+    
+    preview_bytes_ += preview_bytes(preview);
+    preview_lru_.push_front(std::move(preview));
+    preview_catalog_[preview_lru_.front().filename] = preview_lru_.begin();
+    
+    // The newest preview stays even if it alone exceeds the limit
+    while (preview_bytes_ > preview_cache_limit_ && preview_lru_.size() > 1) 
+    {
+        const RecordingPreview& oldest = preview_lru_.back();
+        preview_bytes_ -= preview_bytes(oldest);
+        preview_catalog_.erase(oldest.filename);
+        preview_lru_.pop_back();
+    }
+}
+
+size_t RecordController::preview_bytes(const RecordingPreview& preview) 
+{
+    size_t bytes = sizeof(RecordingPreview) + preview.filename.size();
+    for (const auto& frame : preview.frames) 
+    {
+        bytes += sizeof(PreviewFrame) + frame.frame.size();
+    }
+    return bytes;
+}
+
+void RecordController::remove_preview(const std::string& filename) 
+{
+    std::lock_guard<std::mutex> lock(catalog_mutex_);
+    auto it = preview_catalog_.find(filename);
+    if (it != preview_catalog_.end()) 
+    {
+        preview_bytes_ -= preview_bytes(*it->second);
+        preview_lru_.erase(it->second);
+        preview_catalog_.erase(it);
+    }
+    preview_building_.erase(filename);
+    preview_failed_.erase(filename);
+}
+
+void RecordController::set_preview_cache_limit(size_t bytes) 
+{
+    std::lock_guard<std::mutex> lock(catalog_mutex_);
+    preview_cache_limit_ = bytes;
+    while (preview_bytes_ > preview_cache_limit_ && !preview_lru_.empty()) 
+    {
+        preview_bytes_ -= preview_bytes(preview_lru_.back());
+        preview_catalog_.erase(preview_lru_.back().filename);
+        preview_lru_.pop_back();
+    }
+}
+
+size_t RecordController::preview_cache_bytes() const 
+{
+    std::lock_guard<std::mutex> lock(catalog_mutex_);
+    return preview_bytes_;
 }
 
 bool RecordController::is_recording() const 
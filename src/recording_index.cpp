@@ -0,0 +1,76 @@
+#include "recording_index.hpp"
+
+#include <fstream>
+
+std::string index_filename(const std::string& recording) 
+{
+    return recording + ".idx";
+}
+
+bool write_recording_index(const std::string& path, const std::vector<IndexEntry>& entries) 
+{
+    std::ofstream index_file(path, std::ios::out | std::ios::binary);
+    if (!index_file.is_open()) 
+    {
+        return false;
+    }
+    
+    // One line per frame: "timestamp:offset:activity"
+    index_file << "ASCII_STREAM_INDEX\n";
+    index_file << "version:1.0\n";
+    index_file << "entries:" << entries.size() << "\n";
+    for (const auto& entry : entries) 
+    {
+        index_file << entry.timestamp << ":" << entry.offset << ":" << entry.activity << "\n";
+    }
+    return static_cast<bool>(index_file);
+}
+
+bool read_recording_index(const std::string& path, std::vector<IndexEntry>& entries) 
+{
+    entries.clear();
+    
+    std::ifstream index_file(path, std::ios::in | std::ios::binary);
+    if (!index_file.is_open()) 
+    {
+        return false;
+    }
+    
+    std::string line;
+    std::getline(index_file, line);
+    if (line != "ASCII_STREAM_INDEX") 
+    {
+        return false;
+    }
+    
+    // Skip metadata up to the entries count
+    while (std::getline(index_file, line) && line.rfind("entries:", 0) != 0) 
+    {
+    }
+    
+    if (!index_file) 
+    {
+        return false;
+    }
+    
+    entries.reserve(std::stoul(line.substr(8)));
+    
+    // Entry format: "timestamp:offset:activity"
+    while (std::getline(index_file, line)) 
+    {
+        size_t colon1 = line.find(':');
+        size_t colon2 = line.find(':', colon1 + 1);
+        if (colon1 == std::string::npos || colon2 == std::string::npos) 
+        {
+            break;
+        }
+        
+        IndexEntry entry;
+        entry.timestamp = std::stoll(line.substr(0, colon1));
+        entry.offset = std::stoll(line.substr(colon1 + 1, colon2 - colon1 - 1));
+        entry.activity = std::stoi(line.substr(colon2 + 1));
+        entries.push_back(entry);
+    }
+    
+    return !entries.empty();
+}
\ No newline at end of file
@@ -0,0 +1,290 @@
+#include "relay_client.hpp"
+#include "stream_controller.hpp"
+#include "logger.hpp"
+#include "metrics.hpp"
+
+#include <boost/asio/as_tuple.hpp>
+#include <boost/beast.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/version.hpp>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace websocket = beast::websocket;
+namespace ssl = net::ssl;
+using tcp = net::ip::tcp;
+
+namespace {
+
+using WsStream = websocket::stream<ssl::stream<beast::tcp_stream>>;
+
+struct RelayMetrics 
+{
+    metrics::Counter& frames = metrics::Registry::get().counter(
+        "ascii_relay_frames_total", "Frames received from the upstream server");
+    metrics::Counter& bytes = metrics::Registry::get().counter(
+        "ascii_relay_received_bytes_total", "Payload bytes received from the upstream server");
+    metrics::Counter& reconnects = metrics::Registry::get().counter(
+        "ascii_relay_reconnects_total", "Upstream connection attempts after a failure");
+    metrics::Gauge& connected = metrics::Registry::get().gauge(
+        "ascii_relay_upstream_connected", "1 while the relay is subscribed to the upstream server");
+};
+
+RelayMetrics& relay_metrics() 
+{
+    static RelayMetrics instance;
+    return instance;
+}
+
+constexpr std::chrono::seconds CONNECT_TIMEOUT{10};
+
+// Часть ответов origin отправлял вместе с завершающим нулем строки
+std::string_view strip_trailing_nuls(std::string_view text) 
+{
+    while (!text.empty() && text.back() == '\0') 
+    {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+} // namespace
+
+RelayClient::RelayClient(
+    net::io_context& ioc,
+    std::string upstream,
+    std::shared_ptr<StreamController> controller,
+    const std::string& ca_file,
+    bool insecure_localhost
+)
+    : strand_(net::make_strand(ioc)),
+      ssl_ctx_(ssl::context::tls_client),
+      controller_(std::move(controller)),
+      frame_pool_(FRAME_POOL_SIZE),
+      retry_timer_(strand_) 
+{
+    std::tie(host_, port_) = parse_upstream(upstream);
+
+    // Без проверки сертификата ключ API из /api и кадры получит любой,
+    // кто перехватит соединение, поэтому отключить ее можно только для
+    // origin на той же машине
+    if (insecure_localhost) 
+    {
+        if (!is_loopback_host(host_)) 
+        {
+            throw std::invalid_argument(
+                "relay_insecure_localhost is allowed only for a loopback upstream, got " + host_);
+        }
+        Logger::get()->warn("Upstream certificate verification is disabled for {}", host_);
+        ssl_ctx_.set_verify_mode(ssl::verify_none);
+        return;
+    }
+
+    // Самоподписанный сертификат origin передается как CA в relay_ca_file
+    if (ca_file.empty()) 
+    {
+        ssl_ctx_.set_default_verify_paths();
+    } 
+    else 
+    {
+        ssl_ctx_.load_verify_file(ca_file);
+    }
+    ssl_ctx_.set_verify_mode(ssl::verify_peer);
+#if BOOST_VERSION >= 107300
+    ssl_ctx_.set_verify_callback(ssl::host_name_verification(host_));
+#else
+    ssl_ctx_.set_verify_callback(ssl::rfc2818_verification(host_));
+#endif
+}
+
+std::pair<std::string, std::string> RelayClient::parse_upstream(const std::string& upstream) 
+{
+    const size_t pos = upstream.rfind(':');
+    if (pos == std::string::npos) 
+    {
+        return {upstream, "8080"};
+    }
+    return {upstream.substr(0, pos), upstream.substr(pos + 1)};
+}
+
+bool RelayClient::is_loopback_host(const std::string& host) 
+{
+    if (host == "localhost") 
+    {
+        return true;
+    }
+    boost::system::error_code ec;
+    const auto address = net::ip::make_address(host, ec);
+    return !ec && address.is_loopback();
+}
+
+void RelayClient::run() 
+{
+    net::co_spawn(strand_,
+        [self = shared_from_this()] { return self->run_loop(); },
+        net::detached);
+}
+
+void RelayClient::stop() 
+{
+    stop_requested_ = true;
+    net::post(strand_, [self = shared_from_this()] { self->retry_timer_.cancel(); });
+}
+
+net::awaitable<void> RelayClient::run_loop() 
+{
+    auto logger = Logger::get();
+    auto retry_delay = MIN_RETRY_DELAY;
+
+    while (!stop_requested_) 
+    {
+        try 
+        {
+            co_await relay_frames();
+        }
+        catch (const std::exception& e) 
+        {
+            logger->warn("Upstream {}:{} unavailable: {}", host_, port_, e.what());
+        }
+
+        if (connected_.exchange(false)) 
+        {
+            relay_metrics().connected.set(0);
+            controller_->set_upstream_active(false);
+            retry_delay = MIN_RETRY_DELAY;
+        }
+
+        if (stop_requested_) 
+        {
+            break;
+        }
+
+        // Экспоненциальная пауза, чтобы ретрансляторы не засыпали
+        // перезапускающийся origin подключениями
+        logger->info("Reconnecting to upstream in {} s", retry_delay.count());
+        relay_metrics().reconnects.inc();
+        retry_timer_.expires_after(retry_delay);
+        co_await retry_timer_.async_wait(net::as_tuple(net::use_awaitable));
+        retry_delay = std::min(retry_delay * 2, MAX_RETRY_DELAY);
+    }
+}
+
+// Ключ API origin отдает по GET /api, как и браузеру
+net::awaitable<std::string> RelayClient::fetch_api_key() 
+{
+    auto executor = co_await net::this_coro::executor;
+    tcp::resolver resolver(executor);
+    ssl::stream<beast::tcp_stream> stream(executor, ssl_ctx_);
+
+    auto endpoints = co_await resolver.async_resolve(host_, port_, net::use_awaitable);
+    beast::get_lowest_layer(stream).expires_after(CONNECT_TIMEOUT);
+    co_await beast::get_lowest_layer(stream).async_connect(endpoints, net::use_awaitable);
+    SSL_set_tlsext_host_name(stream.native_handle(), host_.c_str());
+    co_await stream.async_handshake(ssl::stream_base::client, net::use_awaitable);
+
+    http::request<http::empty_body> req{http::verb::get, "/api", 11};
+    req.set(http::field::host, host_);
+    co_await http::async_write(stream, req, net::use_awaitable);
+
+    beast::flat_buffer buffer;
+    http::response<http::string_body> res;
+    co_await http::async_read(stream, buffer, res, net::use_awaitable);
+
+    co_await stream.async_shutdown(net::as_tuple(net::use_awaitable));
+
+    co_return nlohmann::json::parse(res.body()).at("api_key").get<std::string>();
+}
+
+net::awaitable<void> RelayClient::relay_frames() 
+{
+    auto logger = Logger::get();
+    const std::string api_key = co_await fetch_api_key();
+
+    auto executor = co_await net::this_coro::executor;
+    WsStream ws(executor, ssl_ctx_);
+
+    tcp::resolver resolver(executor);
+    auto endpoints = co_await resolver.async_resolve(host_, port_, net::use_awaitable);
+    beast::get_lowest_layer(ws).expires_after(CONNECT_TIMEOUT);
+    co_await beast::get_lowest_layer(ws).async_connect(endpoints, net::use_awaitable);
+    SSL_set_tlsext_host_name(ws.next_layer().native_handle(), host_.c_str());
+    co_await ws.next_layer().async_handshake(ssl::stream_base::client, net::use_awaitable);
+
+    beast::get_lowest_layer(ws).expires_never();
+    ws.set_option(websocket::stream_base::timeout::suggested(beast::role_type::client));
+    co_await ws.async_handshake(host_ + ":" + port_, "/stream", net::use_awaitable);
+
+    // Ретранслятор для origin - обычный зритель: трансляцией управляет
+    // controller, подключенный к origin
+    nlohmann::json auth;
+    auth["type"] = "auth";
+    auth["api_key"] = api_key;
+    auth["role"] = "viewer";
+    const std::string auth_message = auth.dump();
+    ws.text(true);
+    co_await ws.async_write(net::buffer(auth_message), net::use_awaitable);
+
+    beast::flat_buffer buffer;
+    for (;;) 
+    {
+        buffer.clear();
+        co_await ws.async_read(buffer, net::use_awaitable);
+        if (ws.got_binary()) 
+        {
+            continue;
+        }
+
+        const auto data = buffer.cdata();
+        const std::string_view text = strip_trailing_nuls(
+            std::string_view(static_cast<const char*>(data.data()), data.size()));
+
+        if (text == "AUTH_VIEWER_SUCCESS") 
+        {
+            logger->info("Subscribed to upstream {}:{}", host_, port_);
+            connected_ = true;
+            relay_metrics().connected.set(1);
+            continue;
+        }
+        // Подключение еще не значит, что на исходном сервере идет трансляция:
+        // о ней он сообщает после авторизации и при каждом запуске и остановке
+        if (text == "STREAM_ACTIVE" || text == "STREAM_INACTIVE") 
+        {
+            logger->info("Upstream stream {}", text == "STREAM_ACTIVE" ? "started" : "stopped");
+            controller_->set_upstream_active(text == "STREAM_ACTIVE");
+            continue;
+        }
+        // Исключение возвращает в run_loop, который переподключается с паузой
+        if (text == "AUTH_FAILED") 
+        {
+            throw std::runtime_error("upstream rejected the API key");
+        }
+        if (text == "AUTH_LOCKED") 
+        {
+            throw std::runtime_error("upstream locked out this address after failed auth attempts");
+        }
+        if (text == "STREAM_FULL") 
+        {
+            throw std::runtime_error("upstream reached its viewer limit");
+        }
+
+        // Кадры отличаются от служебных сообщений переводами строк,
+        // heartbeat пересылается как есть
+        if (text.find('\n') == std::string_view::npos && text != "HEARTBEAT") 
+        {
+            SPDLOG_LOGGER_DEBUG(logger, "Upstream status: {}", text);
+            continue;
+        }
+
+        // Буфер из пула сохраняет емкость строки, поэтому в установившемся
+        // режиме копирование кадра обходится без выделения памяти
+        auto frame = frame_pool_.acquire();
+        frame->ascii.assign(text);
+        relay_metrics().frames.inc();
+        relay_metrics().bytes.inc(text.size());
+
+        co_await controller_->relay_frame(std::shared_ptr<const std::string>(frame, &frame->ascii));
+    }
+}
\ No newline at end of file
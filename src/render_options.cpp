@@ -0,0 +1,37 @@
+#include "render_options.hpp"
+
+#include <stdexcept>
+
+RenderOptions::Tone RenderOptions::parse_tone(std::string_view name) 
+{
+    if (name == "linear") 
+    {
+        return Tone::Linear;
+    }
+    if (name == "gamma") 
+    {
+        return Tone::Gamma;
+    }
+    if (name == "equalize") 
+    {
+        return Tone::Equalize;
+    }
+    throw std::invalid_argument("Unknown tone mapping: " + std::string(name));
+}
+
+RenderOptions::Dither RenderOptions::parse_dither(std::string_view name) 
+{
+    if (name == "none") 
+    {
+        return Dither::None;
+    }
+    if (name == "ordered") 
+    {
+        return Dither::Ordered;
+    }
+    if (name == "floyd_steinberg") 
+    {
+        return Dither::FloydSteinberg;
+    }
+    throw std::invalid_argument("Unknown dithering mode: " + std::string(name));
+}
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include "api_key_manager.hpp"
 #include "vk_tunnel.hpp"
 
+#include <filesystem>
+
 Server::Server(
     net::io_context& ioc,
     net::ssl::context&& ctx,
@@ -16,7 +18,8 @@ Server::Server(
 )
     : ioc_(ioc), acceptor_(ioc), doc_root_(std::move(doc_root)),
       ssl_ctx_(std::move(ctx)), video_source_(std::move(video_source)),
-      ascii_converter_(std::move(ascii_converter))
+      ascii_converter_(std::move(ascii_converter)),
+      admission_(std::make_shared<AdmissionController>()) 
 {
     // Настройка SSL контекста
     ssl_ctx_.set_options(
@@ -61,6 +64,12 @@ Server::~Server()
     {
         VKTunnel::cleanup();
     }
+    
+    if (!local_socket_path_.empty()) 
+    {
+        std::error_code ec;
+        std::filesystem::remove(local_socket_path_, ec);
+    }
 }
 
 void Server::setup_cloud_tunnel() 
@@ -81,6 +90,11 @@ void Server::setup_cloud_tunnel()
     logger->warn("No VK tunnel available. Direct connection only.");
 }
 
+void Server::set_admission_limits(const AdmissionLimits& limits) 
+{
+    admission_ = std::make_shared<AdmissionController>(limits);
+}
+
 void Server::run() 
 {
     do_accept();
@@ -94,15 +108,25 @@ void Server::do_accept()
             auto logger = Logger::get();
             if(!ec) 
             {
-                logger->info("New connection from: {}", 
-                    socket.remote_endpoint().address().to_string());
+                const std::string address = peer_address(socket);
                 
-                // Создаем HTTP сессию с socket и SSL контекстом
-                std::make_shared<HttpSession>(
-                    std::move(socket), 
-                    self->ssl_ctx_,
-                    self,
-                    self->doc_root_)->run();
+                // Отказ до TLS-рукопожатия: сокет просто закрывается
+                auto connection = self->admission_->admit_connection(address);
+                if (!connection) 
+                {
+                    SPDLOG_LOGGER_DEBUG(logger, "Connection from {} refused by admission control", address);
+                } 
+                else 
+                {
+                    logger->info("New connection from: {}", address);
+                    
+                    // Создаем HTTP сессию с socket и SSL контекстом
+                    std::make_shared<HttpSession<TlsStream>>(
+                        TlsStream(std::move(socket), self->ssl_ctx_),
+                        self,
+                        self->doc_root_,
+                        std::move(connection))->run();
+                }
             }
             else 
             {
@@ -112,6 +136,70 @@ void Server::do_accept()
         });
 }
 
+void Server::listen_plain(const std::string& address) 
+{
+    auto logger = Logger::get();
+    
+    if (address.rfind("unix:", 0) == 0) 
+    {
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+        const std::string path = address.substr(5);
+        
+        // Файл сокета от прошлого запуска мешает bind
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        
+        local_acceptor_.emplace(ioc_, net::local::stream_protocol::endpoint(path));
+        local_socket_path_ = path;
+        plain_stream_url_ = "ws+unix:" + path + ":/stream";
+        logger->info("Plain HTTP/WebSocket listener on unix socket {}", path);
+        
+        do_accept_plain<HttpSession<LocalStream>>(*local_acceptor_);
+        return;
+#else
+        throw std::runtime_error("Unix domain sockets are not supported on this platform");
+#endif
+    }
+    
+    const size_t pos = address.rfind(':');
+    if (pos == std::string::npos) 
+    {
+        throw std::invalid_argument("Plain listener address must be host:port or unix:/path, got " + address);
+    }
+    
+    const tcp::endpoint endpoint(
+        net::ip::make_address(address.substr(0, pos)), 
+        static_cast<unsigned short>(std::stoi(address.substr(pos + 1))));
+    plain_acceptor_.emplace(ioc_, endpoint);
+    plain_stream_url_ = "ws://" + address + "/stream";
+    logger->info("Plain HTTP/WebSocket listener on {}", address);
+    
+    do_accept_plain<HttpSession<PlainStream>>(*plain_acceptor_);
+}
+
+template <class Session, class Acceptor>
+void Server::do_accept_plain(Acceptor& acceptor) 
+{
+    acceptor.async_accept(
+        net::make_strand(ioc_),
+        [self = shared_from_this(), &acceptor](boost::system::error_code ec, 
+                                               typename Acceptor::protocol_type::socket socket) {
+            if (!ec) 
+            {
+                auto connection = self->admission_->admit_connection(peer_address(socket));
+                if (connection) 
+                {
+                    std::make_shared<Session>(std::move(socket), self, self->doc_root_, std::move(connection))->run();
+                }
+            } 
+            else 
+            {
+                Logger::get()->error("Plain accept error: {}", ec.message());
+            }
+            self->do_accept_plain<Session>(acceptor);
+        });
+}
+
 std::shared_ptr<Server> make_server(
     net::io_context& ioc, 
     tcp::endpoint endpoint, 
@@ -0,0 +1,62 @@
+#include "server_config.hpp"
+#include "logger.hpp"
+
+#include <nlohmann/json.hpp>
+#include <fstream>
+
+ServerConfig load_config(const std::string& path) 
+{
+    auto logger = Logger::get();
+    ServerConfig config;
+
+    std::ifstream file(path);
+    if (!file.is_open()) 
+    {
+        logger->info("Config file {} not found, using defaults", path);
+        return config;
+    }
+
+    try 
+    {
+        auto j = nlohmann::json::parse(file);
+
+        config.address = j.value("address", config.address);
+        config.port = j.value("port", config.port);
+        config.doc_root = j.value("doc_root", config.doc_root);
+        config.enable_cloud_tunnel = j.value("enable_cloud_tunnel", config.enable_cloud_tunnel);
+        config.idle_linger_seconds = j.value("idle_linger_seconds", config.idle_linger_seconds);
+        config.release_camera_when_idle = j.value("release_camera_when_idle", config.release_camera_when_idle);
+        config.video_backend = j.value("video_backend", config.video_backend);
+        config.video_file = j.value("video_file", config.video_file);
+        config.synthetic_pattern = j.value("synthetic_pattern", config.synthetic_pattern);
+        config.source_fps = j.value("source_fps", config.source_fps);
+        config.converter = j.value("converter", config.converter);
+        config.ascii_chars = j.value("ascii_chars", config.ascii_chars);
+        config.websocket_compression = j.value("websocket_compression", config.websocket_compression);
+        config.plain_listen = j.value("plain_listen", config.plain_listen);
+        config.relay_upstream = j.value("relay_upstream", config.relay_upstream);
+        config.relay_ca_file = j.value("relay_ca_file", config.relay_ca_file);
+        config.relay_insecure_localhost = j.value("relay_insecure_localhost", config.relay_insecure_localhost);
+        config.frame_bus_name = j.value("frame_bus_name", config.frame_bus_name);
+        config.frame_bus_slots = j.value("frame_bus_slots", config.frame_bus_slots);
+        config.frame_bus_slot_bytes = j.value("frame_bus_slot_bytes", config.frame_bus_slot_bytes);
+        config.max_connections = j.value("max_connections", config.max_connections);
+        config.max_handshakes = j.value("max_handshakes", config.max_handshakes);
+        config.connections_per_ip_per_second = j.value("connections_per_ip_per_second", config.connections_per_ip_per_second);
+        config.connection_burst_per_ip = j.value("connection_burst_per_ip", config.connection_burst_per_ip);
+        config.max_connections_per_ip = j.value("max_connections_per_ip", config.max_connections_per_ip);
+        config.max_auth_failures = j.value("max_auth_failures", config.max_auth_failures);
+        config.auth_lockout_seconds = j.value("auth_lockout_seconds", config.auth_lockout_seconds);
+        config.max_viewers = j.value("max_viewers", config.max_viewers);
+        config.auto_record_pre_roll_mb = j.value("auto_record_pre_roll_mb", config.auto_record_pre_roll_mb);
+
+        logger->info("Loaded config from {}", path);
+    } 
+    catch (const std::exception& e) 
+    {
+        logger->error("Failed to parse config {}: {}", path, e.what());
+        throw;
+    }
+
+    return config;
+}
\ No newline at end of file
@@ -0,0 +1,329 @@
+#include "shm_frame_bus.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FRAME_BUS_POSIX 1
+#endif
+
+namespace frame_bus {
+
+namespace {
+
+constexpr size_t ALIGNMENT = 64;
+
+size_t align_up(size_t value) 
+{
+    return (value + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+size_t slot_index(uint64_t sequence, uint32_t slot_count) 
+{
+    return static_cast<size_t>((sequence - 1) % slot_count);
+}
+
+int64_t to_ns(std::chrono::steady_clock::time_point timestamp) 
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count();
+}
+
+[[noreturn]] void throw_errno(const std::string& what) 
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+} // namespace
+
+#ifdef FRAME_BUS_POSIX
+
+Writer::Writer(std::string name, uint32_t slot_count, size_t slot_capacity)
+    : name_(std::move(name)) 
+{
+    if (slot_count == 0 || slot_capacity == 0) 
+    {
+        throw std::invalid_argument("Frame bus needs at least one non-empty slot");
+    }
+
+    const size_t stride = align_up(sizeof(SlotHeader) + slot_capacity);
+    mapped_size_ = align_up(sizeof(Header)) + stride * slot_count;
+
+    // Сегмент от прошлого запуска мог остаться после аварийного завершения
+    shm_unlink(name_.c_str());
+    fd_ = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd_ < 0) 
+    {
+        throw_errno("shm_open " + name_);
+    }
+
+    if (ftruncate(fd_, static_cast<off_t>(mapped_size_)) != 0) 
+    {
+        const int error = errno;
+        ::close(fd_);
+        shm_unlink(name_.c_str());
+        throw std::system_error(error, std::generic_category(), "ftruncate " + name_);
+    }
+
+    void* base = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (base == MAP_FAILED) 
+    {
+        const int error = errno;
+        ::close(fd_);
+        shm_unlink(name_.c_str());
+        throw std::system_error(error, std::generic_category(), "mmap " + name_);
+    }
+    base_ = static_cast<unsigned char*>(base);
+
+    header_ = new (base_) Header{};
+    header_->version = LAYOUT_VERSION;
+    header_->slot_count = slot_count;
+    header_->slot_capacity = slot_capacity;
+    header_->slot_stride = stride;
+    for (uint32_t i = 0; i < slot_count; ++i) 
+    {
+        new (base_ + align_up(sizeof(Header)) + stride * i) SlotHeader{};
+    }
+
+    // Читатель проверяет magic, поэтому он записывается последним
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->magic = MAGIC;
+}
+
+Writer::~Writer() 
+{
+    if (base_) 
+    {
+        munmap(base_, mapped_size_);
+    }
+    if (fd_ >= 0) 
+    {
+        ::close(fd_);
+        shm_unlink(name_.c_str());
+    }
+}
+
+size_t Writer::slot_capacity() const 
+{
+    return header_->slot_capacity;
+}
+
+bool Writer::publish(std::string_view frame, std::chrono::steady_clock::time_point timestamp) 
+{
+    if (frame.size() > header_->slot_capacity) 
+    {
+        return false;
+    }
+
+    const uint64_t sequence = ++next_sequence_;
+    unsigned char* slot = base_ + align_up(sizeof(Header)) +
+                          header_->slot_stride * slot_index(sequence, header_->slot_count);
+    auto* slot_header = reinterpret_cast<SlotHeader*>(slot);
+
+    // Нечетная версия до любых изменений слота: читатель, попавший
+    // на запись, повторит чтение или перейдет к следующему кадру
+    const uint64_t version = slot_header->version.load(std::memory_order_relaxed);
+    slot_header->version.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot_header->sequence.store(sequence, std::memory_order_relaxed);
+    slot_header->timestamp_ns.store(to_ns(timestamp), std::memory_order_relaxed);
+    slot_header->size.store(frame.size(), std::memory_order_relaxed);
+    std::memcpy(slot + sizeof(SlotHeader), frame.data(), frame.size());
+
+    slot_header->version.store(version + 2, std::memory_order_release);
+    header_->latest.store(sequence, std::memory_order_release);
+    return true;
+}
+
+Reader::Reader(std::string name)
+    : name_(std::move(name)) 
+{
+    fd_ = shm_open(name_.c_str(), O_RDONLY, 0);
+    if (fd_ < 0) 
+    {
+        throw_errno("shm_open " + name_);
+    }
+
+    struct stat info{};
+    if (fstat(fd_, &info) != 0) 
+    {
+        const int error = errno;
+        ::close(fd_);
+        throw std::system_error(error, std::generic_category(), "fstat " + name_);
+    }
+    mapped_size_ = static_cast<size_t>(info.st_size);
+
+    if (mapped_size_ < sizeof(Header)) 
+    {
+        ::close(fd_);
+        throw std::runtime_error("Frame bus " + name_ + " is not initialized");
+    }
+
+    void* base = mmap(nullptr, mapped_size_, PROT_READ, MAP_SHARED, fd_, 0);
+    if (base == MAP_FAILED) 
+    {
+        const int error = errno;
+        ::close(fd_);
+        throw std::system_error(error, std::generic_category(), "mmap " + name_);
+    }
+    base_ = static_cast<const unsigned char*>(base);
+    header_ = reinterpret_cast<const Header*>(base_);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const bool valid = header_->magic == MAGIC &&
+                       header_->version == LAYOUT_VERSION &&
+                       header_->slot_count > 0 &&
+                       align_up(sizeof(Header)) + header_->slot_stride * header_->slot_count <= mapped_size_;
+    if (!valid) 
+    {
+        munmap(const_cast<unsigned char*>(base_), mapped_size_);
+        ::close(fd_);
+        throw std::runtime_error("Frame bus " + name_ + " has an unknown layout");
+    }
+
+    // Новый читатель начинает с текущего кадра, а не с начала кольца
+    const uint64_t latest = latest_sequence();
+    cursor_ = latest > 0 ? latest - 1 : 0;
+}
+
+Reader::~Reader() 
+{
+    munmap(const_cast<unsigned char*>(base_), mapped_size_);
+    ::close(fd_);
+}
+
+#else
+
+Writer::Writer(std::string name, uint32_t, size_t)
+    : name_(std::move(name)) 
+{
+    throw std::runtime_error("Shared-memory frame bus is not supported on this platform");
+}
+
+Writer::~Writer() = default;
+
+size_t Writer::slot_capacity() const 
+{
+    return 0;
+}
+
+bool Writer::publish(std::string_view, std::chrono::steady_clock::time_point) 
+{
+    return false;
+}
+
+Reader::Reader(std::string name)
+    : name_(std::move(name)) 
+{
+    throw std::runtime_error("Shared-memory frame bus is not supported on this platform");
+}
+
+Reader::~Reader() = default;
+
+#endif
+
+uint64_t Reader::latest_sequence() const 
+{
+    return header_->latest.load(std::memory_order_acquire);
+}
+
+uint64_t Reader::oldest_available(uint64_t latest) const 
+{
+    return latest > header_->slot_count ? latest - header_->slot_count + 1 : 1;
+}
+
+bool Reader::read_slot(uint64_t sequence, Frame& frame) const 
+{
+    const unsigned char* slot = base_ + align_up(sizeof(Header)) +
+                                header_->slot_stride * slot_index(sequence, header_->slot_count);
+    const auto* slot_header = reinterpret_cast<const SlotHeader*>(slot);
+
+    for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt) 
+    {
+        const uint64_t before = slot_header->version.load(std::memory_order_acquire);
+        if (before & 1) 
+        {
+            continue;
+        }
+
+        const uint64_t stored = slot_header->sequence.load(std::memory_order_relaxed);
+        const int64_t timestamp = slot_header->timestamp_ns.load(std::memory_order_relaxed);
+        // Размер из недочитанного слота может быть мусорным, копирование
+        // ограничено емкостью слота, а результат отбрасывается ниже
+        const size_t size = std::min<uint64_t>(slot_header->size.load(std::memory_order_relaxed),
+                                               header_->slot_capacity);
+        frame.data.assign(reinterpret_cast<const char*>(slot + sizeof(SlotHeader)), size);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot_header->version.load(std::memory_order_relaxed) != before) 
+        {
+            continue;
+        }
+
+        // Слот уже содержит более новый кадр (или еще не дошел до нужного)
+        if (stored != sequence) 
+        {
+            return false;
+        }
+
+        frame.sequence = sequence;
+        frame.published_at = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(timestamp));
+        return true;
+    }
+    return false;
+}
+
+bool Reader::read_next(Frame& frame) 
+{
+    uint64_t latest = latest_sequence();
+    uint64_t next = cursor_ + 1;
+
+    while (next <= latest) 
+    {
+        const uint64_t oldest = oldest_available(latest);
+        if (next < oldest) 
+        {
+            dropped_ += oldest - next;
+            next = oldest;
+        }
+
+        if (read_slot(next, frame)) 
+        {
+            cursor_ = next;
+            return true;
+        }
+
+        // Писатель обогнал читателя на круг и переписал слот
+        ++dropped_;
+        cursor_ = next++;
+        latest = latest_sequence();
+    }
+    return false;
+}
+
+bool Reader::read_latest(Frame& frame) 
+{
+    for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt) 
+    {
+        const uint64_t latest = latest_sequence();
+        if (latest == 0) 
+        {
+            return false;
+        }
+        if (read_slot(latest, frame)) 
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace frame_bus
\ No newline at end of file
@@ -1,7 +1,44 @@
 #include "stream_controller.hpp"
-#include "websocket_session.hpp"
 #include "logger.hpp"
+#include "frame_activity.hpp"
+#include "metrics.hpp"
 #include <opencv2/opencv.hpp>
+#include <algorithm>
+
+namespace {
+
+struct StreamMetrics 
+{
+    metrics::Histogram& capture_latency = metrics::Registry::get().latency(
+        "ascii_capture_latency_seconds", "Time from frame capture to queuing it for viewers");
+    metrics::Histogram& conversion_time = metrics::Registry::get().latency(
+        "ascii_conversion_seconds", "Time to convert a captured frame to text");
+    metrics::Histogram& broadcast_time = metrics::Registry::get().latency(
+        "ascii_broadcast_seconds", "Time to hand a frame to all viewers");
+    metrics::Counter& frames = metrics::Registry::get().counter(
+        "ascii_frames_total", "Frames converted by the capture loop");
+    metrics::Histogram& stage_convert = metrics::Registry::get().latency(
+        "ascii_stage_convert_seconds", "Frame stage: capture to conversion done");
+    metrics::Histogram& stage_enqueue = metrics::Registry::get().latency(
+        "ascii_stage_enqueue_seconds", "Frame stage: conversion done to broadcast enqueue");
+    metrics::Counter& bus_published = metrics::Registry::get().counter(
+        "ascii_frame_bus_published_total", "Frames published to the shared-memory frame bus");
+    metrics::Counter& bus_oversized = metrics::Registry::get().counter(
+        "ascii_frame_bus_oversized_total", "Frames too large for a frame bus slot");
+};
+
+StreamMetrics& stream_metrics() 
+{
+    static StreamMetrics instance;
+    return instance;
+}
+
+std::chrono::microseconds elapsed_since(std::chrono::steady_clock::time_point from) 
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - from);
+}
+
+} // namespace
 
 StreamController::StreamController(
     net::io_context& ioc,
@@ -11,6 +48,11 @@ StreamController::StreamController(
     : ioc_(ioc),
       strand_(net::make_strand(ioc)),
       frame_timer_(ioc),
+      idle_timer_(ioc),
+      frame_pool_(FRAME_POOL_SIZE),
+      heartbeat_(std::make_shared<const std::string>(HEARTBEAT_MESSAGE)),
+      stream_active_(std::make_shared<const std::string>("STREAM_ACTIVE")),
+      stream_inactive_(std::make_shared<const std::string>("STREAM_INACTIVE")),
       video_source_(std::move(video_source)),
       ascii_converter_(std::move(ascii_converter)),
       record_controller_(std::make_shared<RecordController>(ioc)),
@@ -28,6 +70,14 @@ net::awaitable<void> StreamController::start_streaming(int camera_index, const s
     
     co_await net::dispatch(strand_, net::use_awaitable);
     
+    // Разрешение и частоту задает controller исходного сервера,
+    // локальный controller ретранслятора только смотрит
+    if (relay_mode_) 
+    {
+        logger->info("Relay mode: stream settings are controlled by the upstream server");
+        co_return;
+    }
+    
     if (is_streaming_) 
     {
         logger->warn("Streaming already in progress");
@@ -39,14 +89,18 @@ net::awaitable<void> StreamController::start_streaming(int camera_index, const s
         size_t pos = resolution.find('x');
         frame_width_ = std::stoi(resolution.substr(0, pos));
         frame_height_ = std::stoi(resolution.substr(pos + 1));
-        fps_ = fps;
+        fps_ = std::clamp(fps, 1, MAX_FPS);
+        camera_index_ = camera_index;
+        record_controller_->set_auto_record_fps(fps_);
         
         video_source_->open(camera_index);
         video_source_->set_resolution(frame_width_ * 2, frame_height_ * 2);
-        ascii_converter_->set_ascii_chars("@%#*+=-:. ");
+        ascii_converter_->set_ascii_chars(ascii_chars_);
         
         is_streaming_ = true;
         stop_requested_ = false;
+        is_idle_ = false;
+        no_consumers_since_ = {};
         
         logger->info("Starting streaming from camera {}", camera_index);
         
@@ -54,6 +108,8 @@ net::awaitable<void> StreamController::start_streaming(int camera_index, const s
             [self = shared_from_this()] { return self->capture_loop(); },
             net::detached);
             
+        // Зрители, подключившиеся до запуска, получили STREAM_INACTIVE
+        broadcast_status(true);
     } 
     catch (const std::exception& e) 
     {
@@ -77,6 +133,7 @@ net::awaitable<void> StreamController::stop_streaming()
     stop_requested_ = true;
     capture_cancel_.emit(net::cancellation_type::all);
     frame_timer_.cancel();
+    idle_timer_.cancel();
     
     while (is_streaming_) 
     {
@@ -90,24 +147,45 @@ net::awaitable<void> StreamController::stop_streaming()
 
 bool StreamController::is_streaming() const 
 {
-    return is_streaming_.load();
+    return is_streaming_.load() || upstream_active_.load();
 }
 
-void StreamController::add_viewer(std::shared_ptr<WebSocketSession> viewer) 
+void StreamController::add_viewer(std::shared_ptr<IFrameViewer> viewer) 
 {
     net::post(strand_, 
         [self = shared_from_this(), viewer] {
             self->viewers_.push_back(viewer);
+            self->wake_up();
+            
+            // Кадр может долго не меняться, поэтому новый зритель сразу получает последний
+            if (self->last_frame_) 
+            {
+                viewer->send_frame(std::shared_ptr<const std::string>(
+                    self->last_frame_, &self->last_frame_->ascii));
+            } 
+            else if (self->last_relayed_) 
+            {
+                viewer->send_frame(self->last_relayed_);
+            }
         });
 }
 
-net::awaitable<void> StreamController::remove_viewer(std::shared_ptr<WebSocketSession> viewer) 
+void StreamController::add_controller(std::shared_ptr<IFrameViewer> controller) 
+{
+    net::post(strand_, 
+        [self = shared_from_this(), controller] {
+            self->controller_viewer_ = controller;
+        });
+    add_viewer(std::move(controller));
+}
+
+net::awaitable<void> StreamController::remove_viewer(std::shared_ptr<IFrameViewer> viewer) 
 {
     co_await net::dispatch(strand_, net::use_awaitable);
     
     viewers_.erase(
         std::remove_if(viewers_.begin(), viewers_.end(),
-            [&viewer](const std::weak_ptr<WebSocketSession>& wp) {
+            [&viewer](const std::weak_ptr<IFrameViewer>& wp) {
                 return wp.expired() || wp.lock() == viewer;
             }),
         viewers_.end());
@@ -119,7 +197,7 @@ net::awaitable<void> StreamController::remove_viewer_by_id(uint64_t session_id)
     
     viewers_.erase(
         std::remove_if(viewers_.begin(), viewers_.end(),
-            [session_id](const std::weak_ptr<WebSocketSession>& wp) {
+            [session_id](const std::weak_ptr<IFrameViewer>& wp) {
                 if (auto viewer = wp.lock()) {
                     return viewer->session_id() == session_id;
                 }
@@ -136,23 +214,78 @@ net::awaitable<void> StreamController::capture_loop()
     {
         while (!stop_requested_ && is_streaming_) 
         {
-            co_await net::steady_timer(ioc_, std::chrono::milliseconds(1000 / fps_)).async_wait(as_tuple(net::use_awaitable));
+            if (has_consumers()) 
+            {
+                no_consumers_since_ = {};
+            } 
+            else if (no_consumers_since_ == std::chrono::steady_clock::time_point{}) 
+            {
+                no_consumers_since_ = std::chrono::steady_clock::now();
+            } 
+            else if (std::chrono::steady_clock::now() - no_consumers_since_ >= idle_linger_) 
+            {
+                co_await wait_for_consumers();
+                continue;
+            }
+            
+            frame_timer_.expires_after(std::chrono::milliseconds(1000 / fps_));
+            co_await frame_timer_.async_wait(as_tuple(net::use_awaitable));
 
-            cv::Mat frame = video_source_->capture_frame();
-            if (frame.empty()) 
+            // Буферы кадра берутся из пула и после отправки всем зрителям
+            // возвращаются в него, поэтому в установившемся режиме память не выделяется
+            auto buffer = frame_pool_.acquire();
+            video_source_->capture_frame(buffer->image);
+            if (buffer->image.empty()) 
             {
-                logger->warn("Empty frame captured");
+                LOG_WARN_RATE_LIMITED("Empty frame captured");
                 continue;
             }
             
-            std::string ascii_frame = ascii_converter_->convert(frame, frame_width_, frame_height_);
+            // Источник без собственной отметки времени: считаем от возврата кадра
+            const auto convert_started = std::chrono::steady_clock::now();
+            const auto captured_at = video_source_->last_capture_time();
+            FrameTrace& trace = buffer->trace;
+            trace.sequence = ++next_sequence_;
+            trace.captured_at = captured_at != std::chrono::steady_clock::time_point{} ? captured_at : convert_started;
+            
+            ascii_converter_->convert(buffer->image, frame_width_, frame_height_, buffer->ascii);
+            trace.converted_at = std::chrono::steady_clock::now();
+            stream_metrics().conversion_time.observe(elapsed_since(convert_started));
+            stream_metrics().stage_convert.observe(
+                std::chrono::duration_cast<std::chrono::microseconds>(trace.converted_at - trace.captured_at));
+            stream_metrics().frames.inc();
+            const std::string& ascii_frame = buffer->ascii;
+            const std::string& previous = last_frame_ ? last_frame_->ascii : ascii_frame;
+            // Первый кадр после запуска или пробуждения не с чем сравнить:
+            // считаем его спокойным, иначе каждый запуск открывал бы авто-запись
+            int activity = last_frame_ ? frame_activity(previous, ascii_frame) : 0;
+            
+            record_controller_->process_frame(ascii_frame, activity);
+            
+            // Статичная сцена: вместо одинаковых кадров зрителям уходят только
+            // редкие heartbeat-сообщения, последний кадр у них уже есть
+            auto now = std::chrono::steady_clock::now();
+            bool unchanged = last_frame_ && activity == 0 && ascii_frame == previous;
             
-            if (record_controller_->is_recording()) 
+            if (!unchanged) 
             {
-                record_controller_->write_frame(ascii_frame);
+                co_await broadcast_frame(std::shared_ptr<const std::string>(buffer, &buffer->ascii), trace);
+                last_broadcast_ = now;
+                
+                if (captured_at != std::chrono::steady_clock::time_point{}) 
+                {
+                    const auto latency = elapsed_since(captured_at);
+                    capture_latency_us_ = latency.count();
+                    stream_metrics().capture_latency.observe(latency);
+                }
+            } 
+            else if (now - last_broadcast_ >= KEEPALIVE_INTERVAL) 
+            {
+                co_await broadcast_frame(heartbeat_);
+                last_broadcast_ = now;
             }
             
-            co_await broadcast_frame(ascii_frame);
+            last_frame_ = std::move(buffer);
         }
     } 
     catch (const std::exception& e) 
@@ -160,18 +293,136 @@ net::awaitable<void> StreamController::capture_loop()
         logger->error("Error in capture loop: {}", e.what());
     }
     
+    broadcast_status(false);
     is_streaming_ = false;
 }
 
-net::awaitable<void> StreamController::broadcast_frame(const std::string& frame) 
+bool StreamController::has_consumers() 
+{
+    viewers_.erase(
+        std::remove_if(viewers_.begin(), viewers_.end(),
+            [](const std::weak_ptr<IFrameViewer>& wp) { return wp.expired(); }),
+        viewers_.end());
+    
+    const auto controller = controller_viewer_.lock();
+    const bool watched = std::any_of(viewers_.begin(), viewers_.end(),
+        [&controller](const std::weak_ptr<IFrameViewer>& wp) {
+            auto viewer = wp.lock();
+            return viewer && viewer != controller;
+        });
+    
+    return watched || 
+           record_controller_->is_recording() || 
+           record_controller_->is_auto_record_enabled();
+}
+
+net::awaitable<void> StreamController::wait_for_consumers() 
+{
+    auto logger = Logger::get();
+    logger->info("No viewers or recordings, pausing capture");
+    
+    is_idle_ = true;
+    last_frame_.reset();
+    
+    bool released = release_device_when_idle_;
+    if (released) 
+    {
+        video_source_->close();
+    }
+    
+    // Таймер взводится "навсегда", будит его wake_up() или stop_streaming()
+    while (!stop_requested_ && !has_consumers()) 
+    {
+        idle_timer_.expires_at(std::chrono::steady_clock::time_point::max());
+        co_await idle_timer_.async_wait(as_tuple(net::use_awaitable));
+    }
+    
+    if (!stop_requested_ && released) 
+    {
+        video_source_->open(camera_index_);
+        video_source_->set_resolution(frame_width_ * 2, frame_height_ * 2);
+    }
+    
+    is_idle_ = false;
+    no_consumers_since_ = {};
+    
+    if (!stop_requested_) 
+    {
+        logger->info("Consumer attached, resuming capture");
+    }
+}
+
+void StreamController::wake_up() 
+{
+    if (is_idle_) 
+    {
+        idle_timer_.cancel();
+    }
+}
+
+void StreamController::set_idle_policy(std::chrono::seconds linger, bool release_device) 
+{
+    idle_linger_ = linger;
+    release_device_when_idle_ = release_device;
+}
+
+void StreamController::set_render_options(const RenderOptions& options) 
+{
+    // Конвертер используется только из strand_
+    net::post(strand_, 
+        [self = shared_from_this(), options] {
+            self->ascii_converter_->set_render_options(options);
+        });
+}
+
+void StreamController::set_ascii_chars(const std::string& chars) 
+{
+    ascii_chars_ = chars;
+}
+
+bool StreamController::is_idle() const 
+{
+    return is_idle_.load();
+}
+
+std::chrono::microseconds StreamController::capture_latency() const 
+{
+    return std::chrono::microseconds(capture_latency_us_.load());
+}
+
+net::awaitable<void> StreamController::broadcast_frame(std::shared_ptr<const std::string> frame, FrameTrace trace) 
 {
     co_await net::dispatch(strand_, net::use_awaitable);
     
+    const auto started = std::chrono::steady_clock::now();
+    if (trace.valid()) 
+    {
+        trace.enqueued_at = started;
+        stream_metrics().stage_enqueue.observe(
+            std::chrono::duration_cast<std::chrono::microseconds>(trace.enqueued_at - trace.converted_at));
+    }
+    
+    // Heartbeat нужен только WebSocket-зрителям: читатели шины сами видят,
+    // что новых кадров нет
+    if (frame_bus_ && frame != heartbeat_) 
+    {
+        if (frame_bus_->publish(*frame, trace.valid() ? trace.captured_at : started)) 
+        {
+            stream_metrics().bus_published.inc();
+        } 
+        else 
+        {
+            stream_metrics().bus_oversized.inc();
+            LOG_WARN_RATE_LIMITED("Frame of {} bytes does not fit frame bus slot of {} bytes", 
+                                  frame->size(), frame_bus_->slot_capacity());
+        }
+    }
+    
     for (auto it = viewers_.begin(); it != viewers_.end(); ) 
     {
         if (auto viewer = it->lock()) 
         {
-            viewer->send_frame(frame);
+            viewer->send_frame(frame, trace);
             ++it;
         } 
         else 
@@ -179,6 +430,68 @@ net::awaitable<void> StreamController::broadcast_frame(const std::string& frame)
             it = viewers_.erase(it);
         }
     }
+    stream_metrics().broadcast_time.observe(elapsed_since(started));
+}
+
+void StreamController::set_relay_mode(bool enabled) 
+{
+    relay_mode_ = enabled;
+}
+
+void StreamController::set_frame_bus(std::shared_ptr<frame_bus::Writer> writer) 
+{
+    net::post(strand_, 
+        [self = shared_from_this(), writer = std::move(writer)]() mutable {
+            self->frame_bus_ = std::move(writer);
+        });
+}
+
+void StreamController::set_upstream_active(bool active) 
+{
+    if (upstream_active_.exchange(active) == active) 
+    {
+        return;
+    }
+    
+    net::post(strand_, 
+        [self = shared_from_this(), active] {
+            // Последний кадр остановленной трансляции новым зрителям не нужен
+            if (!active) 
+            {
+                self->last_relayed_.reset();
+            }
+            self->broadcast_status(active);
+        });
+}
+
+void StreamController::broadcast_status(bool active) 
+{
+    const auto& status = active ? stream_active_ : stream_inactive_;
+    for (const auto& weak_viewer : viewers_) 
+    {
+        if (auto viewer = weak_viewer.lock()) 
+        {
+            viewer->send_frame(status);
+        }
+    }
+}
+
+net::awaitable<void> StreamController::relay_frame(std::shared_ptr<const std::string> frame) 
+{
+    co_await net::dispatch(strand_, net::use_awaitable);
+    
+    if (*frame == HEARTBEAT_MESSAGE) 
+    {
+        co_await broadcast_frame(heartbeat_);
+        co_return;
+    }
+    
+    // Запись на ретрансляторе работает так же, как на исходном сервере
+    const int activity = last_relayed_ ? frame_activity(*last_relayed_, *frame) : 0;
+    record_controller_->process_frame(*frame, activity);
+    
+    last_relayed_ = frame;
+    co_await broadcast_frame(std::move(frame));
 }
 
 void StreamController::cleanup() 
@@ -189,12 +502,15 @@ void StreamController::cleanup()
     }
     
     viewers_.clear();
+    controller_viewer_.reset();
+    last_frame_.reset();
+    last_relayed_.reset();
     is_streaming_ = false;
 }
 
 std::string StreamController::get_status() const 
 {
-    return is_streaming_ ? "active" : "inactive";
+    return is_streaming() ? "active" : "inactive";
 }
 
 void StreamController::start_recording() 
@@ -209,6 +525,7 @@ void StreamController::start_recording()
     
     if (record_controller_->start_recording()) 
     {
+        wake_up();
         logger->info("Recording started");
     } 
     else 
@@ -232,8 +549,26 @@ bool StreamController::is_recording() const
     return record_controller_->is_recording();
 }
 
+void StreamController::enable_auto_record(int pre_roll_seconds, int threshold, int cooldown_seconds) 
+{
+    // Значения приходят от клиента: ограничиваем размер буфера предзаписи
+    // и не даем порогу 0 превратить авто-запись в непрерывную
+    RecordController::AutoRecordSettings settings;
+    settings.pre_roll_seconds = std::clamp(pre_roll_seconds, 0, MAX_PRE_ROLL_SECONDS);
+    settings.fps = fps_;
+    settings.threshold = std::clamp(threshold, 1, 1000);
+    settings.cooldown_seconds = std::clamp(cooldown_seconds, 0, MAX_AUTO_RECORD_COOLDOWN_SECONDS);
+    record_controller_->enable_auto_record(settings);
+    wake_up();
+}
+
+void StreamController::disable_auto_record() 
+{
+    record_controller_->disable_auto_record();
+}
+
 net::awaitable<void> StreamController::start_playback(const std::string& filename, 
-                                                     std::shared_ptr<WebSocketSession> session) 
+                                                     std::shared_ptr<IFrameViewer> session) 
 {
     co_await net::dispatch(strand_, net::use_awaitable);
     
@@ -250,7 +585,7 @@ net::awaitable<void> StreamController::start_playback(const std::string& filenam
             // Send frame to playback session
             if (self->playback_session_) 
             {
-                self->playback_session_->send_frame(frame);
+                self->playback_session_->send_frame(std::make_shared<const std::string>(frame));
             }
         });
     }
@@ -279,4 +614,10 @@ net::awaitable<void> StreamController::set_playback_speed(double speed)
 {
     co_await net::dispatch(strand_, net::use_awaitable);
     playback_controller_->set_playback_speed(speed);
+}
+
+net::awaitable<bool> StreamController::seek_playback_activity(bool forward, int threshold) 
+{
+    co_await net::dispatch(strand_, net::use_awaitable);
+    co_return playback_controller_->seek_to_activity(forward, threshold);
 }
\ No newline at end of file
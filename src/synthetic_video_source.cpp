@@ -0,0 +1,113 @@
+#include "synthetic_video_source.hpp"
+#include "logger.hpp"
+
+#include <stdexcept>
+
+SyntheticVideoSource::Pattern SyntheticVideoSource::parse_pattern(const std::string& name) 
+{
+    if (name == "gradient") 
+    {
+        return Pattern::Gradient;
+    }
+    if (name == "noise") 
+    {
+        return Pattern::Noise;
+    }
+    if (name == "static") 
+    {
+        return Pattern::Static;
+    }
+    throw std::invalid_argument("Unknown synthetic pattern: " + name);
+}
+
+SyntheticVideoSource::SyntheticVideoSource(Pattern pattern, double fps)
+    : pattern_(pattern),
+      pacer_(fps == 0 ? DEFAULT_FPS : fps) 
+{
+    auto logger = Logger::get();
+    logger->debug("SyntheticVideoSource created");
+}
+
+void SyntheticVideoSource::open(int index) 
+{
+    auto logger = Logger::get();
+
+    // Каждый запуск начинается с одного и того же кадра
+    frame_index_ = 0;
+    current_ = 0;
+    pacer_.reset();
+    is_opened_ = true;
+
+    logger->info("Synthetic video source opened ({}x{})", width_, height_);
+}
+
+void SyntheticVideoSource::close() 
+{
+    is_opened_ = false;
+}
+
+bool SyntheticVideoSource::is_available() const 
+{
+    return is_opened_;
+}
+
+void SyntheticVideoSource::set_resolution(int width, int height) 
+{
+    width_ = width;
+    height_ = height;
+}
+
+std::chrono::steady_clock::time_point SyntheticVideoSource::last_capture_time() const 
+{
+    return last_capture_time_;
+}
+
+void SyntheticVideoSource::capture_frame(cv::Mat& frame) 
+{
+    if (!is_opened_) 
+    {
+        frame.release();
+        return;
+    }
+
+    // Без сна в потоке ввода-вывода: до следующего дедлайна
+    // повторяется текущий кадр
+    if (pacer_.due()) 
+    {
+        current_ = frame_index_++;
+        last_capture_time_ = std::chrono::steady_clock::now();
+    }
+
+    frame.create(height_, width_, CV_8UC3);
+    switch (pattern_) 
+    {
+        case Pattern::Gradient:
+            draw_gradient(frame, static_cast<int>(current_ * 4));
+            break;
+        case Pattern::Noise:
+        {
+            // Зерно от номера кадра, чтобы повтор совпадал с оригиналом
+            cv::RNG rng(NOISE_SEED + current_);
+            rng.fill(frame, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(256));
+            break;
+        }
+        case Pattern::Static:
+            draw_gradient(frame, 0);
+            break;
+    }
+}
+
+void SyntheticVideoSource::draw_gradient(cv::Mat& frame, int shift) const 
+{
+    for (int y = 0; y < frame.rows; ++y) 
+    {
+        uchar* row = frame.ptr<uchar>(y);
+        for (int x = 0; x < frame.cols; ++x) 
+        {
+            const uchar value = static_cast<uchar>((x + y + shift) & 0xFF);
+            row[x * 3] = value;
+            row[x * 3 + 1] = static_cast<uchar>(value + 85);
+            row[x * 3 + 2] = static_cast<uchar>(value + 170);
+        }
+    }
+}
\ No newline at end of file
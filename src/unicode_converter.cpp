@@ -0,0 +1,141 @@
+#include "unicode_converter.hpp"
+#include "logger.hpp"
+
+#include <opencv2/opencv.hpp>
+#include <stdexcept>
+
+namespace {
+
+// Запись символа из диапазона U+0800..U+FFFF тремя байтами UTF-8
+inline char* put_utf8(char* out, unsigned code_point) 
+{
+    out[0] = static_cast<char>(0xE0 | (code_point >> 12));
+    out[1] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    out[2] = static_cast<char>(0x80 | (code_point & 0x3F));
+    return out + 3;
+}
+
+const unsigned BRAILLE_BASE = 0x2800;
+const unsigned UPPER_HALF_BLOCK = 0x2580;
+const unsigned LOWER_HALF_BLOCK = 0x2584;
+const unsigned FULL_BLOCK = 0x2588;
+// Пустой символ Брайля вместо пробела, чтобы все клетки были по 3 байта
+const unsigned BLANK = BRAILLE_BASE;
+
+// Номера битов точек Брайля: [строка][столбец]
+const unsigned BRAILLE_BITS[4][2] = {
+    {0x01, 0x08},
+    {0x02, 0x10},
+    {0x04, 0x20},
+    {0x40, 0x80}
+};
+
+} // namespace
+
+UnicodeConverter::Mode UnicodeConverter::parse_mode(const std::string& name) 
+{
+    if (name == "braille") 
+    {
+        return Mode::Braille;
+    }
+    if (name == "half_block") 
+    {
+        return Mode::HalfBlock;
+    }
+    throw std::invalid_argument("Unknown unicode mode: " + name);
+}
+
+UnicodeConverter::UnicodeConverter(Mode mode)
+    : mode_(mode) 
+{
+}
+
+void UnicodeConverter::set_ascii_chars(const std::string& chars) 
+{
+}
+
+size_t UnicodeConverter::frame_size(int output_width, int output_height) 
+{
+    return static_cast<size_t>(output_height) * (output_width * GLYPH_BYTES + 1);
+}
+
+void UnicodeConverter::convert(const cv::Mat& frame, int output_width, int output_height, std::string& output) 
+{
+    if (frame.empty()) 
+    {
+        LOG_WARN_RATE_LIMITED("Attempted to convert empty frame");
+        output.clear();
+        return;
+    }
+
+    const cv::Mat* luma = &frame;
+    if (frame.channels() != 1) 
+    {
+        cv::cvtColor(frame, gray_, cv::COLOR_BGR2GRAY);
+        luma = &gray_;
+    }
+
+    const int sub_width = mode_ == Mode::Braille ? 2 : 1;
+    const int sub_height = mode_ == Mode::Braille ? 4 : 2;
+    cv::resize(*luma, samples_, cv::Size(output_width * sub_width, output_height * sub_height), 
+               0, 0, cv::INTER_AREA);
+
+    // Порог между средней яркостью кадра и серединой шкалы: на контрастных
+    // кадрах он следует за сценой, а однотонный темный кадр остается темным.
+    // Точки ставятся на темных участках, как плотные символы в обычном режиме.
+    const int threshold = (static_cast<int>(cv::mean(samples_)[0]) + 128) / 2;
+
+    output.resize(frame_size(output_width, output_height));
+    if (mode_ == Mode::Braille) 
+    {
+        emit_braille(output_width, output_height, threshold, output.data());
+    } 
+    else 
+    {
+        emit_half_blocks(output_width, output_height, threshold, output.data());
+    }
+}
+
+void UnicodeConverter::emit_braille(int output_width, int output_height, int threshold, char* out) const 
+{
+    for (int y = 0; y < output_height; ++y) 
+    {
+        const uchar* rows[4];
+        for (int r = 0; r < 4; ++r) 
+        {
+            rows[r] = samples_.ptr<uchar>(y * 4 + r);
+        }
+
+        for (int x = 0; x < output_width; ++x) 
+        {
+            unsigned bits = 0;
+            for (int r = 0; r < 4; ++r) 
+            {
+                bits |= rows[r][x * 2] < threshold ? BRAILLE_BITS[r][0] : 0;
+                bits |= rows[r][x * 2 + 1] < threshold ? BRAILLE_BITS[r][1] : 0;
+            }
+            out = put_utf8(out, BRAILLE_BASE + bits);
+        }
+
+        *out++ = '\n';
+    }
+}
+
+void UnicodeConverter::emit_half_blocks(int output_width, int output_height, int threshold, char* out) const 
+{
+    static const unsigned GLYPHS[4] = {BLANK, UPPER_HALF_BLOCK, LOWER_HALF_BLOCK, FULL_BLOCK};
+
+    for (int y = 0; y < output_height; ++y) 
+    {
+        const uchar* upper = samples_.ptr<uchar>(y * 2);
+        const uchar* lower = samples_.ptr<uchar>(y * 2 + 1);
+
+        for (int x = 0; x < output_width; ++x) 
+        {
+            const int index = (upper[x] < threshold ? 1 : 0) | (lower[x] < threshold ? 2 : 0);
+            out = put_utf8(out, GLYPHS[index]);
+        }
+
+        *out++ = '\n';
+    }
+}
\ No newline at end of file
@@ -0,0 +1,412 @@
+#include "v4l2_video_source.hpp"
+#include "logger.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <linux/videodev2.h>
+
+namespace {
+
+// Форматы в порядке предпочтения: сначала те, где яркость берется без декодирования
+const uint32_t PREFERRED_FORMATS[] = {
+    V4L2_PIX_FMT_YUYV,
+    V4L2_PIX_FMT_NV12,
+    V4L2_PIX_FMT_GREY,
+    V4L2_PIX_FMT_MJPEG
+};
+
+std::string fourcc_to_string(uint32_t fourcc) 
+{
+    std::string result(4, ' ');
+    for (int i = 0; i < 4; ++i) 
+    {
+        result[i] = static_cast<char>((fourcc >> (8 * i)) & 0xFF);
+    }
+    return result;
+}
+
+} // namespace
+
+V4l2DeviceOps V4l2DeviceOps::system() 
+{
+    V4l2DeviceOps ops;
+    ops.open = [](const std::string& path) {
+        return ::open(path.c_str(), O_RDWR | O_NONBLOCK);
+    };
+    ops.close = [](int fd) {
+        return ::close(fd);
+    };
+    ops.ioctl = [](int fd, unsigned long request, void* arg) {
+        return ::ioctl(fd, request, arg);
+    };
+    ops.mmap = [](int fd, size_t length, off_t offset) {
+        return ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, offset);
+    };
+    ops.munmap = [](void* addr, size_t length) {
+        return ::munmap(addr, length);
+    };
+    ops.wait_frame = [](int fd, int timeout_ms) {
+        pollfd pfd{fd, POLLIN, 0};
+        return ::poll(&pfd, 1, timeout_ms);
+    };
+    return ops;
+}
+
+V4l2VideoSource::V4l2VideoSource(V4l2DeviceOps ops)
+    : ops_(std::move(ops)) 
+{
+    auto logger = Logger::get();
+    logger->debug("V4l2VideoSource created");
+}
+
+V4l2VideoSource::~V4l2VideoSource() 
+{
+    close();
+}
+
+int V4l2VideoSource::xioctl(unsigned long request, void* arg) 
+{
+    int result;
+    do 
+    {
+        result = ops_.ioctl(fd_, request, arg);
+    }
+    while (result == -1 && errno == EINTR);
+    return result;
+}
+
+void V4l2VideoSource::open(int index) 
+{
+    auto logger = Logger::get();
+
+    if (fd_ >= 0) 
+    {
+        close();
+    }
+
+    camera_index_ = index;
+    std::string path = "/dev/video" + std::to_string(index);
+
+    fd_ = ops_.open(path);
+    if (fd_ < 0) 
+    {
+        logger->error("Could not open V4L2 device {}: {}", path, std::strerror(errno));
+        throw std::runtime_error("Could not open video source");
+    }
+
+    v4l2_capability caps{};
+    if (xioctl(VIDIOC_QUERYCAP, &caps) < 0 ||
+        !(caps.capabilities & V4L2_CAP_VIDEO_CAPTURE) ||
+        !(caps.capabilities & V4L2_CAP_STREAMING)) 
+    {
+        logger->error("Device {} does not support streaming capture", path);
+        close();
+        throw std::runtime_error("Video source does not support streaming capture");
+    }
+
+    try 
+    {
+        configure();
+    }
+    catch (...) 
+    {
+        close();
+        throw;
+    }
+
+    logger->info("V4L2 source initialized at {} ({} {}x{})",
+                 path, fourcc_to_string(pixel_format_), frame_width_, frame_height_);
+}
+
+void V4l2VideoSource::configure() 
+{
+    auto logger = Logger::get();
+
+    release_buffers();
+
+    // Драйвер подставляет свой формат, если запрошенный не поддерживается,
+    // поэтому результат S_FMT сверяется с запросом
+    v4l2_format fmt{};
+    bool negotiated = false;
+    for (uint32_t format : PREFERRED_FORMATS) 
+    {
+        fmt = {};
+        fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        fmt.fmt.pix.width = width_;
+        fmt.fmt.pix.height = height_;
+        fmt.fmt.pix.pixelformat = format;
+        fmt.fmt.pix.field = V4L2_FIELD_NONE;
+
+        if (xioctl(VIDIOC_S_FMT, &fmt) == 0 && fmt.fmt.pix.pixelformat == format) 
+        {
+            negotiated = true;
+            break;
+        }
+    }
+
+    if (!negotiated) 
+    {
+        logger->error("V4L2 device offers no supported pixel format");
+        throw std::runtime_error("No supported pixel format");
+    }
+
+    pixel_format_ = fmt.fmt.pix.pixelformat;
+    frame_width_ = fmt.fmt.pix.width;
+    frame_height_ = fmt.fmt.pix.height;
+    bytes_per_line_ = fmt.fmt.pix.bytesperline;
+
+    v4l2_requestbuffers request{};
+    request.count = BUFFER_COUNT;
+    request.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    request.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(VIDIOC_REQBUFS, &request) < 0 || request.count == 0) 
+    {
+        logger->error("V4L2 buffer request failed: {}", std::strerror(errno));
+        throw std::runtime_error("Could not allocate capture buffers");
+    }
+
+    for (unsigned i = 0; i < request.count; ++i) 
+    {
+        v4l2_buffer buf{};
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = i;
+        if (xioctl(VIDIOC_QUERYBUF, &buf) < 0) 
+        {
+            throw std::runtime_error("Could not query capture buffer");
+        }
+
+        MappedBuffer mapped;
+        mapped.length = buf.length;
+        mapped.data = ops_.mmap(fd_, buf.length, buf.m.offset);
+        if (mapped.data == MAP_FAILED) 
+        {
+            throw std::runtime_error("Could not map capture buffer");
+        }
+        buffers_.push_back(mapped);
+
+        if (xioctl(VIDIOC_QBUF, &buf) < 0) 
+        {
+            throw std::runtime_error("Could not queue capture buffer");
+        }
+    }
+
+    v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl(VIDIOC_STREAMON, &type) < 0) 
+    {
+        throw std::runtime_error("Could not start V4L2 streaming");
+    }
+    is_streaming_ = true;
+}
+
+void V4l2VideoSource::release_buffers() 
+{
+    if (is_streaming_) 
+    {
+        v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        xioctl(VIDIOC_STREAMOFF, &type);
+        is_streaming_ = false;
+    }
+    pending_index_ = -1;
+
+    for (auto& buffer : buffers_) 
+    {
+        ops_.munmap(buffer.data, buffer.length);
+    }
+
+    if (!buffers_.empty()) 
+    {
+        v4l2_requestbuffers request{};
+        request.count = 0;
+        request.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        request.memory = V4L2_MEMORY_MMAP;
+        xioctl(VIDIOC_REQBUFS, &request);
+        buffers_.clear();
+    }
+}
+
+void V4l2VideoSource::close() 
+{
+    if (fd_ < 0) 
+    {
+        return;
+    }
+
+    auto logger = Logger::get();
+    logger->info("Releasing V4L2 source");
+
+    release_buffers();
+    ops_.close(fd_);
+    fd_ = -1;
+}
+
+bool V4l2VideoSource::is_available() const 
+{
+    return fd_ >= 0 && is_streaming_;
+}
+
+std::chrono::steady_clock::time_point V4l2VideoSource::last_capture_time() const 
+{
+    return last_capture_time_;
+}
+
+uint32_t V4l2VideoSource::pixel_format() const 
+{
+    return pixel_format_;
+}
+
+void V4l2VideoSource::set_resolution(int width, int height) 
+{
+    auto logger = Logger::get();
+    logger->debug("Setting resolution to {}x{}", width, height);
+
+    width_ = width;
+    height_ = height;
+
+    // Формат нельзя менять при запущенном потоке, буферы пересоздаются
+    if (fd_ >= 0) 
+    {
+        configure();
+    }
+
+    logger->info("Resolution set to {}x{}", frame_width_, frame_height_);
+}
+
+void V4l2VideoSource::requeue_pending() 
+{
+    if (pending_index_ < 0) 
+    {
+        return;
+    }
+
+    v4l2_buffer buf{};
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    buf.index = pending_index_;
+    if (xioctl(VIDIOC_QBUF, &buf) < 0) 
+    {
+        LOG_WARN_RATE_LIMITED("Failed to requeue V4L2 buffer {}: {}", pending_index_, std::strerror(errno));
+    }
+    pending_index_ = -1;
+}
+
+void V4l2VideoSource::capture_frame(cv::Mat& frame) 
+{
+    if (!is_available()) 
+    {
+        frame.release();
+        return;
+    }
+
+    // Предыдущий буфер мог быть отдан наружу без копирования,
+    // возвращаем его драйверу только сейчас
+    requeue_pending();
+
+    int ready = ops_.wait_frame(fd_, CAPTURE_TIMEOUT_MS);
+    if (ready <= 0) 
+    {
+        LOG_WARN_RATE_LIMITED("Timed out waiting for V4L2 frame");
+        frame.release();
+        return;
+    }
+
+    v4l2_buffer buf{};
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(VIDIOC_DQBUF, &buf) < 0) 
+    {
+        if (errno != EAGAIN) 
+        {
+            LOG_WARN_RATE_LIMITED("Failed to dequeue V4L2 buffer: {}", std::strerror(errno));
+        }
+        frame.release();
+        return;
+    }
+
+    pending_index_ = buf.index;
+
+    // Монотонная метка драйвера совпадает с часами steady_clock на Linux
+    if ((buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) == V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) 
+    {
+        last_capture_time_ = std::chrono::steady_clock::time_point(
+            std::chrono::seconds(buf.timestamp.tv_sec) + 
+            std::chrono::microseconds(buf.timestamp.tv_usec));
+    } 
+    else 
+    {
+        last_capture_time_ = std::chrono::steady_clock::now();
+    }
+
+    if (buf.index >= buffers_.size() || (buf.flags & V4L2_BUF_FLAG_ERROR)) 
+    {
+        LOG_WARN_RATE_LIMITED("Driver returned a corrupted V4L2 buffer");
+        frame.release();
+        return;
+    }
+
+    extract_luma(buffers_[buf.index], buf.bytesused, frame);
+
+    if (frame.empty()) 
+    {
+        LOG_WARN_RATE_LIMITED("Captured empty frame from video source");
+    }
+}
+
+void V4l2VideoSource::extract_luma(const MappedBuffer& buffer, size_t bytes_used, cv::Mat& frame) 
+{
+    switch (pixel_format_) 
+    {
+        case V4L2_PIX_FMT_YUYV: 
+        {
+            // Y0 U Y1 V: яркость - каждый четный байт
+            cv::Mat packed(frame_height_, frame_width_, CV_8UC2, buffer.data, bytes_per_line_);
+            cv::extractChannel(packed, frame, 0);
+            break;
+        }
+        case V4L2_PIX_FMT_NV12:
+        case V4L2_PIX_FMT_GREY: 
+        {
+            // Плоскость Y лежит в начале буфера
+            frame = cv::Mat(frame_height_, frame_width_, CV_8UC1, buffer.data, bytes_per_line_);
+            break;
+        }
+        case V4L2_PIX_FMT_MJPEG: 
+        {
+            cv::Mat encoded(1, static_cast<int>(bytes_used), CV_8UC1, buffer.data);
+            cv::imdecode(encoded, mjpeg_decode_flags(), &frame);
+            break;
+        }
+        default:
+            frame.release();
+            break;
+    }
+}
+
+int V4l2VideoSource::mjpeg_decode_flags() const 
+{
+    // StreamController запрашивает удвоенный размер ASCII-кадра, для
+    // конвертации достаточно половины. Берем наибольшее уменьшение,
+    // при котором кадр не станет меньше нужного.
+    const int needed = std::max(1, width_ / 2);
+
+    if (frame_width_ / 8 >= needed) 
+    {
+        return cv::IMREAD_REDUCED_GRAYSCALE_8;
+    }
+    if (frame_width_ / 4 >= needed) 
+    {
+        return cv::IMREAD_REDUCED_GRAYSCALE_4;
+    }
+    if (frame_width_ / 2 >= needed) 
+    {
+        return cv::IMREAD_REDUCED_GRAYSCALE_2;
+    }
+    return cv::IMREAD_GRAYSCALE;
+}
\ No newline at end of file
@@ -89,12 +89,15 @@ void VideoSource::open(int index)
     cap_.set(cv::CAP_PROP_FRAME_WIDTH, width_);
     cap_.set(cv::CAP_PROP_FRAME_HEIGHT, height_);
     is_opened_ = true;
+    start_grabber();
 
     logger->info("Video source initialized at index {}", camera_index_);
 }
 
 void VideoSource::close()
 {
+    stop_grabber();
+
     if (cap_.isOpened()) 
     {
         auto logger = Logger::get();
@@ -104,22 +107,84 @@ void VideoSource::close()
     }
 }
 
+void VideoSource::start_grabber() 
+{
+    // Сбрасываем кадр, оставшийся от прошлого запуска или от interrupt()
+    latest_.update();
+
+    grabbing_ = true;
+    grabber_ = std::thread([this] { grab_loop(); });
+}
+
+void VideoSource::stop_grabber() 
+{
+    if (!grabber_.joinable()) 
+    {
+        return;
+    }
+
+    grabbing_ = false;
+    latest_.interrupt();
+    grabber_.join();
+}
+
+void VideoSource::grab_loop() 
+{
+    while (grabbing_) 
+    {
+        // grab() блокируется до прихода кадра, время берется сразу после него
+        auto& slot = latest_.back();
+        if (cap_.grab() && cap_.retrieve(slot.image)) 
+        {
+            slot.captured_at = std::chrono::steady_clock::now();
+        } 
+        else 
+        {
+            LOG_WARN_RATE_LIMITED("Failed to grab frame from video source");
+            slot.image.release();
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+
+        latest_.publish();
+    }
+}
+
 bool VideoSource::is_available() const 
 {
     return is_opened_;
 }
 
-cv::Mat VideoSource::capture_frame() 
+void VideoSource::capture_frame(cv::Mat& frame) 
 {
-    cv::Mat frame;
-    cap_ >> frame;
+    // Если камера быстрее обработки, свежий кадр уже лежит в слоте;
+    // иначе ждем следующий, как раньше ждали в cap_ >> frame
+    if (grabbing_) 
+    {
+        latest_.wait_for_fresh();
+    }
+
+    if (!grabbing_ || !latest_.update()) 
+    {
+        frame.release();
+    } 
+    else 
+    {
+        // Обмен заголовками вместо копирования: кадр уходит вызывающему,
+        // его старый буфер переиспользуется потоком захвата
+        auto& captured = latest_.front();
+        std::swap(frame, captured.image);
+        last_capture_time_ = captured.captured_at;
+    }
 
     if (frame.empty()) 
     {
-        auto logger = Logger::get();
-        logger->warn("Captured empty frame from video source");
+        LOG_WARN_RATE_LIMITED("Captured empty frame from video source");
     }
-    return frame;
+}
+
+std::chrono::steady_clock::time_point VideoSource::last_capture_time() const 
+{
+    return last_capture_time_;
 }
 
 void VideoSource::set_resolution(int width, int height) 
@@ -129,8 +194,16 @@ void VideoSource::set_resolution(int width, int height)
     
     width_ = width;
     height_ = height;
+
+    // VideoCapture не потокобезопасен, поток захвата на время настройки останавливается
+    bool was_grabbing = grabber_.joinable();
+    stop_grabber();
     cap_.set(cv::CAP_PROP_FRAME_WIDTH, width_);
     cap_.set(cv::CAP_PROP_FRAME_HEIGHT, height_);
+    if (was_grabbing) 
+    {
+        start_grabber();
+    }
 
     logger->info("Resolution set to {}x{}", width, height);
 }
\ No newline at end of file
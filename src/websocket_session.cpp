@@ -1,19 +1,64 @@
 #include "websocket_session.hpp"
 #include "server.hpp"
 #include "logger.hpp"
+#include "frame_activity.hpp"
+#include "metrics.hpp"
 
-#include <nlohmann/json.hpp>
+#include <array>
+#include <atomic>
 
-WebSocketSession::WebSocketSession(net::ssl::stream<tcp::socket> stream,
+namespace {
+
+struct SessionMetrics 
+{
+    metrics::Gauge& active_sessions = metrics::Registry::get().gauge(
+        "ascii_websocket_sessions", "Open WebSocket sessions");
+    metrics::Histogram& queue_depth = metrics::Registry::get().histogram(
+        "ascii_viewer_queue_depth", "Viewer send queue length after enqueuing a frame",
+        {0, 1, 2, 3, 4, 6, 8, 10});
+    metrics::Counter& dropped_frames = metrics::Registry::get().counter(
+        "ascii_dropped_frames_total", "Frames dropped because a viewer queue was full");
+    metrics::Counter& bytes_sent = metrics::Registry::get().counter(
+        "ascii_websocket_sent_bytes_total", "Payload bytes written to WebSocket clients");
+    metrics::Histogram& stage_write = metrics::Registry::get().latency(
+        "ascii_stage_write_seconds", "Frame stage: broadcast enqueue to viewer write complete");
+    metrics::Histogram& frame_latency = metrics::Registry::get().latency(
+        "ascii_frame_latency_seconds", "Frame capture to viewer write complete");
+    metrics::Histogram& trace_rtt = metrics::Registry::get().latency(
+        "ascii_trace_rtt_seconds", "Round trip of a traced frame header to the browser and back");
+};
+
+SessionMetrics& session_metrics() 
+{
+    static SessionMetrics instance;
+    return instance;
+}
+
+std::atomic<uint64_t> next_session_id{1};
+
+// Совпадает с сообщением, которое StreamController рассылает вместо неизменившихся кадров
+constexpr std::string_view HEARTBEAT_MESSAGE = "HEARTBEAT";
+
+} // namespace
+
+template <class Stream>
+WebSocketSession<Stream>::WebSocketSession(Stream stream,
                                    std::shared_ptr<StreamController> controller, 
-                                   std::shared_ptr<Server> server)
+                                   std::shared_ptr<Server> server,
+                                   AdmissionController::Slot connection)
     : ws_(std::move(stream)), 
       controller_(controller), 
       server_(server),
-      session_id_(generate_session_id())
-{}
+      session_id_(generate_session_id()),
+      peer_address_(peer_address(ws_.next_layer())),
+      connection_(std::move(connection)),
+      auth_timer_(ws_.get_executor()) 
+{
+    session_metrics().active_sessions.add(1);
+}
 
-WebSocketSession::~WebSocketSession() 
+template <class Stream>
+WebSocketSession<Stream>::~WebSocketSession() 
 {
     auto logger = Logger::get();
     
@@ -32,40 +77,57 @@ WebSocketSession::~WebSocketSession()
             net::detached);
     }
     
+    session_metrics().active_sessions.add(-1);
     logger->debug("WebSocket session destroyed");
 }
 
-uint64_t WebSocketSession::generate_session_id() 
+template <class Stream>
+uint64_t WebSocketSession<Stream>::generate_session_id() 
 {
-    static std::atomic<uint64_t> next_id{1};
-    return next_id++;
+    // Счетчик общий для всех транспортов: по номеру сессия удаляется из зрителей
+    return next_session_id++;
 }
 
-void WebSocketSession::run(http::request<http::string_body> req) 
+template <class Stream>
+void WebSocketSession<Stream>::run(http::request<http::string_body> req) 
 {
     net::co_spawn(
         ws_.get_executor(),
-        [self = shared_from_this(), req = std::move(req)]() mutable {
+        [self = this->shared_from_this(), req = std::move(req)]() mutable {
             return self->do_run(std::move(req));
         },
         net::detached);
 }
 
-void WebSocketSession::send_frame(const std::string& frame) 
+template <class Stream>
+void WebSocketSession<Stream>::send_frame(const std::string& frame) 
 {
     // Создаем shared_ptr для строки, чтобы гарантировать ее время жизни
-    auto frame_ptr = std::make_shared<std::string>(frame);
-    
+    enqueue(std::make_shared<const std::string>(frame), {}, MessageType::Control);
+}
+
+template <class Stream>
+void WebSocketSession<Stream>::send_frame(std::shared_ptr<const std::string> frame, const FrameTrace& trace) 
+{
+    const MessageType type = *frame == HEARTBEAT_MESSAGE ? MessageType::Heartbeat : MessageType::Frame;
+    enqueue(std::move(frame), trace, type);
+}
+
+template <class Stream>
+void WebSocketSession<Stream>::enqueue(std::shared_ptr<const std::string> payload, const FrameTrace& trace, MessageType type) 
+{
     net::post(ws_.get_executor(),
-        [self = shared_from_this(), frame_ptr] {
-            if (!self->ws_.is_open()) return;
+        [self = this->shared_from_this(), frame_ptr = std::move(payload), trace, type]() mutable {
+            if (!self->ws_.is_open() || self->close_pending_) return;
 
             if (self->write_queue_.size() >= MAX_QUEUE_SIZE) 
             {
                 self->write_queue_.pop_front();
+                session_metrics().dropped_frames.inc();
             }
             
-            self->write_queue_.push_back(*frame_ptr);
+            self->write_queue_.push_back({std::move(frame_ptr), trace, type});
+            session_metrics().queue_depth.observe(self->write_queue_.size());
             
             if (!self->is_writing_) 
             {
@@ -77,12 +139,13 @@ void WebSocketSession::send_frame(const std::string& frame)
         });
 }
 
-void WebSocketSession::close() 
+template <class Stream>
+void WebSocketSession<Stream>::close() 
 {
     if (ws_.is_open()) 
     {
         ws_.async_close(websocket::close_code::normal,
-            [self = shared_from_this()](beast::error_code ec) {
+            [self = this->shared_from_this()](beast::error_code ec) {
                 if (ec) 
                 {
                     auto logger = Logger::get();
@@ -92,16 +155,74 @@ void WebSocketSession::close()
     }
 }
 
-net::awaitable<void> WebSocketSession::do_write()
+template <class Stream>
+void WebSocketSession<Stream>::close_after_drain() 
+{
+    // Ставится в ту же очередь исполнителя после ответа, поэтому ответ уже
+    // в write_queue_; закрывает do_write, когда очередь опустеет
+    net::post(ws_.get_executor(),
+        [self = this->shared_from_this()] {
+            self->close_pending_ = true;
+            if (!self->is_writing_) 
+            {
+                self->close();
+            }
+        });
+}
+
+template <class Stream>
+net::awaitable<void> WebSocketSession<Stream>::do_write() 
 {
     auto logger = Logger::get();
     try {
-        while (!write_queue_.empty() && ws_.is_open())
+        while (!write_queue_.empty() && ws_.is_open()) 
         {
-            std::string frame = std::move(write_queue_.front());
+            auto frame = std::move(write_queue_.front());
             write_queue_.pop_front();
 
-            co_await ws_.async_write(net::buffer(frame), net::use_awaitable);
+            const auto sent_at = std::chrono::steady_clock::now();
+            if (trace_enabled_ && frame.trace.valid()) 
+            {
+                remember_sent_trace(frame.trace.sequence, sent_at);
+            }
+
+            if (binary_framing_) 
+            {
+                const FrameHeader header = encode_frame_header(
+                    frame.type, *frame.payload, frame.trace, trace_enabled_, sent_at);
+                const std::array<net::const_buffer, 2> buffers{
+                    net::buffer(header), net::buffer(*frame.payload)};
+                ws_.binary(true);
+                co_await ws_.async_write(buffers, net::use_awaitable);
+                session_metrics().bytes_sent.inc(header.size() + frame.payload->size());
+            } 
+            else if (trace_enabled_ && frame.trace.valid()) 
+            {
+                // Заголовок и кадр уходят одним сообщением без склейки в буфер
+                const TraceHeader header = encode_trace_header(frame.trace, sent_at);
+                const std::array<net::const_buffer, 2> buffers{
+                    net::buffer(header), net::buffer(*frame.payload)};
+                ws_.binary(true);
+                co_await ws_.async_write(buffers, net::use_awaitable);
+                session_metrics().bytes_sent.inc(header.size() + frame.payload->size());
+            } 
+            else 
+            {
+                ws_.text(true);
+                co_await ws_.async_write(net::buffer(*frame.payload), net::use_awaitable);
+                session_metrics().bytes_sent.inc(frame.payload->size());
+            }
+
+            if (frame.trace.valid()) 
+            {
+                record_written(frame.trace);
+            }
+        }
+        
+        // Очередь опустела: ответ, после которого нужно закрыть соединение, отправлен
+        if (close_pending_) 
+        {
+            close();
         }
     }
     catch (const beast::system_error& e) 
@@ -113,7 +234,7 @@ net::awaitable<void> WebSocketSession::do_write()
             e.code() == net::error::connection_reset ||
             e.code() == net::error::connection_aborted) 
         {
-            logger->debug("Write aborted due to closed connection: {}", e.what());
+            SPDLOG_LOGGER_DEBUG(logger, "Write aborted due to closed connection: {}", e.what());
         } 
         else 
         {
@@ -136,7 +257,8 @@ net::awaitable<void> WebSocketSession::do_write()
     is_writing_ = false;
 }
 
-net::awaitable<void> WebSocketSession::do_run(http::request<http::string_body> req) 
+template <class Stream>
+net::awaitable<void> WebSocketSession<Stream>::do_run(http::request<http::string_body> req) 
 {
     auto logger = Logger::get();
     
@@ -151,12 +273,31 @@ net::awaitable<void> WebSocketSession::do_run(http::request<http::string_body> r
                 res.set(http::field::server, "ASCII Stream Server");
             }));
         
+        if (server_->websocket_compression()) 
+        {
+            websocket::permessage_deflate pmd;
+            pmd.server_enable = true;
+            ws_.set_option(pmd);
+        }
+        
         co_await ws_.async_accept(req, net::use_awaitable);
-        logger->info("Secure WebSocket connection established");
+        logger->info("WebSocket connection established over {}", StreamTraits<Stream>::name);
+        
+        // Ping-pong поддерживает соединение и без команд, поэтому первое
+        // успешное auth ограничено отдельным дедлайном
+        auth_timer_.expires_after(AUTH_TIMEOUT);
+        auth_timer_.async_wait([weak = this->weak_from_this()](boost::system::error_code ec) {
+            auto self = weak.lock();
+            if (!ec && self && !self->is_authenticated_) 
+            {
+                LOG_WARN_RATE_LIMITED("Closing WebSocket from {} that did not authenticate in time", self->peer_address_);
+                self->close_after_drain();
+            }
+        });
         
         while (ws_.is_open()) 
         {
-            try
+            try 
             {
                 co_await do_read();
             }
@@ -203,7 +344,8 @@ net::awaitable<void> WebSocketSession::do_run(http::request<http::string_body> r
     }
 }
 
-net::awaitable<void> WebSocketSession::do_read() 
+template <class Stream>
+net::awaitable<void> WebSocketSession<Stream>::do_read() 
 {
     auto logger = Logger::get();
     
@@ -212,8 +354,17 @@ net::awaitable<void> WebSocketSession::do_read()
         buffer_.clear();
         co_await ws_.async_read(buffer_, net::use_awaitable);
         
-        auto message = beast::buffers_to_string(buffer_.data());
-        logger->debug("Received message: {}", message);
+        // Двоичные сообщения от клиента - только возвращенные заголовки трассировки
+        if (ws_.got_binary()) 
+        {
+            handle_trace_echo();
+            co_return;
+        }
+        
+        // Сообщение разбирается прямо в буфере чтения, без копии в строку
+        const auto data = buffer_.cdata();
+        const std::string_view message(static_cast<const char*>(data.data()), data.size());
+        SPDLOG_LOGGER_DEBUG(logger, "Received message: {}", message.substr(0, 256));
         
         co_await handle_message(message);
     } 
@@ -226,7 +377,7 @@ net::awaitable<void> WebSocketSession::do_read()
         {
             logger->error("WebSocket read error: {}", e.what());
         }
-        else
+        else 
         {
             logger->debug("WebSocket connection closed by client");
         }
@@ -234,105 +385,259 @@ net::awaitable<void> WebSocketSession::do_read()
     }
 }
 
-net::awaitable<void> WebSocketSession::handle_message(const std::string& message) 
+template <class Stream>
+void WebSocketSession<Stream>::handle_trace_echo() 
+{
+    // Трассировка включается командой контроллера или зрителя, до auth
+    // ответы не принимаются
+    if (!is_authenticated_) 
+    {
+        return;
+    }
+
+    TraceEcho echo;
+    const auto data = buffer_.cdata();
+    if (!decode_trace_echo(data.data(), data.size(), echo) && 
+        !decode_frame_header_echo(data.data(), data.size(), echo)) 
+    {
+        Logger::get()->debug("Ignoring malformed trace echo of {} bytes", data.size());
+        return;
+    }
+    
+    // Время отправки в ответе приходит от клиента и не используется:
+    // неизвестный или уже учтенный номер кадра отбрасывается
+    for (SentTrace& sent : sent_traces_) 
+    {
+        if (sent.sequence != 0 && sent.sequence == echo.sequence) 
+        {
+            session_metrics().trace_rtt.observe(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - sent.sent_at));
+            sent.sequence = 0;
+            return;
+        }
+    }
+}
+
+template <class Stream>
+void WebSocketSession<Stream>::remember_sent_trace(uint64_t sequence, std::chrono::steady_clock::time_point sent_at) 
+{
+    sent_traces_[sent_traces_next_] = {sequence, sent_at};
+    sent_traces_next_ = (sent_traces_next_ + 1) % sent_traces_.size();
+}
+
+template <class Stream>
+void WebSocketSession<Stream>::record_written(const FrameTrace& trace) 
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    
+    const auto written_at = std::chrono::steady_clock::now();
+    const auto total = duration_cast<microseconds>(written_at - trace.captured_at);
+    session_metrics().stage_write.observe(duration_cast<microseconds>(written_at - trace.enqueued_at));
+    session_metrics().frame_latency.observe(total);
+    
+    if (total > OUTLIER_LATENCY) 
+    {
+        LOG_WARN_RATE_LIMITED("Frame {} reached session {} after {} us (convert {} us, enqueue {} us, write {} us)", 
+                              trace.sequence, session_id_, total.count(),
+                              duration_cast<microseconds>(trace.converted_at - trace.captured_at).count(),
+                              duration_cast<microseconds>(trace.enqueued_at - trace.converted_at).count(),
+                              duration_cast<microseconds>(written_at - trace.enqueued_at).count());
+    }
+}
+
+template <class Stream>
+net::awaitable<void> WebSocketSession<Stream>::handle_message(std::string_view message) 
 {
     auto logger = Logger::get();
     
+    // Соединение закрывается после отказа, остальные команды не выполняются
+    if (close_pending_) 
+    {
+        co_return;
+    }
+    
     try 
     {
-        auto j = nlohmann::json::parse(message);
-        std::string type = j["type"];
+        const ControlMessage& msg = control_message_;
+        if (!control_message_.parse(message)) 
+        {
+            logger->warn("Malformed control message of {} bytes", message.size());
+            send_frame("ERROR: Malformed control message");
+            co_return;
+        }
         
-        if (type == "auth") 
+        // Команды управления камерой и записью доступны только контроллеру
+        switch (msg.command()) 
         {
-            std::string api_key = j["api_key"];
-            std::string role = j.value("role", "viewer");
-            
-            if (api_key != server_->api_key()) 
+            case ControlCommand::Auth: 
             {
-                co_await ws_.async_write(net::buffer("AUTH_FAILED"), net::use_awaitable);
+                const std::string_view api_key = msg.string("api_key");
+                const std::string_view role = msg.string("role", "viewer");
+                auto& admission = server_->admission();
+                
+                // Подбор ключа: после max_auth_failures адрес блокируется и
+                // соединение закрывается, новые отклоняются еще до TLS
+                if (!admission.auth_allowed(peer_address_)) 
+                {
+                    send_frame("AUTH_LOCKED");
+                    close_after_drain();
+                    co_return;
+                }
+                
+                if (api_key != server_->api_key()) 
+                {
+                    admission.record_auth_failure(peer_address_);
+                    send_frame("AUTH_FAILED");
+                    // Loopback и Unix-сокет не блокируются по адресу, но и через
+                    // них нельзя перебирать ключи в одном соединении
+                    if (++auth_failures_ >= MAX_AUTH_FAILURES_PER_CONNECTION) 
+                    {
+                        close_after_drain();
+                    }
+                    co_return;
+                }
+                admission.record_auth_success(peer_address_);
+                
+                if (role == "controller") 
+                {
+                    auth_timer_.cancel();
+                    is_authenticated_ = true;
+                    is_controller_ = true;
+                    controller_->add_controller(this->shared_from_this());
+                    send_frame("AUTH_CONTROLLER_SUCCESS");
+                } 
+                else 
+                {
+                    if (!viewer_) 
+                    {
+                        viewer_ = admission.admit_viewer();
+                    }
+                    if (!viewer_) 
+                    {
+                        send_frame("STREAM_FULL");
+                        close_after_drain();
+                        co_return;
+                    }
+                    
+                    auth_timer_.cancel();
+                    is_authenticated_ = true;
+                    controller_->add_viewer(this->shared_from_this());
+                    send_frame("AUTH_VIEWER_SUCCESS");
+                    
+                    std::string status = controller_->is_streaming() ? "STREAM_ACTIVE" : "STREAM_INACTIVE";
+                    send_frame(status);
+                }
                 co_return;
             }
-            
-            is_authenticated_ = true;
-            
-            if (role == "controller") 
+            case ControlCommand::Config: 
+                if (!is_controller_) break;
+                co_await controller_->start_streaming(
+                    msg.integer("camera_index", 0), std::string(msg.string("resolution", "120x90")), msg.integer("fps", 10));
+                send_frame("CONFIG_APPLIED");
+                co_return;
+            case ControlCommand::Stop: 
+                if (!is_controller_) break;
+                co_await controller_->stop_streaming();
+                send_frame("STREAM_STOPPED");
+                co_return;
+            case ControlCommand::PlaybackStart: 
             {
-                is_controller_ = true;
-                controller_->add_viewer(shared_from_this());
-                send_frame("AUTH_CONTROLLER_SUCCESS");
-            } 
-            else 
+                const std::string_view filename = msg.string("filename");
+                if (!filename.empty()) 
+                {
+                    co_await controller_->start_playback(std::string(filename), this->shared_from_this());
+                    send_frame("PLAYBACK_STARTED");
+                } 
+                else 
+                {
+                    send_frame("ERROR: No filename specified");
+                }
+                co_return;
+            }
+            case ControlCommand::PlaybackPause: 
+                co_await controller_->pause_playback();
+                send_frame("PLAYBACK_PAUSED");
+                co_return;
+            case ControlCommand::PlaybackResume: 
+                co_await controller_->resume_playback();
+                send_frame("PLAYBACK_RESUMED");
+                co_return;
+            case ControlCommand::PlaybackStop: 
+                co_await controller_->stop_playback();
+                send_frame("PLAYBACK_STOPPED");
+                co_return;
+            case ControlCommand::PlaybackSpeed: 
+                co_await controller_->set_playback_speed(msg.number("speed", 1.0));
+                send_frame("PLAYBACK_SPEED_CHANGED");
+                co_return;
+            case ControlCommand::PlaybackNextActivity: 
+            case ControlCommand::PlaybackPrevActivity: 
             {
-                controller_->add_viewer(shared_from_this());
-                send_frame("AUTH_VIEWER_SUCCESS");
-                
-                std::string status = controller_->is_streaming() ? "STREAM_ACTIVE" : "STREAM_INACTIVE";
-                send_frame(status);
+                bool found = co_await controller_->seek_playback_activity(
+                    msg.command() == ControlCommand::PlaybackNextActivity, 
+                    msg.integer("threshold", DEFAULT_ACTIVITY_THRESHOLD));
+                send_frame(found ? "PLAYBACK_SEEKED" : "NO_ACTIVITY_FOUND");
+                co_return;
             }
-        } 
-        else if (type == "config" && is_controller_) 
-        {
-            int camera_index = j.value("camera_index", 0);
-            std::string resolution = j.value("resolution", "120x90");
-            int fps = j.value("fps", 10);
-            
-            co_await controller_->start_streaming(camera_index, resolution, fps);
-            send_frame("CONFIG_APPLIED");
-        } 
-        else if (type == "stop" && is_controller_) 
-        {
-            co_await controller_->stop_streaming();
-            send_frame("STREAM_STOPPED");
-        }
-        else if (type == "playback_start") 
-        {
-            std::string filename = j.value("filename", "");
-            if (!filename.empty()) 
+            case ControlCommand::RecordStart: 
+                if (!is_controller_) break;
+                controller_->start_recording();
+                send_frame("RECORDING_STARTED");
+                co_return;
+            case ControlCommand::RecordStop: 
+                if (!is_controller_) break;
+                controller_->stop_recording();
+                send_frame("RECORDING_STOPPED");
+                co_return;
+            case ControlCommand::AutoRecordStart: 
+                if (!is_controller_) break;
+                controller_->enable_auto_record(
+                    msg.integer("pre_roll", 5), msg.integer("threshold", DEFAULT_ACTIVITY_THRESHOLD), msg.integer("cooldown", 10));
+                send_frame("AUTO_RECORD_ENABLED");
+                co_return;
+            case ControlCommand::AutoRecordStop: 
+                if (!is_controller_) break;
+                controller_->disable_auto_record();
+                send_frame("AUTO_RECORD_DISABLED");
+                co_return;
+            case ControlCommand::SetRenderOptions: 
             {
-                co_await controller_->start_playback(filename, shared_from_this());
-                send_frame("PLAYBACK_STARTED");
-            } 
-            else 
+                if (!is_controller_) break;
+                RenderOptions options;
+                options.tone = RenderOptions::parse_tone(msg.string("tone", "linear"));
+                options.gamma = msg.number("gamma", options.gamma);
+                options.dither = RenderOptions::parse_dither(msg.string("dither", "none"));
+                options.edges = msg.boolean("edges", options.edges);
+                options.edge_threshold = msg.integer("edge_threshold", options.edge_threshold);
+            
+                controller_->set_render_options(options);
+                send_frame("RENDER_OPTIONS_SET");
+                co_return;
+            }
+            case ControlCommand::SetTrace: 
+                trace_enabled_ = msg.boolean("enabled", false);
+                send_frame("TRACE_SET");
+                co_return;
+            case ControlCommand::SetFraming: 
             {
-                send_frame("ERROR: No filename specified");
+                const std::string_view mode = msg.string("mode", "text");
+                if (mode != "binary" && mode != "text") 
+                {
+                    send_frame("ERROR: Unknown framing mode " + std::string(mode));
+                    co_return;
+                }
+            
+                // Ответ уже уходит в новом формате
+                binary_framing_ = mode == "binary";
+                send_frame("FRAMING_SET");
+                co_return;
             }
+            case ControlCommand::Unknown: 
+                break;
         }
-        else if (type == "playback_pause") 
-        {
-            co_await controller_->pause_playback();
-            send_frame("PLAYBACK_PAUSED");
-        }
-        else if (type == "playback_resume") 
-        {
-            co_await controller_->resume_playback();
-            send_frame("PLAYBACK_RESUMED");
-        }
-        else if (type == "playback_stop") 
-        {
-            co_await controller_->stop_playback();
-            send_frame("PLAYBACK_STOPPED");
-        }
-        else if (type == "playback_speed") 
-        {
-            double speed = j.value("speed", 1.0);
-            co_await controller_->set_playback_speed(speed);
-            send_frame("PLAYBACK_SPEED_CHANGED");
-        }
-        else if (type == "record_start" && is_controller_) 
-        {
-            controller_->start_recording();
-            send_frame("RECORDING_STARTED");
-        } 
-        else if (type == "record_stop" && is_controller_) 
-        {
-            controller_->stop_recording();
-            send_frame("RECORDING_STOPPED");
-        } 
-        else 
-        {
-            send_frame("UNKNOWN_COMMAND");
-        }
+        
+        send_frame("UNKNOWN_COMMAND");
     } 
     catch (const std::exception& e) 
     {
@@ -340,4 +645,10 @@ net::awaitable<void> WebSocketSession::handle_message(const std::string& message
         std::string error_msg = "ERROR: " + std::string(e.what());
         send_frame(error_msg);
     }
-}
\ No newline at end of file
+}
+
+template class WebSocketSession<TlsStream>;
+template class WebSocketSession<PlainStream>;
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+template class WebSocketSession<LocalStream>;
+#endif
\ No newline at end of file
@@ -0,0 +1,108 @@
+#!/bin/bash
+# Ретрансляция между процессами на localhost: исходный сервер с синтетическим
+# источником, ретранслятор, подписанный на него, и зритель ретранслятора,
+# который должен получить кадры.
+#
+# Использование: relay_localhost.sh <server> <load_generator>
+
+set -u
+
+SERVER="$(realpath "$1")"
+LOAD_GENERATOR="$(realpath "$2")"
+ORIGIN_PORT="${ORIGIN_PORT:-18443}"
+RELAY_PORT="${RELAY_PORT:-18444}"
+MIN_FRAMES="${MIN_FRAMES:-5}"
+
+WORK_DIR="$(mktemp -d)"
+PIDS=()
+
+cleanup() {
+    for pid in "${PIDS[@]}"; do
+        kill "$pid" 2>/dev/null
+    done
+    wait 2>/dev/null
+    rm -rf "$WORK_DIR"
+}
+trap cleanup EXIT
+
+# Сервер читает server.crt и server.key из рабочего каталога; у каждого
+# процесса свой каталог, чтобы не делить записи и логи. Ретранслятор
+# проверяет сертификат origin, указанный как relay_ca_file
+mkdir -p "$WORK_DIR/origin" "$WORK_DIR/relay"
+if ! openssl req -x509 -newkey rsa:2048 -nodes -days 1 -subj "/CN=localhost" \
+        -addext "subjectAltName=IP:127.0.0.1,DNS:localhost" \
+        -keyout "$WORK_DIR/server.key" -out "$WORK_DIR/server.crt" 2>/dev/null; then
+    echo "Failed to generate a test certificate"
+    exit 1
+fi
+for dir in origin relay; do
+    cp "$WORK_DIR/server.crt" "$WORK_DIR/server.key" "$WORK_DIR/$dir/"
+done
+
+cat > "$WORK_DIR/origin/config.json" <<EOF
+{
+    "address": "127.0.0.1",
+    "port": $ORIGIN_PORT,
+    "enable_cloud_tunnel": false,
+    "video_backend": "synthetic",
+    "synthetic_pattern": "gradient"
+}
+EOF
+
+cat > "$WORK_DIR/relay/config.json" <<EOF
+{
+    "address": "127.0.0.1",
+    "port": $RELAY_PORT,
+    "enable_cloud_tunnel": false,
+    "relay_upstream": "127.0.0.1:$ORIGIN_PORT",
+    "relay_ca_file": "server.crt"
+}
+EOF
+
+# Ожидание, пока сервер начнет принимать соединения
+wait_for_port() {
+    local port=$1
+    for _ in $(seq 1 50); do
+        if (exec 3<>"/dev/tcp/127.0.0.1/$port") 2>/dev/null; then
+            return 0
+        fi
+        sleep 0.2
+    done
+    echo "Server on port $port did not start"
+    return 1
+}
+
+start_server() {
+    local dir=$1
+    (cd "$WORK_DIR/$dir" && exec "$SERVER" config.json > server.out 2>&1) &
+    PIDS+=($!)
+}
+
+start_server origin
+wait_for_port "$ORIGIN_PORT" || { cat "$WORK_DIR/origin/server.out"; exit 1; }
+start_server relay
+wait_for_port "$RELAY_PORT" || { cat "$WORK_DIR/relay/server.out"; exit 1; }
+
+# Controller исходного сервера запускает трансляцию и держит ее, пока
+# зрители ретранслятора измеряют
+"$LOAD_GENERATOR" --port "$ORIGIN_PORT" --connections 1 --duration 8 --no-trace --summary-only \
+    > "$WORK_DIR/controller.out" 2>&1 &
+CONTROLLER_PID=$!
+PIDS+=($CONTROLLER_PID)
+sleep 1
+
+"$LOAD_GENERATOR" --port "$RELAY_PORT" --connections 2 --duration 4 --no-start --no-trace \
+    --min-frames "$MIN_FRAMES"
+STATUS=$?
+
+wait "$CONTROLLER_PID"
+
+if [ $STATUS -ne 0 ]; then
+    echo
+    echo "Origin log:"
+    cat "$WORK_DIR/origin/server.out"
+    echo
+    echo "Relay log:"
+    cat "$WORK_DIR/relay/server.out"
+fi
+exit $STATUS
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "admission_controller.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+TEST(AdmissionControllerTest, LimitsConnectionsAndReleasesSlots) 
+{
+    AdmissionLimits limits;
+    limits.max_connections = 2;
+    limits.max_handshakes = 1;
+    auto admission = std::make_shared<AdmissionController>(limits);
+    
+    auto first = admission->admit_connection("10.0.0.1");
+    auto second = admission->admit_connection("10.0.0.2");
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(second);
+    EXPECT_FALSE(admission->admit_connection("10.0.0.3"));
+    
+    auto handshake = admission->begin_handshake();
+    EXPECT_TRUE(handshake);
+    EXPECT_FALSE(admission->begin_handshake());
+    handshake.release();
+    EXPECT_TRUE(admission->begin_handshake());
+    
+    // Место освобождается вместе с сессией, которая держит Slot
+    first = {};
+    EXPECT_EQ(admission->active(AdmissionController::Resource::Connection), 1u);
+    EXPECT_TRUE(admission->admit_connection("10.0.0.3"));
+}
+
+TEST(AdmissionControllerTest, RateLimitsNewConnectionsPerAddress) 
+{
+    AdmissionLimits limits;
+    limits.connections_per_second = 2;
+    limits.connection_burst = 3;
+    auto admission = std::make_shared<AdmissionController>(limits);
+    const auto now = AdmissionController::Clock::now();
+    
+    for (int i = 0; i < 3; ++i) 
+    {
+        EXPECT_TRUE(admission->admit_connection("10.0.0.1", now));
+    }
+    EXPECT_FALSE(admission->admit_connection("10.0.0.1", now));
+    // Другие адреса и loopback не затронуты
+    EXPECT_TRUE(admission->admit_connection("10.0.0.2", now));
+    EXPECT_TRUE(admission->admit_connection("127.0.0.1", now));
+    
+    // За полсекунды корзина пополняется на один токен
+    EXPECT_TRUE(admission->admit_connection("10.0.0.1", now + 500ms));
+    EXPECT_FALSE(admission->admit_connection("10.0.0.1", now + 500ms));
+}
+
+TEST(AdmissionControllerTest, LocksOutAddressAfterAuthFailures) 
+{
+    AdmissionLimits limits;
+    limits.max_auth_failures = 3;
+    limits.auth_lockout = 60s;
+    auto admission = std::make_shared<AdmissionController>(limits);
+    const auto now = AdmissionController::Clock::now();
+    
+    admission->record_auth_failure("10.0.0.1", now);
+    admission->record_auth_failure("10.0.0.1", now + 1s);
+    EXPECT_TRUE(admission->auth_allowed("10.0.0.1", now + 1s));
+    
+    admission->record_auth_failure("10.0.0.1", now + 2s);
+    EXPECT_FALSE(admission->auth_allowed("10.0.0.1", now + 2s));
+    EXPECT_FALSE(admission->admit_connection("10.0.0.1", now + 2s));
+    
+    EXPECT_TRUE(admission->auth_allowed("10.0.0.1", now + 63s));
+    EXPECT_TRUE(admission->admit_connection("10.0.0.1", now + 63s));
+}
+
+TEST(AdmissionControllerTest, LimitsOpenConnectionsPerAddress) 
+{
+    AdmissionLimits limits;
+    limits.max_connections_per_ip = 2;
+    auto admission = std::make_shared<AdmissionController>(limits);
+    
+    auto first = admission->admit_connection("10.0.0.1");
+    auto second = admission->admit_connection("10.0.0.1");
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(second);
+    EXPECT_FALSE(admission->admit_connection("10.0.0.1"));
+    EXPECT_TRUE(admission->admit_connection("10.0.0.2"));
+    EXPECT_TRUE(admission->admit_connection("127.0.0.1"));
+    
+    // Перемещенный Slot освобождает место адреса один раз
+    auto moved = std::move(first);
+    moved = {};
+    EXPECT_TRUE(admission->admit_connection("10.0.0.1"));
+}
+
+TEST(AdmissionControllerTest, BoundsTrackedAddresses) 
+{
+    AdmissionLimits limits;
+    limits.connections_per_second = 1;
+    limits.connection_burst = 1;
+    auto admission = std::make_shared<AdmissionController>(limits);
+    const auto now = AdmissionController::Clock::now();
+    
+    // Корзины всех адресов пусты, поэтому prune ничего не освобождает
+    for (int i = 0; i < 5000; ++i) 
+    {
+        admission->admit_connection("10." + std::to_string(i / 256) + ".0." + std::to_string(i % 256), now);
+    }
+    EXPECT_LE(admission->tracked_peers(), 4096u);
+}
\ No newline at end of file
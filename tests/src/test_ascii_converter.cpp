@@ -3,6 +3,8 @@
 
 #include <gtest/gtest.h>
 #include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <limits>
 
 class AsciiConverterTest : public ::testing::Test 
 {
@@ -63,3 +65,138 @@ TEST_F(AsciiConverterTest, HandlesNoAsciiCharsSet)
     std::string result = no_chars_converter.convert(test_image, 2, 2);
     EXPECT_EQ(result, "CONFIG ERROR");
 }
+
+TEST_F(AsciiConverterTest, ParallelBandsMatchSerialConversion) 
+{
+    cv::Mat large(480, 640, CV_8UC3);
+    cv::RNG rng(42);
+    rng.fill(large, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(256));
+    
+    AsciiConverter serial;
+    serial.set_parallel_threshold(std::numeric_limits<size_t>::max());
+    AsciiConverter parallel;
+    parallel.set_parallel_threshold(0);
+    
+    std::string expected = serial.convert(large, 320, 240);
+    std::string result = parallel.convert(large, 320, 240);
+    
+    ASSERT_EQ(result.size(), 240u * 321u);
+    EXPECT_EQ(result, expected);
+}
+
+TEST_F(AsciiConverterTest, FixedWidthKernelsMatchGenericMapping) 
+{
+    const std::string chars = "@%#*+=-:. ";
+    converter.set_ascii_chars(chars);
+    
+    // 81 - ширина без специализации
+    for (int width : {80, 81, 120, 160, 320}) 
+    {
+        cv::Mat frame(4, width, CV_8UC1);
+        std::string expected;
+        for (int y = 0; y < frame.rows; ++y) 
+        {
+            for (int x = 0; x < width; ++x) 
+            {
+                uchar value = static_cast<uchar>((x * 7 + y * 13) & 0xFF);
+                frame.at<uchar>(y, x) = value;
+                expected += chars[static_cast<int>(value / (255.0 / 9) + 0.5)];
+            }
+            expected += '\n';
+        }
+        
+        EXPECT_EQ(converter.convert(frame, width, 4), expected) << "width " << width;
+    }
+}
+
+TEST_F(AsciiConverterTest, CharsetChangeTakesEffectImmediately) 
+{
+    std::string before = converter.convert(test_image, 2, 2);
+    converter.set_ascii_chars("01");
+    std::string after = converter.convert(test_image, 2, 2);
+    
+    EXPECT_EQ(before, "@+\n: \n");
+    EXPECT_EQ(after, "00\n11\n");
+}
+
+TEST_F(AsciiConverterTest, GammaBrightensShadows) 
+{
+    cv::Mat dark(4, 4, CV_8UC1, cv::Scalar(40));
+    std::string linear = converter.convert(dark, 4, 4);
+    
+    RenderOptions options;
+    options.tone = RenderOptions::Tone::Gamma;
+    converter.set_render_options(options);
+    std::string corrected = converter.convert(dark, 4, 4);
+    
+    // Символы упорядочены от темного к светлому
+    const std::string chars = "@%#*+=-:. ";
+    EXPECT_GT(chars.find(corrected[0]), chars.find(linear[0]));
+}
+
+TEST_F(AsciiConverterTest, OrderedDitherMixesNeighbouringGlyphs) 
+{
+    converter.set_ascii_chars("01");
+    RenderOptions options;
+    options.dither = RenderOptions::Dither::Ordered;
+    converter.set_render_options(options);
+    
+    cv::Mat gray(8, 8, CV_8UC1, cv::Scalar(128));
+    std::string result = converter.convert(gray, 8, 8);
+    
+    auto ones = std::count(result.begin(), result.end(), '1');
+    EXPECT_GE(ones, 28);
+    EXPECT_LE(ones, 36);
+}
+
+TEST_F(AsciiConverterTest, FloydSteinbergPreservesAverageBrightness) 
+{
+    converter.set_ascii_chars("01");
+    RenderOptions options;
+    options.dither = RenderOptions::Dither::FloydSteinberg;
+    converter.set_render_options(options);
+    
+    cv::Mat gray(16, 16, CV_8UC1, cv::Scalar(64));
+    std::string result = converter.convert(gray, 16, 16);
+    
+    // 64 / 255 ~ четверть клеток светлые
+    auto ones = std::count(result.begin(), result.end(), '1');
+    EXPECT_NEAR(static_cast<double>(ones) / 256, 64.0 / 255, 0.05);
+}
+
+TEST_F(AsciiConverterTest, EdgesUseDirectionalGlyphs) 
+{
+    RenderOptions options;
+    options.edges = true;
+    converter.set_render_options(options);
+    
+    // Левая половина черная, правая белая: вертикальная граница
+    cv::Mat split(8, 8, CV_8UC1, cv::Scalar(0));
+    split(cv::Rect(4, 0, 4, 8)).setTo(cv::Scalar(255));
+    std::string vertical = converter.convert(split, 8, 8);
+    
+    EXPECT_NE(vertical.find('|'), std::string::npos);
+    EXPECT_EQ(vertical.find('-'), std::string::npos);
+    
+    std::string rotated = converter.convert(split.t(), 8, 8);
+    EXPECT_NE(rotated.find('-'), std::string::npos);
+    EXPECT_EQ(rotated.find('|'), std::string::npos);
+}
+
+TEST_F(AsciiConverterTest, ReportsStageTimings) 
+{
+    RenderOptions options;
+    options.tone = RenderOptions::Tone::Equalize;
+    options.dither = RenderOptions::Dither::FloydSteinberg;
+    options.edges = true;
+    converter.set_render_options(options);
+    
+    cv::Mat frame(480, 640, CV_8UC3);
+    cv::RNG rng(7);
+    rng.fill(frame, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(256));
+    converter.convert(frame, 320, 240);
+    
+    StageTimings timings = converter.last_timings();
+    EXPECT_GT(timings.total.count(), 0);
+    EXPECT_GE(timings.total, timings.resize + timings.tone + timings.dither + timings.map + timings.edges);
+}
\ No newline at end of file
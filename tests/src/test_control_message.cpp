@@ -0,0 +1,54 @@
+#include "control_message.hpp"
+
+#include <gtest/gtest.h>
+
+TEST(ControlMessageTest, ParsesCommandFields) 
+{
+    const std::string text = 
+        R"({ "type": "set_render_options", "tone": "gamma", "gamma": 1.8, "edges": true, "edge_threshold": 150 })";
+    
+    ControlMessage message;
+    ASSERT_TRUE(message.parse(text));
+    EXPECT_EQ(message.command(), ControlCommand::SetRenderOptions);
+    EXPECT_EQ(message.string("tone"), "gamma");
+    EXPECT_DOUBLE_EQ(message.number("gamma", 2.2), 1.8);
+    EXPECT_TRUE(message.boolean("edges", false));
+    EXPECT_EQ(message.integer("edge_threshold", 200), 150);
+    
+    // Значения указывают в исходный текст без копирования
+    const std::string_view tone = message.string("tone");
+    EXPECT_GE(tone.data(), text.data());
+    EXPECT_LT(tone.data(), text.data() + text.size());
+    
+    // Отсутствующие поля и поля другого типа - значения по умолчанию
+    EXPECT_EQ(message.string("dither", "none"), "none");
+    EXPECT_EQ(message.integer("tone", 7), 7);
+    EXPECT_FALSE(message.boolean("gamma", false));
+}
+
+TEST(ControlMessageTest, DecodesEscapedStrings) 
+{
+    ControlMessage message;
+    ASSERT_TRUE(message.parse(R"({"type":"playback_start","filename":"a\\b \"c\" \u00e9\ud83d\ude00","speed":2})"));
+    EXPECT_EQ(message.command(), ControlCommand::PlaybackStart);
+    EXPECT_EQ(message.string("filename"), "a\\b \"c\" \xc3\xa9\xf0\x9f\x98\x80");
+    EXPECT_EQ(message.integer("speed", 1), 2);
+    EXPECT_DOUBLE_EQ(message.number("speed", 1.0), 2.0);
+}
+
+TEST(ControlMessageTest, RejectsMalformedAndUnknownCommands) 
+{
+    ControlMessage message;
+    EXPECT_FALSE(message.parse("not json"));
+    EXPECT_FALSE(message.parse(R"({"type":"auth")"));
+    EXPECT_FALSE(message.parse(R"({"type":"auth"} trailing)"));
+    EXPECT_FALSE(message.parse(R"({"type":"auth","nested":{"a":1}})"));
+    EXPECT_FALSE(message.parse(R"({"type":"bad\q"})"));
+    
+    ASSERT_TRUE(message.parse(R"({"type":"reboot"})"));
+    EXPECT_EQ(message.command(), ControlCommand::Unknown);
+    EXPECT_EQ(message.type(), "reboot");
+    
+    ASSERT_TRUE(message.parse("{}"));
+    EXPECT_EQ(message.command(), ControlCommand::Unknown);
+}
\ No newline at end of file
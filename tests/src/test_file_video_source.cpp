@@ -0,0 +1,147 @@
+#include "file_video_source.hpp"
+
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <filesystem>
+#include <thread>
+
+class FileVideoSourceTest : public ::testing::Test 
+{
+protected:
+    std::filesystem::path dir;
+    std::vector<int> values{10, 120, 240};
+
+    void SetUp() override 
+    {
+        dir = std::filesystem::temp_directory_path() / "file_video_source_test";
+        std::filesystem::create_directories(dir);
+
+        // Последовательность изображений разной яркости
+        for (size_t i = 0; i < values.size(); ++i) 
+        {
+            cv::Mat image(48, 64, CV_8UC3, cv::Scalar::all(values[i]));
+            char name[32];
+            std::snprintf(name, sizeof(name), "img_%03zu.png", i);
+            cv::imwrite((dir / name).string(), image);
+        }
+    }
+
+    void TearDown() override 
+    {
+        std::filesystem::remove_all(dir);
+    }
+
+    std::string pattern() const 
+    {
+        return (dir / "img_%03d.png").string();
+    }
+
+    // capture_frame не ждет декодер, поэтому опрашиваем, пока не придет
+    // кадр с другой яркостью
+    static cv::Mat capture_new(FileVideoSource& source, int previous = -1) 
+    {
+        cv::Mat frame;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (std::chrono::steady_clock::now() < deadline) 
+        {
+            source.capture_frame(frame);
+            if (!frame.empty() && frame.ptr<uchar>(0)[0] != previous) 
+            {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return frame;
+    }
+};
+
+TEST_F(FileVideoSourceTest, LoopsOverImageSequence) 
+{
+    FileVideoSource source(pattern(), -1);
+    source.set_resolution(64, 48);
+    source.open(0);
+
+    int previous = -1;
+    for (size_t i = 0; i < values.size() * 2; ++i) 
+    {
+        cv::Mat frame = capture_new(source, previous);
+        ASSERT_FALSE(frame.empty()) << "frame " << i;
+        EXPECT_EQ(frame.ptr<uchar>(0)[0], values[i % values.size()]) << "frame " << i;
+        previous = frame.ptr<uchar>(0)[0];
+    }
+}
+
+TEST_F(FileVideoSourceTest, RepeatsLastFrameWithoutWaiting) 
+{
+    FileVideoSource source(pattern(), 5);
+    source.set_resolution(64, 48);
+    source.open(0);
+
+    cv::Mat first = capture_new(source);
+    ASSERT_FALSE(first.empty());
+
+    // Следующий кадр будет готов только через 200 мс
+    auto start = std::chrono::steady_clock::now();
+    cv::Mat again = source.capture_frame();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+    ASSERT_FALSE(again.empty());
+    EXPECT_EQ(again.ptr<uchar>(0)[0], first.ptr<uchar>(0)[0]);
+    // Повтор выдается без копирования
+    EXPECT_EQ(again.data, first.data);
+}
+
+TEST_F(FileVideoSourceTest, HeldFrameIsNotOverwrittenByDecoder) 
+{
+    FileVideoSource source(pattern(), -1, 2);
+    source.set_resolution(64, 48);
+    source.open(0);
+
+    cv::Mat held = capture_new(source);
+    ASSERT_FALSE(held.empty());
+    const int value = held.ptr<uchar>(0)[0];
+
+    // Кольцо из двух слотов успевает обернуться много раз
+    cv::Mat frame;
+    int previous = value;
+    for (int i = 0; i < 10; ++i) 
+    {
+        frame = capture_new(source, previous);
+        previous = frame.ptr<uchar>(0)[0];
+    }
+
+    // Кадры одноцветные, поэтому достаточно первого и последнего пикселя
+    EXPECT_EQ(held.ptr<uchar>(0)[0], value);
+    EXPECT_EQ(held.ptr<uchar>(held.rows - 1)[held.cols * 3 - 1], value);
+}
+
+TEST_F(FileVideoSourceTest, ResizesToRequestedResolution) 
+{
+    FileVideoSource source(pattern(), -1);
+    source.set_resolution(32, 24);
+    source.open(0);
+
+    cv::Mat frame = capture_new(source);
+
+    EXPECT_EQ(frame.cols, 32);
+    EXPECT_EQ(frame.rows, 24);
+}
+
+TEST_F(FileVideoSourceTest, OpenFailsForMissingFile) 
+{
+    FileVideoSource source((dir / "missing.avi").string(), -1);
+
+    EXPECT_THROW(source.open(0), std::runtime_error);
+    EXPECT_FALSE(source.is_available());
+}
+
+TEST_F(FileVideoSourceTest, CloseStopsDecoder) 
+{
+    FileVideoSource source(pattern(), -1);
+    source.open(0);
+    source.capture_frame();
+
+    source.close();
+
+    EXPECT_FALSE(source.is_available());
+    EXPECT_TRUE(source.capture_frame().empty());
+}
\ No newline at end of file
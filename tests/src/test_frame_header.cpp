@@ -0,0 +1,59 @@
+#include "frame_header.hpp"
+
+#include <gtest/gtest.h>
+
+TEST(FrameHeaderTest, DescribesAsciiFrame) 
+{
+    const std::string frame = "@@%%\n#*+=\n-:. \n";
+    const FrameHeader header = encode_frame_header(MessageType::Frame, frame, {}, false, FrameTrace::Clock::now());
+    
+    FrameHeaderFields fields;
+    ASSERT_TRUE(decode_frame_header(header.data(), header.size(), fields));
+    EXPECT_EQ(fields.type, MessageType::Frame);
+    EXPECT_EQ(fields.encoding, PayloadEncoding::Ascii);
+    EXPECT_EQ(fields.width, 4);
+    EXPECT_EQ(fields.height, 3);
+    EXPECT_EQ(fields.payload_size, frame.size());
+    // Без трассировки номер кадра не передается
+    EXPECT_EQ(fields.flags, 0);
+    EXPECT_EQ(fields.sequence, 0u);
+}
+
+TEST(FrameHeaderTest, CountsUtf8WidthInCharacters) 
+{
+    // Два символа Брайля по 3 байта в каждой строке
+    const std::string frame = "⣿⠀\n⠀⣿\n";
+    const FrameHeader header = encode_frame_header(MessageType::Frame, frame, {}, false, FrameTrace::Clock::now());
+    
+    FrameHeaderFields fields;
+    ASSERT_TRUE(decode_frame_header(header.data(), header.size(), fields));
+    EXPECT_EQ(fields.encoding, PayloadEncoding::Utf8);
+    EXPECT_EQ(fields.width, 2);
+    EXPECT_EQ(fields.height, 2);
+}
+
+TEST(FrameHeaderTest, EchoedTracedHeaderDecodes) 
+{
+    const auto now = FrameTrace::Clock::now();
+    FrameTrace trace;
+    trace.sequence = 42;
+    trace.captured_at = now - std::chrono::milliseconds(5);
+    
+    const FrameHeader header = encode_frame_header(MessageType::Frame, "ab\n", trace, true, now);
+    
+    TraceEcho echo;
+    ASSERT_TRUE(decode_frame_header_echo(header.data(), header.size(), echo));
+    EXPECT_EQ(echo.sequence, 42u);
+    EXPECT_EQ(echo.pipeline, std::chrono::milliseconds(5));
+    
+    // Заголовок без флага трассировки и служебные ответы эхом не считаются
+    const FrameHeader untraced = encode_frame_header(MessageType::Frame, "ab\n", trace, false, now);
+    EXPECT_FALSE(decode_frame_header_echo(untraced.data(), untraced.size(), echo));
+    const FrameHeader control = encode_frame_header(MessageType::Control, "TRACE_SET", {}, false, now);
+    EXPECT_FALSE(decode_frame_header_echo(control.data(), control.size(), echo));
+    
+    FrameHeaderFields fields;
+    ASSERT_TRUE(decode_frame_header(control.data(), control.size(), fields));
+    EXPECT_EQ(fields.type, MessageType::Control);
+    EXPECT_EQ(fields.width, 0);
+}
\ No newline at end of file
@@ -0,0 +1,208 @@
+#include "frame_pool.hpp"
+#include "frame_activity.hpp"
+#include "ascii_converter.hpp"
+#include "video_source_interface.hpp"
+
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Счетчик выделений через operator new. Считаются только выделения,
+// сделанные, пока включен флаг, чтобы не мешать остальным тестам.
+static std::atomic<bool> g_count_allocations{false};
+static std::atomic<size_t> g_allocations{0};
+
+void* operator new(std::size_t size) 
+{
+    if (g_count_allocations.load(std::memory_order_relaxed)) 
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    if (void* ptr = std::malloc(size ? size : 1)) 
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept 
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept 
+{
+    std::free(ptr);
+}
+
+// Данные cv::Mat выделяются через cv::fastMalloc в обход operator new,
+// поэтому выделения матриц считаются отдельным аллокатором по умолчанию
+static std::atomic<size_t> g_mat_allocations{0};
+
+class CountingMatAllocator : public cv::MatAllocator 
+{
+public:
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step, 
+                           cv::AccessFlag flags, cv::UMatUsageFlags usage) const override 
+    {
+        if (g_count_allocations.load(std::memory_order_relaxed)) 
+        {
+            g_mat_allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        // UMatData запоминает стандартный аллокатор, он же потом освобождает память
+        return cv::Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usage);
+    }
+    
+    bool allocate(cv::UMatData* data, cv::AccessFlag flags, cv::UMatUsageFlags usage) const override 
+    {
+        return cv::Mat::getStdAllocator()->allocate(data, flags, usage);
+    }
+    
+    void deallocate(cv::UMatData* data) const override 
+    {
+        cv::Mat::getStdAllocator()->deallocate(data);
+    }
+};
+
+// Источник, который перерисовывает кадр в уже выделенном буфере
+class PatternVideoSource : public IVideoSource 
+{
+public:
+    bool is_available() const override { return true; }
+    void set_resolution(int width, int height) override { width_ = width; height_ = height; }
+    void open(int) override {}
+    void close() override {}
+    
+    void capture_frame(cv::Mat& frame) override 
+    {
+        frame.create(height_, width_, CV_8UC3);
+        for (int y = 0; y < frame.rows; ++y) 
+        {
+            uchar* row = frame.ptr<uchar>(y);
+            for (int x = 0; x < frame.cols * 3; ++x) 
+            {
+                row[x] = static_cast<uchar>(x + y + tick_);
+            }
+        }
+        tick_ += 7;
+    }
+    
+private:
+    int width_{240};
+    int height_{180};
+    int tick_{0};
+};
+
+TEST(FramePoolTest, ReusesReleasedBuffers) 
+{
+    FramePool pool(2);
+    
+    FrameBuffer* first = nullptr;
+    {
+        auto buffer = pool.acquire();
+        first = buffer.get();
+    }
+    
+    auto a = pool.acquire();
+    auto b = pool.acquire();
+    EXPECT_TRUE(a.get() == first || b.get() == first);
+    EXPECT_EQ(pool.size(), 2u);
+}
+
+TEST(FramePoolTest, GrowsWhenAllBuffersAreHeld) 
+{
+    FramePool pool(2);
+    
+    auto a = pool.acquire();
+    auto b = pool.acquire();
+    auto c = pool.acquire();
+    
+    EXPECT_NE(a.get(), c.get());
+    EXPECT_NE(b.get(), c.get());
+    EXPECT_EQ(pool.size(), 3u);
+}
+
+TEST(FramePoolTest, StopsGrowingAtMaxSize) 
+{
+    FramePool pool(1, 2);
+    
+    auto a = pool.acquire();
+    auto b = pool.acquire();
+    auto c = pool.acquire();
+    EXPECT_EQ(pool.size(), 2u);
+    
+    // Временный буфер не попадает в пул и освобождается вместе с кадром
+    FrameBuffer* temporary = c.get();
+    c.reset();
+    a.reset();
+    auto d = pool.acquire();
+    EXPECT_NE(d.get(), temporary);
+    EXPECT_EQ(pool.size(), 2u);
+}
+
+TEST(FramePoolTest, SteadyStateCaptureAndConvertDoNotAllocate) 
+{
+    // Проверяются захват в буфер из пула, конвертация и оценка активности.
+    // Рассылка зрителям и очередь отправки WebSocketSession сюда не входят.
+    // Пул потоков OpenCV создает задание на каждый параллельный вызов,
+    // здесь проверяются только выделения самого конвейера
+    cv::setNumThreads(1);
+    CountingMatAllocator mat_allocator;
+    cv::MatAllocator* default_allocator = cv::Mat::getDefaultAllocator();
+    cv::Mat::setDefaultAllocator(&mat_allocator);
+    
+    PatternVideoSource source;
+    AsciiConverter converter;
+    FramePool pool(4);
+    std::shared_ptr<FrameBuffer> last;
+    std::shared_ptr<const std::string> in_flight;
+    
+    auto run_frame = [&] {
+        auto buffer = pool.acquire();
+        source.capture_frame(buffer->image);
+        converter.convert(buffer->image, 120, 90, buffer->ascii);
+        int activity = last ? frame_activity(last->ascii, buffer->ascii) : 1000;
+        EXPECT_GT(activity, 0);
+        
+        // Имитация зрителя, у которого кадр стоит в очереди
+        in_flight = std::shared_ptr<const std::string>(buffer, &buffer->ascii);
+        last = std::move(buffer);
+    };
+    
+    for (int i = 0; i < 10; ++i) 
+    {
+        run_frame();
+    }
+    
+    const uchar* image_data = last->image.data;
+    const char* ascii_data = last->ascii.data();
+    
+    g_allocations = 0;
+    g_mat_allocations = 0;
+    g_count_allocations = true;
+    for (int i = 0; i < 100; ++i) 
+    {
+        run_frame();
+    }
+    g_count_allocations = false;
+    
+    EXPECT_EQ(g_allocations.load(), 0u);
+    // Кадр источника и промежуточные матрицы конвертера тоже переиспользуются
+    EXPECT_EQ(g_mat_allocations.load(), 0u);
+    EXPECT_EQ(pool.size(), 4u);
+    
+    // Буферы изображения и строки переиспользуются, а не выделяются заново
+    bool reused = false;
+    for (int i = 0; i < 4 && !reused; ++i) 
+    {
+        run_frame();
+        reused = last->image.data == image_data && last->ascii.data() == ascii_data;
+    }
+    EXPECT_TRUE(reused);
+    
+    cv::Mat::setDefaultAllocator(default_allocator);
+    cv::setNumThreads(-1);
+}
@@ -0,0 +1,35 @@
+#include "frame_trace.hpp"
+
+#include <gtest/gtest.h>
+
+TEST(FrameTraceTest, EchoedHeaderDecodesToSentValues) 
+{
+    const auto now = FrameTrace::Clock::now();
+    FrameTrace trace;
+    trace.sequence = 0x0102030405060708ULL;
+    trace.captured_at = now - std::chrono::milliseconds(3);
+    
+    const TraceHeader header = encode_trace_header(trace, now);
+    
+    // Little-endian: младший байт номера кадра первый
+    EXPECT_EQ(header[0], 0x08);
+    EXPECT_EQ(header[7], 0x01);
+    // От захвата до отправки 3000 мкс
+    EXPECT_EQ(header[16] | (header[17] << 8), 3000);
+    
+    TraceEcho echo;
+    ASSERT_TRUE(decode_trace_echo(header.data(), header.size(), echo));
+    EXPECT_EQ(echo.sequence, trace.sequence);
+    EXPECT_EQ(echo.pipeline, std::chrono::milliseconds(3));
+    EXPECT_EQ(std::chrono::duration_cast<std::chrono::microseconds>(echo.sent_at - now).count(), 0);
+}
+
+TEST(FrameTraceTest, RejectsMalformedEcho) 
+{
+    TraceHeader header{};
+    TraceEcho echo;
+    
+    EXPECT_FALSE(decode_trace_echo(header.data(), header.size() - 1, echo));
+    // Нулевой номер - кадр без трассировки
+    EXPECT_FALSE(decode_trace_echo(header.data(), header.size(), echo));
+}
\ No newline at end of file
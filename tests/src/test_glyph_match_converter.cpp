@@ -0,0 +1,60 @@
+#include "glyph_match_converter.hpp"
+
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+
+class GlyphMatchConverterTest : public ::testing::Test 
+{
+protected:
+    GlyphMatchConverter converter;
+};
+
+TEST_F(GlyphMatchConverterTest, ProducesRowsOfRequestedWidth) 
+{
+    cv::Mat frame(480, 640, CV_8UC3, cv::Scalar(128, 128, 128));
+    std::string result = converter.convert(frame, 80, 60);
+    
+    ASSERT_EQ(result.size(), 60u * 81u);
+    for (int y = 0; y < 60; ++y) 
+    {
+        EXPECT_EQ(result[y * 81 + 80], '\n');
+    }
+}
+
+TEST_F(GlyphMatchConverterTest, WhiteCellsBecomeSpaces) 
+{
+    cv::Mat white(40, 20, CV_8UC1, cv::Scalar(255));
+    EXPECT_EQ(converter.convert(white, 2, 2), "  \n  \n");
+    
+    cv::Mat black(40, 20, CV_8UC1, cv::Scalar(0));
+    std::string dark = converter.convert(black, 2, 2);
+    EXPECT_EQ(dark.find(' '), std::string::npos);
+}
+
+TEST_F(GlyphMatchConverterTest, MatchesGlyphByShape) 
+{
+    // Все четыре символа одинаково "светлые", различаются только формой
+    const std::string glyphs = "/\\|-";
+    converter.set_ascii_chars(glyphs + " ");
+    auto vectors = GlyphMatchConverter::render_glyphs(glyphs + " ");
+    
+    for (size_t g = 0; g < glyphs.size(); ++g) 
+    {
+        // Клетка из отсчетов самого символа: разрешение совпадает с сеткой 2x4
+        cv::Mat cell(GlyphMatchConverter::CELL_HEIGHT, GlyphMatchConverter::CELL_WIDTH, CV_8UC1);
+        for (int i = 0; i < GlyphMatchConverter::SAMPLES; ++i) 
+        {
+            cell.at<uchar>(i / GlyphMatchConverter::CELL_WIDTH, i % GlyphMatchConverter::CELL_WIDTH) = vectors[g][i];
+        }
+        
+        std::string result = converter.convert(cell, 1, 1);
+        EXPECT_EQ(result[0], glyphs[g]) << "glyph " << glyphs[g];
+    }
+}
+
+TEST_F(GlyphMatchConverterTest, EmptyCharsetIsReported) 
+{
+    converter.set_ascii_chars("");
+    cv::Mat frame(40, 20, CV_8UC1, cv::Scalar(255));
+    EXPECT_EQ(converter.convert(frame, 2, 2), "CONFIG ERROR");
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "latest_value_slot.hpp"
+
+#include <gtest/gtest.h>
+#include <thread>
+
+TEST(LatestValueSlotTest, ReaderSeesOnlyLatestValue) 
+{
+    LatestValueSlot<int> slot;
+    EXPECT_FALSE(slot.update());
+
+    slot.back() = 1;
+    slot.publish();
+    slot.back() = 2;
+    slot.publish();
+
+    ASSERT_TRUE(slot.update());
+    EXPECT_EQ(slot.front(), 2);
+
+    // Повторно то же значение не выдается
+    EXPECT_FALSE(slot.update());
+    EXPECT_EQ(slot.front(), 2);
+}
+
+TEST(LatestValueSlotTest, InterruptWakesWaitingReader) 
+{
+    LatestValueSlot<int> slot;
+
+    std::thread reader([&slot] { slot.wait_for_fresh(); });
+    slot.interrupt();
+    reader.join();
+
+    SUCCEED();
+}
+
+TEST(LatestValueSlotTest, ConcurrentReaderNeverSeesTornOrStaleValues) 
+{
+    struct Pair { long long first; long long second; };
+
+    LatestValueSlot<Pair> slot;
+    const long long last = 200000;
+
+    std::thread writer([&slot, last] {
+        for (long long i = 1; i <= last; ++i) 
+        {
+            slot.back() = {i, -i};
+            slot.publish();
+        }
+    });
+
+    long long seen = 0;
+    while (seen < last) 
+    {
+        slot.wait_for_fresh();
+        ASSERT_TRUE(slot.update());
+
+        const Pair& value = slot.front();
+        ASSERT_EQ(value.first, -value.second);
+        ASSERT_GT(value.first, seen);
+        seen = value.first;
+    }
+
+    writer.join();
+}
\ No newline at end of file
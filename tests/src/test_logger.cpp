@@ -0,0 +1,30 @@
+#include "logger.hpp"
+
+#include <gtest/gtest.h>
+#include <thread>
+
+TEST(LogThrottleTest, AllowsOneMessagePerInterval) 
+{
+    LogThrottle throttle(std::chrono::milliseconds(50));
+    uint64_t suppressed = 0;
+    
+    EXPECT_TRUE(throttle.allow(suppressed));
+    EXPECT_EQ(suppressed, 0u);
+    EXPECT_FALSE(throttle.allow(suppressed));
+    EXPECT_FALSE(throttle.allow(suppressed));
+    
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    
+    // Следующее сообщение сообщает, сколько было пропущено
+    EXPECT_TRUE(throttle.allow(suppressed));
+    EXPECT_EQ(suppressed, 2u);
+}
+
+TEST(LogThrottleTest, RateLimitedWarningDoesNotThrow) 
+{
+    for (int i = 0; i < 100; ++i) 
+    {
+        LOG_WARN_RATE_LIMITED("Rate limited warning {}", i);
+    }
+    SUCCEED();
+}
\ No newline at end of file
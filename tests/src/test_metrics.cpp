@@ -0,0 +1,78 @@
+#include "metrics.hpp"
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+TEST(MetricsTest, CounterSumsAllThreadShards) 
+{
+    metrics::Counter counter("test_counter_total", "Test counter");
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) 
+    {
+        threads.emplace_back([&counter] {
+            for (int i = 0; i < 10000; ++i) 
+            {
+                counter.inc();
+            }
+        });
+    }
+    for (auto& thread : threads) 
+    {
+        thread.join();
+    }
+    
+    EXPECT_EQ(counter.value(), 80000u);
+}
+
+TEST(MetricsTest, HistogramBucketsAreCumulative) 
+{
+    metrics::Histogram histogram("test_histogram", "Test histogram", {10, 100});
+    histogram.observe(uint64_t{5});
+    histogram.observe(uint64_t{10});
+    histogram.observe(uint64_t{50});
+    histogram.observe(uint64_t{1000});
+    
+    auto snapshot = histogram.snapshot();
+    ASSERT_EQ(snapshot.cumulative.size(), 3u);
+    EXPECT_EQ(snapshot.cumulative[0], 2u);
+    EXPECT_EQ(snapshot.cumulative[1], 3u);
+    EXPECT_EQ(snapshot.cumulative[2], 4u);
+    EXPECT_EQ(snapshot.count, 4u);
+    EXPECT_EQ(snapshot.sum, 1065u);
+}
+
+TEST(MetricsTest, EstimatesQuantilesWithinBuckets) 
+{
+    metrics::Histogram histogram("test_quantiles", "Test quantiles", {100, 200});
+    for (uint64_t value = 1; value <= 100; ++value) 
+    {
+        histogram.observe(value <= 50 ? uint64_t{50} : uint64_t{150});
+    }
+    
+    auto snapshot = histogram.snapshot();
+    EXPECT_DOUBLE_EQ(histogram.quantile(snapshot, 0.0), 0.0);
+    EXPECT_NEAR(histogram.quantile(snapshot, 0.5), 100.0, 1e-9);
+    EXPECT_NEAR(histogram.quantile(snapshot, 0.99), 198.0, 1e-9);
+}
+
+TEST(MetricsTest, RendersPrometheusText) 
+{
+    auto& registry = metrics::Registry::get();
+    auto& counter = registry.counter("test_render_total", "Rendered counter");
+    auto& latency = registry.latency("test_render_seconds", "Rendered latency");
+    
+    // Повторная регистрация возвращает ту же метрику
+    EXPECT_EQ(&registry.counter("test_render_total", "Rendered counter"), &counter);
+    
+    counter.inc(3);
+    latency.observe(std::chrono::microseconds(2000));
+    
+    const std::string text = registry.render();
+    EXPECT_NE(text.find("# TYPE test_render_total counter\ntest_render_total 3\n"), std::string::npos);
+    EXPECT_NE(text.find("test_render_seconds_bucket{le=\"0.0025\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("test_render_seconds_bucket{le=\"0.001\"} 0\n"), std::string::npos);
+    EXPECT_NE(text.find("test_render_seconds_count 1\n"), std::string::npos);
+    EXPECT_NE(text.find("test_render_seconds_p99 "), std::string::npos);
+}
\ No newline at end of file
@@ -0,0 +1,355 @@
+#include "record_controller.hpp"
+#include "playback_controller.hpp"
+#include "frame_activity.hpp"
+#include "logger.hpp"
+
+#include <gtest/gtest.h>
+#include <boost/asio/io_context.hpp>
+#include <thread>
+
+class RecordControllerTest : public ::testing::Test 
+{
+protected:
+    void TearDown() override 
+    {
+        if (!filename_.empty()) 
+        {
+            std::filesystem::remove(filename_);
+            std::filesystem::remove(index_filename(filename_));
+        }
+    }
+
+    std::string record_frames(RecordController& recorder, int count, 
+                              const std::vector<int>& activity = {}) 
+    {
+        EXPECT_TRUE(recorder.start_recording());
+        filename_ = recorder.get_current_filename();
+        
+        for (int i = 0; i < count; ++i) 
+        {
+            recorder.write_frame("frame" + std::to_string(i), 
+                                 i < static_cast<int>(activity.size()) ? activity[i] : 0);
+        }
+        
+        recorder.stop_recording();
+        return std::filesystem::path(filename_).filename().string();
+    }
+
+    static RecordController::PreviewStatus wait_for_preview(RecordController& recorder, const std::string& name, 
+                                                            RecordController::RecordingPreview& preview) 
+    {
+        auto status = recorder.get_preview(name, preview);
+        for (int i = 0; i < 500 && status == RecordController::PreviewStatus::Pending; ++i) 
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            status = recorder.get_preview(name, preview);
+        }
+        return status;
+    }
+
+    boost::asio::io_context ioc_;
+    std::string filename_;
+};
+
+TEST_F(RecordControllerTest, PreviewAvailableAfterRecordingCloses) 
+{
+    RecordController recorder(ioc_);
+    auto name = record_frames(recorder, 100);
+    
+    RecordController::RecordingPreview preview;
+    ASSERT_EQ(recorder.get_preview(name, preview), RecordController::PreviewStatus::Ready);
+    EXPECT_EQ(preview.filename, name);
+    EXPECT_EQ(preview.frame_count, 100u);
+    ASSERT_EQ(preview.frames.size(), RecordController::PREVIEW_SNAPSHOTS + 1);
+    EXPECT_EQ(preview.frames.front().frame, "frame0");
+}
+
+TEST_F(RecordControllerTest, PreviewOfShortRecordingKeepsAllFrames) 
+{
+    RecordController recorder(ioc_);
+    auto name = record_frames(recorder, 3);
+    
+    RecordController::RecordingPreview preview;
+    ASSERT_EQ(recorder.get_preview(name, preview), RecordController::PreviewStatus::Ready);
+    ASSERT_EQ(preview.frames.size(), 3u);
+    EXPECT_EQ(preview.frames[0].frame, "frame0");
+    EXPECT_EQ(preview.frames[2].frame, "frame2");
+}
+
+TEST_F(RecordControllerTest, PreviewBuiltFromFileMatchesLivePreview) 
+{
+    RecordController::RecordingPreview live;
+    std::string name;
+    {
+        RecordController recorder(ioc_);
+        name = record_frames(recorder, 64);
+        ASSERT_EQ(recorder.get_preview(name, live), RecordController::PreviewStatus::Ready);
+    }
+    
+    // A fresh controller has an empty catalog and parses the file in the background
+    RecordController recorder(ioc_);
+    RecordController::RecordingPreview from_file;
+    EXPECT_EQ(recorder.get_preview(name, from_file), RecordController::PreviewStatus::Pending);
+    ASSERT_EQ(wait_for_preview(recorder, name, from_file), RecordController::PreviewStatus::Ready);
+    
+    EXPECT_EQ(from_file.frame_count, live.frame_count);
+    ASSERT_EQ(from_file.frames.size(), live.frames.size());
+    for (size_t i = 0; i < live.frames.size(); ++i) 
+    {
+        EXPECT_EQ(from_file.frames[i].frame, live.frames[i].frame) << "snapshot " << i;
+        EXPECT_EQ(from_file.frames[i].timestamp, live.frames[i].timestamp) << "snapshot " << i;
+    }
+    EXPECT_EQ(live.frames.front().frame, "frame0");
+    EXPECT_EQ(live.frames.back().frame, "frame63");
+}
+
+TEST_F(RecordControllerTest, PreviewMissingForUnknownRecording) 
+{
+    RecordController recorder(ioc_);
+    RecordController::RecordingPreview preview;
+    EXPECT_EQ(recorder.get_preview("missing.asr", preview), RecordController::PreviewStatus::Missing);
+}
+
+TEST_F(RecordControllerTest, PreviewCacheEvictsLeastRecentlyUsed) 
+{
+    RecordController recorder(ioc_);
+    auto first = record_frames(recorder, 10);
+    const std::string first_file = filename_;
+    
+    // Recording names have one second resolution
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    auto second = record_frames(recorder, 10);
+    ASSERT_NE(first, second);
+    
+    // Room for one preview only: the older one is dropped and rebuilt from the file
+    const size_t one_preview = recorder.preview_cache_bytes() / 2;
+    recorder.set_preview_cache_limit(one_preview);
+    EXPECT_LE(recorder.preview_cache_bytes(), one_preview);
+    
+    RecordController::RecordingPreview preview;
+    EXPECT_EQ(recorder.get_preview(second, preview), RecordController::PreviewStatus::Ready);
+    EXPECT_EQ(recorder.get_preview(first, preview), RecordController::PreviewStatus::Pending);
+    EXPECT_EQ(wait_for_preview(recorder, first, preview), RecordController::PreviewStatus::Ready);
+    EXPECT_EQ(preview.frames.back().frame, "frame9");
+    EXPECT_LE(recorder.preview_cache_bytes(), one_preview);
+    
+    std::filesystem::remove(first_file);
+    std::filesystem::remove(index_filename(first_file));
+}
+
+TEST(FrameActivityTest, IdenticalFramesHaveNoActivity) 
+{
+    EXPECT_EQ(frame_activity("@@..\n", "@@..\n"), 0);
+}
+
+TEST(FrameActivityTest, CountsChangedCellsInPermille) 
+{
+    EXPECT_EQ(frame_activity("@@@@@@@@@\n", "@@@@@....\n"), 400);
+}
+
+TEST(FrameActivityTest, SizeChangeIsFullActivity) 
+{
+    EXPECT_EQ(frame_activity("", "@@\n"), 1000);
+    EXPECT_EQ(frame_activity("@\n", "@@\n"), 1000);
+}
+
+TEST_F(RecordControllerTest, PlaybackSeeksBetweenActivitySegments) 
+{
+    // Two active segments: frames 10-14 and 30-34
+    std::vector<int> activity(40, 0);
+    for (int i = 10; i < 15; ++i) activity[i] = 500;
+    for (int i = 30; i < 35; ++i) activity[i] = 500;
+    
+    std::string name;
+    {
+        RecordController recorder(ioc_);
+        name = record_frames(recorder, 40, activity);
+    }
+    EXPECT_TRUE(std::filesystem::exists(index_filename(filename_)));
+    
+    PlaybackController player(ioc_);
+    ASSERT_TRUE(player.load_recording(filename_));
+    ASSERT_TRUE(player.has_activity_index());
+    
+    std::vector<std::string> shown;
+    player.start_playback([&](const std::string& frame) { shown.push_back(frame); });
+    ASSERT_EQ(shown.back(), "frame0");
+    
+    ASSERT_TRUE(player.seek_to_activity(true, DEFAULT_ACTIVITY_THRESHOLD));
+    EXPECT_EQ(shown.back(), "frame10");
+    
+    ASSERT_TRUE(player.seek_to_activity(true, DEFAULT_ACTIVITY_THRESHOLD));
+    EXPECT_EQ(shown.back(), "frame30");
+    
+    EXPECT_FALSE(player.seek_to_activity(true, DEFAULT_ACTIVITY_THRESHOLD));
+    
+    ASSERT_TRUE(player.seek_to_activity(false, DEFAULT_ACTIVITY_THRESHOLD));
+    EXPECT_EQ(shown.back(), "frame10");
+    
+    player.stop_playback();
+}
+
+TEST_F(RecordControllerTest, AutoRecordFlushesPreRollOnActivity) 
+{
+    RecordController recorder(ioc_);
+    
+    RecordController::AutoRecordSettings settings;
+    settings.pre_roll_seconds = 1;
+    settings.fps = 10;
+    settings.threshold = DEFAULT_ACTIVITY_THRESHOLD;
+    settings.cooldown_seconds = 0;
+    recorder.enable_auto_record(settings);
+    
+    // Idle frames only fill the ring
+    for (int i = 0; i < 25; ++i) 
+    {
+        recorder.process_frame("idle" + std::to_string(i), 0);
+    }
+    EXPECT_FALSE(recorder.is_recording());
+    
+    recorder.process_frame("motion", 500);
+    ASSERT_TRUE(recorder.is_recording());
+    filename_ = recorder.get_current_filename();
+    
+    // With zero cooldown the first calm frame ends the recording
+    recorder.process_frame("calm", 0);
+    EXPECT_FALSE(recorder.is_recording());
+    
+    RecordController::RecordingPreview preview;
+    ASSERT_EQ(recorder.get_preview(std::filesystem::path(filename_).filename().string(), preview), 
+              RecordController::PreviewStatus::Ready);
+    
+    // 10 pre-roll frames, the trigger frame and the calm frame
+    EXPECT_EQ(preview.frame_count, 12u);
+    EXPECT_EQ(preview.frames.front().frame, "idle15");
+    EXPECT_EQ(preview.frames.back().frame, "calm");
+}
+
+TEST_F(RecordControllerTest, AutoRecordRingFollowsFpsChange) 
+{
+    RecordController recorder(ioc_);
+    
+    RecordController::AutoRecordSettings settings;
+    settings.pre_roll_seconds = 1;
+    settings.fps = 10;
+    settings.cooldown_seconds = 0;
+    recorder.enable_auto_record(settings);
+    
+    for (int i = 0; i < 10; ++i) 
+    {
+        recorder.process_frame("idle" + std::to_string(i), 0);
+    }
+    
+    // Halving the rate halves the ring; the newest frames survive
+    recorder.set_auto_record_fps(5);
+    recorder.process_frame("motion", 500);
+    ASSERT_TRUE(recorder.is_recording());
+    filename_ = recorder.get_current_filename();
+    recorder.process_frame("calm", 0);
+    
+    RecordController::RecordingPreview preview;
+    ASSERT_EQ(recorder.get_preview(std::filesystem::path(filename_).filename().string(), preview), 
+              RecordController::PreviewStatus::Ready);
+    EXPECT_EQ(preview.frame_count, 7u);
+    EXPECT_EQ(preview.frames.front().frame, "idle5");
+}
+
+TEST_F(RecordControllerTest, AutoRecordRingIsBounded) 
+{
+    RecordController recorder(ioc_);
+    
+    RecordController::AutoRecordSettings settings;
+    settings.pre_roll_seconds = 1 << 30;
+    settings.fps = 1 << 30;
+    settings.cooldown_seconds = 0;
+    recorder.enable_auto_record(settings);
+    
+    for (size_t i = 0; i < RecordController::MAX_PRE_ROLL_FRAMES + 10; ++i) 
+    {
+        recorder.process_frame("idle", 0);
+    }
+    recorder.process_frame("motion", 500);
+    ASSERT_TRUE(recorder.is_recording());
+    filename_ = recorder.get_current_filename();
+    recorder.process_frame("calm", 0);
+    
+    RecordController::RecordingPreview preview;
+    ASSERT_EQ(recorder.get_preview(std::filesystem::path(filename_).filename().string(), preview), 
+              RecordController::PreviewStatus::Ready);
+    EXPECT_EQ(preview.frame_count, RecordController::MAX_PRE_ROLL_FRAMES + 2);
+}
+
+TEST_F(RecordControllerTest, AutoRecordRingStaysWithinByteBudget) 
+{
+    RecordController recorder(ioc_);
+    recorder.set_pre_roll_budget(10 * 1024);
+    
+    RecordController::AutoRecordSettings settings;
+    settings.pre_roll_seconds = 60;
+    settings.fps = 60;
+    settings.cooldown_seconds = 0;
+    recorder.enable_auto_record(settings);
+    
+    // 1 KB frames: only ten fit whatever the frame count allows
+    for (int i = 0; i < 100; ++i) 
+    {
+        std::string frame(1024 - 8, '#');
+        frame += std::to_string(10000000 + i);
+        recorder.process_frame(frame, 0);
+        ASSERT_LE(recorder.pre_roll_bytes(), 10u * 1024);
+    }
+    recorder.process_frame("motion", 500);
+    ASSERT_TRUE(recorder.is_recording());
+    filename_ = recorder.get_current_filename();
+    recorder.process_frame("calm", 0);
+    
+    RecordController::RecordingPreview preview;
+    ASSERT_EQ(recorder.get_preview(std::filesystem::path(filename_).filename().string(), preview), 
+              RecordController::PreviewStatus::Ready);
+    EXPECT_EQ(preview.frame_count, 10u + 2);
+    EXPECT_TRUE(preview.frames.front().frame.ends_with("10000090"));
+    // Flushing releases the ring's buffers until it refills
+    EXPECT_EQ(recorder.pre_roll_bytes(), 0u);
+}
+
+TEST_F(RecordControllerTest, AutoRecordKeepsRecordingDuringCooldown) 
+{
+    RecordController recorder(ioc_);
+    
+    RecordController::AutoRecordSettings settings;
+    settings.pre_roll_seconds = 1;
+    settings.fps = 10;
+    settings.cooldown_seconds = 60;
+    recorder.enable_auto_record(settings);
+    
+    recorder.process_frame("motion", 500);
+    ASSERT_TRUE(recorder.is_recording());
+    filename_ = recorder.get_current_filename();
+    
+    for (int i = 0; i < 5; ++i) 
+    {
+        recorder.process_frame("calm", 0);
+    }
+    EXPECT_TRUE(recorder.is_recording());
+    
+    recorder.disable_auto_record();
+    EXPECT_FALSE(recorder.is_recording());
+}
+
+TEST_F(RecordControllerTest, ManualRecordingIgnoresAutoRecordCooldown) 
+{
+    RecordController recorder(ioc_);
+    
+    RecordController::AutoRecordSettings settings;
+    settings.cooldown_seconds = 0;
+    recorder.enable_auto_record(settings);
+    
+    ASSERT_TRUE(recorder.start_recording());
+    filename_ = recorder.get_current_filename();
+    
+    recorder.process_frame("motion", 500);
+    recorder.process_frame("calm", 0);
+    EXPECT_TRUE(recorder.is_recording());
+    
+    recorder.stop_recording();
+}
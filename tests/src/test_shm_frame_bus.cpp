@@ -0,0 +1,113 @@
+#include "shm_frame_bus.hpp"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+std::string bus_name(const char* test) 
+{
+    return "/ascii_test_" + std::string(test) + "_" + std::to_string(getpid());
+}
+
+} // namespace
+
+TEST(ShmFrameBusTest, ReaderReceivesPublishedFrames) 
+{
+    const std::string name = bus_name("roundtrip");
+    frame_bus::Writer writer(name, 4, 64);
+    frame_bus::Reader reader(name);
+    frame_bus::Frame frame;
+
+    EXPECT_FALSE(reader.read_next(frame));
+
+    const auto now = std::chrono::steady_clock::now();
+    ASSERT_TRUE(writer.publish("ab\ncd\n", now));
+    ASSERT_TRUE(writer.publish("ef\ngh\n", now));
+
+    ASSERT_TRUE(reader.read_next(frame));
+    EXPECT_EQ(frame.sequence, 1u);
+    EXPECT_EQ(frame.data, "ab\ncd\n");
+    EXPECT_EQ(frame.published_at, now);
+
+    ASSERT_TRUE(reader.read_next(frame));
+    EXPECT_EQ(frame.sequence, 2u);
+    EXPECT_EQ(frame.data, "ef\ngh\n");
+    EXPECT_FALSE(reader.read_next(frame));
+    EXPECT_EQ(reader.dropped(), 0u);
+}
+
+TEST(ShmFrameBusTest, LaggingReaderSkipsOverwrittenFrames) 
+{
+    const std::string name = bus_name("lagging");
+    frame_bus::Writer writer(name, 4, 16);
+    frame_bus::Reader reader(name);
+
+    for (int i = 1; i <= 10; ++i) 
+    {
+        writer.publish(std::to_string(i), std::chrono::steady_clock::now());
+    }
+
+    // В кольце из 4 слотов остались кадры 7-10, первые 6 потеряны
+    frame_bus::Frame frame;
+    ASSERT_TRUE(reader.read_next(frame));
+    EXPECT_EQ(frame.sequence, 7u);
+    EXPECT_EQ(frame.data, "7");
+    EXPECT_EQ(reader.dropped(), 6u);
+
+    ASSERT_TRUE(reader.read_latest(frame));
+    EXPECT_EQ(frame.data, "10");
+}
+
+TEST(ShmFrameBusTest, RejectsOversizedFrameAndMissingSegment) 
+{
+    const std::string name = bus_name("limits");
+    frame_bus::Writer writer(name, 2, 8);
+
+    EXPECT_FALSE(writer.publish("123456789", std::chrono::steady_clock::now()));
+    EXPECT_EQ(writer.published(), 0u);
+    EXPECT_THROW(frame_bus::Reader(name + "_missing"), std::system_error);
+}
+
+TEST(ShmFrameBusTest, ConcurrentReaderNeverSeesTornFrames) 
+{
+    const std::string name = bus_name("concurrent");
+    frame_bus::Writer writer(name, 2, 256);
+    frame_bus::Reader reader(name);
+    std::atomic<bool> done{false};
+
+    // Каждый кадр состоит из одного повторенного символа: смесь двух
+    // кадров означала бы, что seqlock пропустил перезапись слота
+    std::thread producer([&] {
+        for (int i = 0; i < 20000; ++i) 
+        {
+            writer.publish(std::string(200, static_cast<char>('a' + i % 26)), std::chrono::steady_clock::now());
+        }
+        done = true;
+    });
+
+    frame_bus::Frame frame;
+    uint64_t received = 0;
+    uint64_t torn = 0;
+    auto consume = [&] {
+        while (reader.read_next(frame)) 
+        {
+            ++received;
+            if (frame.data.size() != 200 || frame.data.find_first_not_of(frame.data[0]) != std::string::npos) 
+            {
+                ++torn;
+            }
+        }
+    };
+    while (!done) 
+    {
+        consume();
+    }
+    consume();
+    producer.join();
+
+    EXPECT_GT(received, 0u);
+    EXPECT_EQ(torn, 0u);
+}
\ No newline at end of file
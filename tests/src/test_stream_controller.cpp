@@ -1,4 +1,5 @@
 #include "stream_controller.hpp"
+#include "relay_client.hpp"
 #include "video_source_interface.hpp"
 #include "ascii_converter_interface.hpp"
 #include "logger.hpp"
@@ -16,7 +17,7 @@ class MockVideoSource : public IVideoSource
 {
 public:
     MOCK_METHOD(bool, is_available, (), (const, override));
-    MOCK_METHOD(cv::Mat, capture_frame, (), (override));
+    MOCK_METHOD(void, capture_frame, (cv::Mat& frame), (override));
     MOCK_METHOD(void, set_resolution, (int width, int height), (override));
     MOCK_METHOD(void, open, (int index), (override));
     MOCK_METHOD(void, close, (), (override));
@@ -26,7 +27,30 @@ class MockAsciiConverter : public IAsciiConverter
 {
 public:
     MOCK_METHOD(void, set_ascii_chars, (const std::string& chars), (override));
-    MOCK_METHOD(std::string, convert, (const cv::Mat& frame, int width, int height), (override));
+    MOCK_METHOD(void, convert, (const cv::Mat& frame, int width, int height, std::string& output), (override));
+};
+
+class RecordingViewer : public IFrameViewer 
+{
+public:
+    explicit RecordingViewer(uint64_t id) : id(id) {}
+    
+    void send_frame(std::shared_ptr<const std::string> frame, const FrameTrace& trace) override 
+    {
+        // Сообщения о начале и конце трансляции проверяются отдельно от кадров
+        if (*frame == "STREAM_ACTIVE" || *frame == "STREAM_INACTIVE") 
+        {
+            statuses.push_back(*frame);
+            return;
+        }
+        frames.push_back(*frame);
+    }
+    
+    uint64_t session_id() const override { return id; }
+    
+    uint64_t id;
+    std::vector<std::string> frames;
+    std::vector<std::string> statuses;
 };
 
 MATCHER_P(MatEquals, expected, "") 
@@ -108,8 +132,8 @@ TEST_F(StreamControllerTest, StartStreamingSuccess)
     EXPECT_CALL(*video_source_, set_resolution(240, 180)).Times(1);
     EXPECT_CALL(*ascii_converter_, set_ascii_chars("@%#*+=-:. ")).Times(1);
     
-    EXPECT_CALL(*video_source_, capture_frame())
-        .WillOnce(testing::Return(cv::Mat()));
+    EXPECT_CALL(*video_source_, capture_frame(testing::_))
+        .WillOnce(testing::SetArgReferee<0>(cv::Mat()));
 
     boost::asio::co_spawn(ioc_, 
         [&]() -> net::awaitable<void> {
@@ -127,8 +151,8 @@ TEST_F(StreamControllerTest, StartStreamingAlreadyActive)
     EXPECT_CALL(*video_source_, set_resolution(240, 180)).Times(1);
     EXPECT_CALL(*ascii_converter_, set_ascii_chars("@%#*+=-:. ")).Times(1);
     
-    EXPECT_CALL(*video_source_, capture_frame())
-        .WillOnce(testing::Return(cv::Mat()));
+    EXPECT_CALL(*video_source_, capture_frame(testing::_))
+        .WillOnce(testing::SetArgReferee<0>(cv::Mat()));
 
     boost::asio::co_spawn(ioc_, 
         [&]() -> net::awaitable<void> {
@@ -147,8 +171,8 @@ TEST_F(StreamControllerTest, StopStreamingSuccess)
     EXPECT_CALL(*video_source_, set_resolution(240, 180)).Times(1);
     EXPECT_CALL(*ascii_converter_, set_ascii_chars("@%#*+=-:. ")).Times(1);
     
-    EXPECT_CALL(*video_source_, capture_frame())
-        .WillOnce(testing::Return(cv::Mat()));
+    EXPECT_CALL(*video_source_, capture_frame(testing::_))
+        .WillOnce(testing::SetArgReferee<0>(cv::Mat()));
 
     boost::asio::co_spawn(ioc_, 
         [&]() -> net::awaitable<void> {
@@ -181,10 +205,10 @@ TEST_F(StreamControllerTest, CaptureLoopEmptyFrame)
     EXPECT_CALL(*ascii_converter_, set_ascii_chars("@%#*+=-:. ")).Times(1);
     
     cv::Mat empty_frame;
-    EXPECT_CALL(*video_source_, capture_frame())
-        .WillOnce(testing::Return(empty_frame));
+    EXPECT_CALL(*video_source_, capture_frame(testing::_))
+        .WillOnce(testing::SetArgReferee<0>(empty_frame));
 
-    EXPECT_CALL(*ascii_converter_, convert(testing::_, testing::_, testing::_)).Times(0);
+    EXPECT_CALL(*ascii_converter_, convert(testing::_, testing::_, testing::_, testing::_)).Times(0);
 
     boost::asio::co_spawn(ioc_, 
         [&]() -> net::awaitable<void> {
@@ -202,11 +226,11 @@ TEST_F(StreamControllerTest, CaptureLoopValidFrame)
     EXPECT_CALL(*ascii_converter_, set_ascii_chars("@%#*+=-:. ")).Times(1);
     
     cv::Mat test_frame = cv::Mat::ones(180, 240, CV_8UC1) * 128;
-    EXPECT_CALL(*video_source_, capture_frame())
-        .WillOnce(testing::Return(test_frame));
+    EXPECT_CALL(*video_source_, capture_frame(testing::_))
+        .WillOnce(testing::SetArgReferee<0>(test_frame));
 
-    EXPECT_CALL(*ascii_converter_, convert(testing::_, 120, 90))
-        .WillOnce(testing::Return("test_ascii_frame"));
+    EXPECT_CALL(*ascii_converter_, convert(testing::_, 120, 90, testing::_))
+        .WillOnce(testing::SetArgReferee<3>(std::string("test_ascii_frame")));
 
     boost::asio::co_spawn(ioc_, 
         [&]() -> net::awaitable<void> {
@@ -225,8 +249,8 @@ TEST_F(StreamControllerTest, GetStatus)
     EXPECT_CALL(*video_source_, set_resolution(240, 180)).Times(1);
     EXPECT_CALL(*ascii_converter_, set_ascii_chars("@%#*+=-:. ")).Times(1);
     
-    EXPECT_CALL(*video_source_, capture_frame())
-        .WillOnce(testing::Return(cv::Mat()));
+    EXPECT_CALL(*video_source_, capture_frame(testing::_))
+        .WillOnce(testing::SetArgReferee<0>(cv::Mat()));
 
     boost::asio::co_spawn(ioc_, 
         [&]() -> net::awaitable<void> {
@@ -239,3 +263,238 @@ TEST_F(StreamControllerTest, GetStatus)
     
     ioc_.run_for(std::chrono::milliseconds(100));
 }
+
+
+TEST_F(StreamControllerTest, CaptureLoopIdlesWithoutConsumers) 
+{
+    controller_->set_idle_policy(std::chrono::seconds(0), true);
+    
+    EXPECT_CALL(*video_source_, open(0)).Times(2);
+    EXPECT_CALL(*video_source_, close()).Times(testing::AtLeast(1));
+
+    boost::asio::co_spawn(ioc_, 
+        [&]() -> net::awaitable<void> {
+            co_await controller_->start_streaming(0, "120x90", 10);
+        }, 
+        boost::asio::detached);
+    
+    ioc_.run_for(std::chrono::milliseconds(300));
+    EXPECT_TRUE(controller_->is_streaming());
+    EXPECT_TRUE(controller_->is_idle());
+    
+    // Авто-запись считается потребителем кадров и будит захват
+    controller_->enable_auto_record(1, 20, 1);
+    ioc_.run_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(controller_->is_idle());
+    
+    controller_->disable_auto_record();
+}
+
+TEST_F(StreamControllerTest, ControllerAloneDoesNotKeepCaptureAwake) 
+{
+    controller_->set_idle_policy(std::chrono::seconds(0), true);
+    
+    EXPECT_CALL(*video_source_, open(0)).Times(testing::AtLeast(1));
+    EXPECT_CALL(*video_source_, close()).Times(testing::AtLeast(1));
+    
+    auto controller = std::make_shared<RecordingViewer>(1);
+    auto viewer = std::make_shared<RecordingViewer>(2);
+    controller_->add_controller(controller);
+    controller_->add_viewer(viewer);
+
+    boost::asio::co_spawn(ioc_, 
+        [&]() -> net::awaitable<void> {
+            co_await controller_->start_streaming(0, "120x90", 10);
+        }, 
+        boost::asio::detached);
+    
+    ioc_.run_for(std::chrono::milliseconds(100));
+    EXPECT_FALSE(controller_->is_idle());
+    
+    // Остался только контроллер, как после ухода последнего зрителя
+    boost::asio::co_spawn(ioc_, controller_->remove_viewer(viewer), boost::asio::detached);
+    ioc_.run_for(std::chrono::milliseconds(300));
+    EXPECT_TRUE(controller_->is_streaming());
+    EXPECT_TRUE(controller_->is_idle());
+}
+
+TEST_F(StreamControllerTest, UnchangedFramesAreNotBroadcast) 
+{
+    cv::Mat test_frame = cv::Mat::ones(180, 240, CV_8UC1) * 128;
+    ON_CALL(*video_source_, capture_frame(testing::_))
+        .WillByDefault(testing::SetArgReferee<0>(test_frame));
+    
+    EXPECT_CALL(*ascii_converter_, convert(testing::_, 120, 90, testing::_))
+        .WillOnce(testing::SetArgReferee<3>(std::string("still")))
+        .WillOnce(testing::SetArgReferee<3>(std::string("still")))
+        .WillOnce(testing::SetArgReferee<3>(std::string("still")))
+        .WillRepeatedly(testing::SetArgReferee<3>(std::string("moved")));
+    
+    auto viewer = std::make_shared<RecordingViewer>(1);
+    controller_->add_viewer(viewer);
+    
+    boost::asio::co_spawn(ioc_, 
+        [&]() -> net::awaitable<void> {
+            co_await controller_->start_streaming(0, "120x90", 50);
+        }, 
+        boost::asio::detached);
+    
+    ioc_.run_for(std::chrono::milliseconds(300));
+    
+    // Повторы кадра подавляются, изменившийся кадр уходит один раз
+    EXPECT_EQ(viewer->frames, (std::vector<std::string>{"still", "moved"}));
+}
+
+TEST_F(StreamControllerTest, HeartbeatSentForStaticScene) 
+{
+    cv::Mat test_frame = cv::Mat::ones(180, 240, CV_8UC1) * 128;
+    ON_CALL(*video_source_, capture_frame(testing::_))
+        .WillByDefault(testing::SetArgReferee<0>(test_frame));
+    ON_CALL(*ascii_converter_, convert(testing::_, 120, 90, testing::_))
+        .WillByDefault(testing::SetArgReferee<3>(std::string("still")));
+    
+    auto viewer = std::make_shared<RecordingViewer>(1);
+    controller_->add_viewer(viewer);
+    
+    boost::asio::co_spawn(ioc_, 
+        [&]() -> net::awaitable<void> {
+            co_await controller_->start_streaming(0, "120x90", 50);
+        }, 
+        boost::asio::detached);
+    
+    // KEEPALIVE_INTERVAL - 2 секунды: к этому моменту heartbeat еще не отправлен
+    ioc_.run_for(std::chrono::milliseconds(1500));
+    EXPECT_EQ(viewer->frames, (std::vector<std::string>{"still"}));
+    
+    ioc_.run_for(std::chrono::milliseconds(800));
+    EXPECT_EQ(viewer->frames, (std::vector<std::string>{"still", "HEARTBEAT"}));
+}
+
+TEST_F(StreamControllerTest, BroadcastReachesAllViewers) 
+{
+    auto first = std::make_shared<RecordingViewer>(1);
+    auto second = std::make_shared<RecordingViewer>(2);
+    controller_->add_viewer(first);
+    controller_->add_viewer(second);
+    
+    boost::asio::co_spawn(ioc_, 
+        [&]() -> net::awaitable<void> {
+            co_await controller_->broadcast_frame(std::make_shared<const std::string>("frame"));
+            co_await controller_->remove_viewer_by_id(2);
+            co_await controller_->broadcast_frame(std::make_shared<const std::string>("next"));
+        }, 
+        boost::asio::detached);
+    
+    ioc_.run_for(std::chrono::milliseconds(100));
+    
+    EXPECT_EQ(first->frames, (std::vector<std::string>{"frame", "next"}));
+    EXPECT_EQ(second->frames, (std::vector<std::string>{"frame"}));
+}
+
+TEST_F(StreamControllerTest, RelayModeForwardsUpstreamFrames) 
+{
+    // Ретранслятор не открывает свой источник даже по команде controller
+    EXPECT_CALL(*video_source_, open(testing::_)).Times(0);
+    controller_->set_relay_mode(true);
+    controller_->set_upstream_active(true);
+    
+    auto early = std::make_shared<RecordingViewer>(1);
+    controller_->add_viewer(early);
+    
+    boost::asio::co_spawn(ioc_, 
+        [&]() -> net::awaitable<void> {
+            co_await controller_->start_streaming(0, "120x90", 10);
+            co_await controller_->relay_frame(std::make_shared<const std::string>("a\nb\n"));
+            co_await controller_->relay_frame(std::make_shared<const std::string>("HEARTBEAT"));
+        }, 
+        boost::asio::detached);
+    
+    ioc_.run_for(std::chrono::milliseconds(100));
+    
+    // Новый зритель сразу получает последний кадр, а не heartbeat
+    auto late = std::make_shared<RecordingViewer>(2);
+    controller_->add_viewer(late);
+    ioc_.run_for(std::chrono::milliseconds(50));
+    
+    EXPECT_TRUE(controller_->is_streaming());
+    EXPECT_EQ(early->frames, (std::vector<std::string>{"a\nb\n", "HEARTBEAT"}));
+    EXPECT_EQ(late->frames, (std::vector<std::string>{"a\nb\n"}));
+    
+    controller_->set_upstream_active(false);
+}
+
+TEST_F(StreamControllerTest, ViewersAreToldWhenStreamStartsAndStops) 
+{
+    cv::Mat test_frame = cv::Mat::ones(180, 240, CV_8UC1) * 128;
+    ON_CALL(*video_source_, capture_frame(testing::_))
+        .WillByDefault(testing::SetArgReferee<0>(test_frame));
+    ON_CALL(*ascii_converter_, convert(testing::_, 120, 90, testing::_))
+        .WillByDefault(testing::SetArgReferee<3>(std::string("frame")));
+    
+    auto viewer = std::make_shared<RecordingViewer>(1);
+    controller_->add_viewer(viewer);
+    
+    boost::asio::co_spawn(ioc_, 
+        [&]() -> net::awaitable<void> {
+            co_await controller_->start_streaming(0, "120x90", 10);
+        }, 
+        boost::asio::detached);
+    ioc_.run_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(viewer->statuses, (std::vector<std::string>{"STREAM_ACTIVE"}));
+    
+    // Ретранслятор узнает об остановке из этого сообщения, а не из разрыва соединения
+    boost::asio::co_spawn(ioc_, controller_->stop_streaming(), boost::asio::detached);
+    ioc_.run_for(std::chrono::milliseconds(300));
+    EXPECT_FALSE(controller_->is_streaming());
+    EXPECT_EQ(viewer->statuses, (std::vector<std::string>{"STREAM_ACTIVE", "STREAM_INACTIVE"}));
+}
+
+TEST_F(StreamControllerTest, RelayFollowsUpstreamStreamStatus) 
+{
+    controller_->set_relay_mode(true);
+    
+    auto viewer = std::make_shared<RecordingViewer>(1);
+    controller_->add_viewer(viewer);
+    ioc_.run_for(std::chrono::milliseconds(50));
+    
+    // Подключение к исходному серверу без трансляции на нем
+    EXPECT_FALSE(controller_->is_streaming());
+    
+    controller_->set_upstream_active(true);
+    boost::asio::co_spawn(ioc_, 
+        controller_->relay_frame(std::make_shared<const std::string>("a\nb\n")), 
+        boost::asio::detached);
+    ioc_.run_for(std::chrono::milliseconds(50));
+    EXPECT_TRUE(controller_->is_streaming());
+    
+    controller_->set_upstream_active(false);
+    ioc_.run_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(controller_->is_streaming());
+    EXPECT_EQ(viewer->statuses, (std::vector<std::string>{"STREAM_ACTIVE", "STREAM_INACTIVE"}));
+    
+    // Кадр остановленной трансляции новому зрителю не отправляется
+    auto late = std::make_shared<RecordingViewer>(2);
+    controller_->add_viewer(late);
+    ioc_.run_for(std::chrono::milliseconds(50));
+    EXPECT_TRUE(late->frames.empty());
+}
+
+TEST(RelayClientTest, ParsesUpstreamAddress) 
+{
+    EXPECT_EQ(RelayClient::parse_upstream("10.0.0.5:9000"), std::make_pair(std::string("10.0.0.5"), std::string("9000")));
+    EXPECT_EQ(RelayClient::parse_upstream("origin.local"), std::make_pair(std::string("origin.local"), std::string("8080")));
+}
+
+TEST(RelayClientTest, InsecureModeIsOnlyForLoopback) 
+{
+    EXPECT_TRUE(RelayClient::is_loopback_host("localhost"));
+    EXPECT_TRUE(RelayClient::is_loopback_host("127.0.0.1"));
+    EXPECT_TRUE(RelayClient::is_loopback_host("::1"));
+    EXPECT_FALSE(RelayClient::is_loopback_host("10.0.0.5"));
+    EXPECT_FALSE(RelayClient::is_loopback_host("origin.local"));
+    
+    // Отключить проверку сертификата для удаленного origin нельзя
+    boost::asio::io_context ioc;
+    EXPECT_THROW(RelayClient(ioc, "10.0.0.5:8080", nullptr, "", true), std::invalid_argument);
+    EXPECT_NO_THROW(RelayClient(ioc, "127.0.0.1:8080", nullptr, "", true));
+}
@@ -0,0 +1,110 @@
+#include "synthetic_video_source.hpp"
+
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+bool same_frame(const cv::Mat& a, const cv::Mat& b) 
+{
+    if (a.size() != b.size() || a.type() != b.type()) 
+    {
+        return false;
+    }
+    for (int y = 0; y < a.rows; ++y) 
+    {
+        if (std::memcmp(a.ptr(y), b.ptr(y), a.cols * a.elemSize()) != 0) 
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(SyntheticVideoSourceTest, ProducesRequestedResolution) 
+{
+    SyntheticVideoSource source(SyntheticVideoSource::Pattern::Gradient, -1);
+    source.set_resolution(320, 240);
+    source.open(0);
+
+    cv::Mat frame = source.capture_frame();
+
+    EXPECT_EQ(frame.cols, 320);
+    EXPECT_EQ(frame.rows, 240);
+    EXPECT_EQ(frame.type(), CV_8UC3);
+}
+
+TEST(SyntheticVideoSourceTest, StaticPatternRepeatsFrames) 
+{
+    SyntheticVideoSource source(SyntheticVideoSource::Pattern::Static, -1);
+    source.open(0);
+
+    cv::Mat first = source.capture_frame();
+    cv::Mat second = source.capture_frame();
+
+    EXPECT_TRUE(same_frame(first, second));
+}
+
+TEST(SyntheticVideoSourceTest, GradientPatternMoves) 
+{
+    SyntheticVideoSource source(SyntheticVideoSource::Pattern::Gradient, -1);
+    source.open(0);
+
+    cv::Mat first = source.capture_frame();
+    cv::Mat second = source.capture_frame();
+
+    EXPECT_FALSE(same_frame(first, second));
+}
+
+TEST(SyntheticVideoSourceTest, NoiseIsReproducibleAfterReopen) 
+{
+    SyntheticVideoSource source(SyntheticVideoSource::Pattern::Noise, -1);
+    source.open(0);
+    cv::Mat first = source.capture_frame();
+    cv::Mat second = source.capture_frame();
+
+    source.close();
+    source.open(0);
+    cv::Mat again = source.capture_frame();
+
+    EXPECT_FALSE(same_frame(first, second));
+    EXPECT_TRUE(same_frame(first, again));
+}
+
+TEST(SyntheticVideoSourceTest, PacesFramesToRequestedRate) 
+{
+    SyntheticVideoSource source(SyntheticVideoSource::Pattern::Gradient, 50);
+    source.set_resolution(64, 48);
+    source.open(0);
+
+    // capture_frame не ждет: между дедлайнами повторяется тот же кадр
+    cv::Mat previous = source.capture_frame();
+    cv::Mat frame;
+    int changes = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(200)) 
+    {
+        source.capture_frame(frame);
+        if (!same_frame(frame, previous)) 
+        {
+            ++changes;
+            frame.copyTo(previous);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // 10 интервалов по 20 мс
+    EXPECT_GE(changes, 8);
+    EXPECT_LE(changes, 11);
+}
+
+TEST(SyntheticVideoSourceTest, ParsesPatternNames) 
+{
+    EXPECT_EQ(SyntheticVideoSource::parse_pattern("noise"), SyntheticVideoSource::Pattern::Noise);
+    EXPECT_EQ(SyntheticVideoSource::parse_pattern("static"), SyntheticVideoSource::Pattern::Static);
+    EXPECT_THROW(SyntheticVideoSource::parse_pattern("plaid"), std::invalid_argument);
+}
\ No newline at end of file
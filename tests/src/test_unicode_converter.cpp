@@ -0,0 +1,68 @@
+#include "unicode_converter.hpp"
+
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <stdexcept>
+
+namespace {
+
+const std::string BRAILLE_FULL = "\xE2\xA3\xBF";   // U+28FF
+const std::string BRAILLE_BLANK = "\xE2\xA0\x80";  // U+2800
+const std::string UPPER_HALF = "\xE2\x96\x80";     // U+2580
+const std::string LOWER_HALF = "\xE2\x96\x84";     // U+2584
+
+} // namespace
+
+TEST(UnicodeConverterTest, ProducesFixedWidthRows) 
+{
+    UnicodeConverter converter(UnicodeConverter::Mode::Braille);
+    cv::Mat frame(480, 640, CV_8UC3, cv::Scalar(90, 120, 200));
+    std::string result = converter.convert(frame, 80, 60);
+    
+    ASSERT_EQ(result.size(), UnicodeConverter::frame_size(80, 60));
+    const size_t row_bytes = 80 * UnicodeConverter::GLYPH_BYTES + 1;
+    for (size_t y = 0; y < 60; ++y) 
+    {
+        EXPECT_EQ(result[y * row_bytes + row_bytes - 1], '\n');
+    }
+}
+
+TEST(UnicodeConverterTest, DarkCellsSetAllBrailleDots) 
+{
+    UnicodeConverter converter(UnicodeConverter::Mode::Braille);
+    
+    cv::Mat black(8, 4, CV_8UC1, cv::Scalar(0));
+    EXPECT_EQ(converter.convert(black, 2, 2), BRAILLE_FULL + BRAILLE_FULL + "\n" + BRAILLE_FULL + BRAILLE_FULL + "\n");
+    
+    cv::Mat white(8, 4, CV_8UC1, cv::Scalar(255));
+    EXPECT_EQ(converter.convert(white, 2, 2), BRAILLE_BLANK + BRAILLE_BLANK + "\n" + BRAILLE_BLANK + BRAILLE_BLANK + "\n");
+}
+
+TEST(UnicodeConverterTest, MapsSubPixelsToBrailleDots) 
+{
+    UnicodeConverter converter(UnicodeConverter::Mode::Braille);
+    
+    // Темный только левый столбец клетки: точки 1, 2, 3, 7 (биты 0, 1, 2, 6)
+    cv::Mat cell(4, 2, CV_8UC1, cv::Scalar(255));
+    for (int y = 0; y < 4; ++y) 
+    {
+        cell.at<uchar>(y, 0) = 0;
+    }
+    EXPECT_EQ(converter.convert(cell, 1, 1), "\xE2\xA1\x87\n");  // U+2847
+}
+
+TEST(UnicodeConverterTest, HalfBlocksFollowVerticalSplit) 
+{
+    UnicodeConverter converter(UnicodeConverter::Mode::HalfBlock);
+    
+    cv::Mat frame(2, 2, CV_8UC1, cv::Scalar(255));
+    frame.at<uchar>(0, 0) = 0;
+    frame.at<uchar>(1, 1) = 0;
+    EXPECT_EQ(converter.convert(frame, 2, 1), UPPER_HALF + LOWER_HALF + "\n");
+}
+
+TEST(UnicodeConverterTest, RejectsUnknownMode) 
+{
+    EXPECT_EQ(UnicodeConverter::parse_mode("half_block"), UnicodeConverter::Mode::HalfBlock);
+    EXPECT_THROW(UnicodeConverter::parse_mode("ascii"), std::invalid_argument);
+}
\ No newline at end of file
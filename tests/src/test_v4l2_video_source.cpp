@@ -0,0 +1,297 @@
+#include "v4l2_video_source.hpp"
+
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <deque>
+#include <linux/videodev2.h>
+
+// Эмулятор драйвера V4L2: буферы живут в памяти процесса, кадры
+// заполняются из заранее подготовленного "файла" с содержимым
+class FakeV4l2Driver 
+{
+public:
+    static constexpr int FD = 42;
+    static constexpr off_t PAGE = 1 << 20;
+
+    std::vector<uint32_t> supported_formats{V4L2_PIX_FMT_YUYV};
+    uint32_t capabilities = V4L2_CAP_VIDEO_CAPTURE | V4L2_CAP_STREAMING;
+    std::vector<uint8_t> frame_data;
+    // Если задано, драйвер отдает только это разрешение
+    int native_width = 0;
+    int native_height = 0;
+
+    uint32_t format = 0;
+    int width = 0;
+    int height = 0;
+    std::vector<std::vector<uint8_t>> buffers;
+    std::deque<uint32_t> queued;
+    bool streaming = false;
+    bool opened = false;
+    int mapped = 0;
+
+    V4l2DeviceOps ops() 
+    {
+        V4l2DeviceOps ops;
+        ops.open = [this](const std::string&) {
+            opened = true;
+            return FD;
+        };
+        ops.close = [this](int) {
+            opened = false;
+            return 0;
+        };
+        ops.ioctl = [this](int, unsigned long request, void* arg) {
+            return ioctl(request, arg);
+        };
+        ops.mmap = [this](int, size_t, off_t offset) -> void* {
+            ++mapped;
+            return buffers.at(offset / PAGE).data();
+        };
+        ops.munmap = [this](void*, size_t) {
+            --mapped;
+            return 0;
+        };
+        ops.wait_frame = [this](int, int) {
+            return streaming && !queued.empty() ? 1 : 0;
+        };
+        return ops;
+    }
+
+    size_t frame_size() const 
+    {
+        switch (format) 
+        {
+            case V4L2_PIX_FMT_YUYV: return width * height * 2;
+            case V4L2_PIX_FMT_NV12: return width * height * 3 / 2;
+            case V4L2_PIX_FMT_GREY: return width * height;
+            default: return width * height * 2;
+        }
+    }
+
+private:
+    int fail(int error) 
+    {
+        errno = error;
+        return -1;
+    }
+
+    int ioctl(unsigned long request, void* arg) 
+    {
+        switch (request) 
+        {
+            case VIDIOC_QUERYCAP: 
+            {
+                auto* caps = static_cast<v4l2_capability*>(arg);
+                caps->capabilities = capabilities;
+                return 0;
+            }
+            case VIDIOC_S_FMT: 
+            {
+                auto* fmt = static_cast<v4l2_format*>(arg);
+                auto& pix = fmt->fmt.pix;
+                if (std::find(supported_formats.begin(), supported_formats.end(), pix.pixelformat) 
+                    == supported_formats.end()) 
+                {
+                    // Как настоящий драйвер: подставляем свой формат
+                    pix.pixelformat = supported_formats.front();
+                }
+                if (native_width > 0) 
+                {
+                    pix.width = native_width;
+                    pix.height = native_height;
+                }
+                format = pix.pixelformat;
+                width = pix.width;
+                height = pix.height;
+                pix.bytesperline = format == V4L2_PIX_FMT_YUYV ? width * 2 : 
+                                   format == V4L2_PIX_FMT_MJPEG ? 0 : width;
+                return 0;
+            }
+            case VIDIOC_REQBUFS: 
+            {
+                auto* req = static_cast<v4l2_requestbuffers*>(arg);
+                buffers.assign(req->count, std::vector<uint8_t>(std::max<size_t>(frame_size(), 1 << 16)));
+                queued.clear();
+                return 0;
+            }
+            case VIDIOC_QUERYBUF: 
+            {
+                auto* buf = static_cast<v4l2_buffer*>(arg);
+                buf->length = buffers.at(buf->index).size();
+                buf->m.offset = buf->index * PAGE;
+                return 0;
+            }
+            case VIDIOC_QBUF: 
+            {
+                auto* buf = static_cast<v4l2_buffer*>(arg);
+                if (std::find(queued.begin(), queued.end(), buf->index) != queued.end()) 
+                {
+                    return fail(EINVAL);
+                }
+                queued.push_back(buf->index);
+                return 0;
+            }
+            case VIDIOC_DQBUF: 
+            {
+                if (queued.empty()) 
+                {
+                    return fail(EAGAIN);
+                }
+                auto* buf = static_cast<v4l2_buffer*>(arg);
+                buf->index = queued.front();
+                queued.pop_front();
+
+                auto& buffer = buffers[buf->index];
+                std::copy(frame_data.begin(), frame_data.end(), buffer.begin());
+                buf->bytesused = frame_data.size();
+                buf->flags = 0;
+                return 0;
+            }
+            case VIDIOC_STREAMON:
+                streaming = true;
+                return 0;
+            case VIDIOC_STREAMOFF:
+                streaming = false;
+                return 0;
+            default:
+                return fail(ENOTTY);
+        }
+    }
+};
+
+class V4l2VideoSourceTest : public ::testing::Test 
+{
+protected:
+    FakeV4l2Driver driver;
+
+    std::unique_ptr<V4l2VideoSource> open_source(int width, int height) 
+    {
+        auto source = std::make_unique<V4l2VideoSource>(driver.ops());
+        source->set_resolution(width, height);
+        source->open(0);
+        return source;
+    }
+};
+
+TEST_F(V4l2VideoSourceTest, ExtractsLumaFromYuyv) 
+{
+    driver.supported_formats = {V4L2_PIX_FMT_YUYV};
+    driver.frame_data.resize(8 * 4 * 2);
+    for (size_t i = 0; i < driver.frame_data.size(); ++i) 
+    {
+        // Четные байты - яркость, нечетные - цветность
+        driver.frame_data[i] = i % 2 == 0 ? static_cast<uint8_t>(i / 2) : 128;
+    }
+
+    auto source = open_source(8, 4);
+    EXPECT_EQ(source->pixel_format(), static_cast<uint32_t>(V4L2_PIX_FMT_YUYV));
+
+    cv::Mat frame;
+    source->capture_frame(frame);
+
+    ASSERT_FALSE(frame.empty());
+    EXPECT_EQ(frame.type(), CV_8UC1);
+    EXPECT_EQ(frame.cols, 8);
+    EXPECT_EQ(frame.rows, 4);
+    for (int y = 0; y < 4; ++y) 
+    {
+        for (int x = 0; x < 8; ++x) 
+        {
+            EXPECT_EQ(frame.at<uchar>(y, x), y * 8 + x);
+        }
+    }
+}
+
+TEST_F(V4l2VideoSourceTest, Nv12LumaIsPassedWithoutCopy) 
+{
+    driver.supported_formats = {V4L2_PIX_FMT_NV12};
+    driver.frame_data.assign(16 * 8 * 3 / 2, 77);
+
+    auto source = open_source(16, 8);
+    EXPECT_EQ(source->pixel_format(), static_cast<uint32_t>(V4L2_PIX_FMT_NV12));
+
+    cv::Mat frame;
+    source->capture_frame(frame);
+
+    ASSERT_FALSE(frame.empty());
+    EXPECT_EQ(frame.type(), CV_8UC1);
+    EXPECT_EQ(frame.at<uchar>(0, 0), 77);
+
+    bool points_into_driver_buffer = false;
+    for (auto& buffer : driver.buffers) 
+    {
+        points_into_driver_buffer |= frame.data == buffer.data();
+    }
+    EXPECT_TRUE(points_into_driver_buffer);
+}
+
+TEST_F(V4l2VideoSourceTest, FallsBackToMjpegAndDecodesReducedLuma) 
+{
+    driver.supported_formats = {V4L2_PIX_FMT_MJPEG};
+    driver.native_width = 320;
+    driver.native_height = 240;
+
+    cv::Mat image(240, 320, CV_8UC1, cv::Scalar(200));
+    std::vector<uchar> jpeg;
+    ASSERT_TRUE(cv::imencode(".jpg", image, jpeg));
+    driver.frame_data.assign(jpeg.begin(), jpeg.end());
+
+    // Для ASCII-кадра шириной 40 символов хватает уменьшения в 8 раз
+    auto source = open_source(80, 60);
+    EXPECT_EQ(source->pixel_format(), static_cast<uint32_t>(V4L2_PIX_FMT_MJPEG));
+
+    cv::Mat frame;
+    source->capture_frame(frame);
+
+    ASSERT_FALSE(frame.empty());
+    EXPECT_EQ(frame.type(), CV_8UC1);
+    EXPECT_EQ(frame.cols, 40);
+    EXPECT_EQ(frame.rows, 30);
+    EXPECT_NEAR(frame.at<uchar>(frame.rows / 2, frame.cols / 2), 200, 2);
+}
+
+TEST_F(V4l2VideoSourceTest, BuffersAreReturnedToDriver) 
+{
+    driver.frame_data.assign(8 * 4 * 2, 50);
+    auto source = open_source(8, 4);
+
+    cv::Mat frame;
+    for (unsigned i = 0; i < V4l2VideoSource::BUFFER_COUNT * 3; ++i) 
+    {
+        source->capture_frame(frame);
+        ASSERT_FALSE(frame.empty()) << "capture " << i;
+    }
+
+    // Один буфер удерживается до следующего захвата
+    EXPECT_EQ(driver.queued.size(), V4l2VideoSource::BUFFER_COUNT - 1);
+}
+
+TEST_F(V4l2VideoSourceTest, CloseStopsStreamingAndUnmapsBuffers) 
+{
+    driver.frame_data.assign(8 * 4 * 2, 50);
+    auto source = open_source(8, 4);
+    EXPECT_TRUE(source->is_available());
+    EXPECT_EQ(driver.mapped, static_cast<int>(V4l2VideoSource::BUFFER_COUNT));
+
+    source->close();
+
+    EXPECT_FALSE(source->is_available());
+    EXPECT_FALSE(driver.streaming);
+    EXPECT_FALSE(driver.opened);
+    EXPECT_EQ(driver.mapped, 0);
+
+    cv::Mat frame;
+    source->capture_frame(frame);
+    EXPECT_TRUE(frame.empty());
+}
+
+TEST_F(V4l2VideoSourceTest, OpenFailsWithoutStreamingSupport) 
+{
+    driver.capabilities = V4L2_CAP_VIDEO_CAPTURE;
+    V4l2VideoSource source(driver.ops());
+
+    EXPECT_THROW(source.open(0), std::runtime_error);
+    EXPECT_FALSE(driver.opened);
+}
\ No newline at end of file
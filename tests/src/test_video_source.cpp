@@ -3,6 +3,7 @@
 
 #include <gtest/gtest.h>
 #include <opencv2/opencv.hpp>
+#include <thread>
 
 class VideoSourceTest : public ::testing::Test 
 {
@@ -72,6 +73,25 @@ TEST_F(VideoSourceTest, CaptureFrameReturnsNonEmptyMat)
     EXPECT_FALSE(frame.empty());
 }
 
+TEST_F(VideoSourceTest, CapturedFrameIsFreshAndTimestamped) 
+{
+    if (available_cameras.empty()) 
+    {
+        GTEST_SKIP() << "No cameras available, skipping test";
+    }
+    
+    video_source->open(available_cameras[0].index);
+    
+    // Медленный потребитель: кадры, снятые за время паузы, пропускаются
+    cv::Mat frame = video_source->capture_frame();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    frame = video_source->capture_frame();
+    
+    ASSERT_FALSE(frame.empty());
+    auto age = std::chrono::steady_clock::now() - video_source->last_capture_time();
+    EXPECT_LT(age, std::chrono::milliseconds(200));
+}
+
 TEST_F(VideoSourceTest, SetResolutionChangesProperties) 
 {
     if (available_cameras.empty()) 
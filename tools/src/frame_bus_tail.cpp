@@ -0,0 +1,82 @@
+#include "shm_frame_bus.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Пример потребителя шины кадров: печатает кадры или раз в секунду
+// выводит число кадров, потери и возраст кадра в момент чтения
+// (от захвата на сервере до копии у потребителя)
+int main(int argc, char* argv[]) 
+{
+    std::string name = "/ascii_frames";
+    bool print_frames = false;
+    bool spin = false;
+
+    for (int i = 1; i < argc; ++i) 
+    {
+        const std::string arg = argv[i];
+        if (arg == "--print") print_frames = true;
+        else if (arg == "--spin") spin = true;
+        else if (arg[0] == '/') name = arg;
+        else 
+        {
+            std::cout << "Usage: frame_bus_tail [/segment_name] [--print] [--spin]\n";
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    try 
+    {
+        frame_bus::Reader reader(name);
+        frame_bus::Frame frame;
+
+        using Clock = std::chrono::steady_clock;
+        auto report_at = Clock::now() + std::chrono::seconds(1);
+        uint64_t frames = 0;
+        uint64_t reported_dropped = 0;
+        double total_age_us = 0;
+        double max_age_us = 0;
+
+        for (;;) 
+        {
+            if (reader.read_next(frame)) 
+            {
+                const double age_us = std::chrono::duration<double, std::micro>(Clock::now() - frame.published_at).count();
+                ++frames;
+                total_age_us += age_us;
+                max_age_us = std::max(max_age_us, age_us);
+
+                if (print_frames) 
+                {
+                    std::cout << "\x1b[H" << frame.data << std::flush;
+                }
+            }
+            else if (!spin) 
+            {
+                // Без --spin читатель не занимает ядро целиком ценой задержки до 100 мкс
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+
+            if (!print_frames && Clock::now() >= report_at) 
+            {
+                std::cout << "frames " << frames
+                          << "  dropped " << reader.dropped() - reported_dropped
+                          << "  age avg " << (frames ? total_age_us / frames : 0.0) << " us"
+                          << "  max " << max_age_us << " us" << std::endl;
+                frames = 0;
+                total_age_us = 0;
+                max_age_us = 0;
+                reported_dropped = reader.dropped();
+                report_at += std::chrono::seconds(1);
+            }
+        }
+    }
+    catch (const std::exception& e) 
+    {
+        std::cerr << "frame_bus_tail: " << e.what() << std::endl;
+        return 1;
+    }
+}
\ No newline at end of file
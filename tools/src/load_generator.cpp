@@ -0,0 +1,475 @@
+#include "frame_trace.hpp"
+
+#include <boost/asio.hpp>
+#include <boost/asio/as_tuple.hpp>
+#include <boost/asio/experimental/awaitable_operators.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast.hpp>
+#include <boost/beast/ssl.hpp>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace websocket = beast::websocket;
+namespace net = boost::asio;
+namespace ssl = net::ssl;
+using tcp = net::ip::tcp;
+using namespace net::experimental::awaitable_operators;
+
+using Clock = std::chrono::steady_clock;
+using WsStream = websocket::stream<ssl::stream<beast::tcp_stream>>;
+
+namespace {
+
+struct Options 
+{
+    std::string host = "127.0.0.1";
+    std::string port = "8080";
+    int connections = 100;
+    int duration_seconds = 30;
+    int threads = 1;
+    // Пауза между подключениями, чтобы не упереться в очередь accept
+    int ramp_ms = 10;
+    // Первое соединение входит как controller и запускает трансляцию
+    bool start_stream = true;
+    std::string resolution = "120x90";
+    int fps = 10;
+    // Кадры с заголовком трассировки: по нему считается задержка
+    bool trace = true;
+    bool per_connection = true;
+    // Для проверок в скриптах: код возврата 2, если хоть одно соединение
+    // получило меньше кадров
+    uint64_t min_frames = 0;
+};
+
+struct ConnectionStats 
+{
+    bool connected = false;
+    std::string error;
+    uint64_t frames = 0;
+    uint64_t bytes = 0;
+    uint64_t heartbeats = 0;
+    Clock::time_point first_frame;
+    Clock::time_point last_frame;
+    std::vector<double> intervals_ms;
+    std::vector<double> latencies_ms;
+
+    void record_frame(Clock::time_point now, size_t size) 
+    {
+        if (frames > 0) 
+        {
+            intervals_ms.push_back(std::chrono::duration<double, std::milli>(now - last_frame).count());
+        } 
+        else 
+        {
+            first_frame = now;
+        }
+        last_frame = now;
+        ++frames;
+        bytes += size;
+    }
+};
+
+void print_usage() 
+{
+    std::cout <<
+        "Usage: load_generator [options]\n"
+        "  --host HOST           server address (127.0.0.1)\n"
+        "  --port PORT           server port (8080)\n"
+        "  --connections N       number of viewers (100)\n"
+        "  --duration SECONDS    how long each viewer stays connected (30);\n"
+        "                        the controller also stays for the whole ramp-up\n"
+        "  --threads N           io_context threads (1)\n"
+        "  --ramp-ms MS          delay between connection attempts (10)\n"
+        "  --resolution WxH      stream resolution when starting the stream (120x90)\n"
+        "  --fps N               stream fps when starting the stream (10)\n"
+        "  --no-start            do not start the stream, only watch\n"
+        "  --no-trace            plain text frames, no latency measurement\n"
+        "  --summary-only        do not print per-connection lines\n"
+        "  --min-frames N        exit with code 2 if any connection got fewer frames (0)\n";
+}
+
+bool parse_options(int argc, char* argv[], Options& options) 
+{
+    for (int i = 1; i < argc; ++i) 
+    {
+        const std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) 
+            {
+                throw std::invalid_argument("Missing value for " + arg);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--host") options.host = next();
+        else if (arg == "--port") options.port = next();
+        else if (arg == "--connections") options.connections = std::stoi(next());
+        else if (arg == "--duration") options.duration_seconds = std::stoi(next());
+        else if (arg == "--threads") options.threads = std::max(1, std::stoi(next()));
+        else if (arg == "--ramp-ms") options.ramp_ms = std::stoi(next());
+        else if (arg == "--resolution") options.resolution = next();
+        else if (arg == "--fps") options.fps = std::stoi(next());
+        else if (arg == "--no-start") options.start_stream = false;
+        else if (arg == "--no-trace") options.trace = false;
+        else if (arg == "--summary-only") options.per_connection = false;
+        else if (arg == "--min-frames") options.min_frames = std::stoull(next());
+        else 
+        {
+            return false;
+        }
+    }
+    return options.connections > 0 && options.duration_seconds > 0;
+}
+
+// Ключ API берется так же, как в браузере: GET /api
+std::string fetch_api_key(const Options& options, ssl::context& ctx) 
+{
+    net::io_context ioc;
+    tcp::resolver resolver(ioc);
+    ssl::stream<beast::tcp_stream> stream(ioc, ctx);
+
+    SSL_set_tlsext_host_name(stream.native_handle(), options.host.c_str());
+    beast::get_lowest_layer(stream).connect(resolver.resolve(options.host, options.port));
+    stream.handshake(ssl::stream_base::client);
+
+    http::request<http::empty_body> req{http::verb::get, "/api", 11};
+    req.set(http::field::host, options.host);
+    http::write(stream, req);
+
+    beast::flat_buffer buffer;
+    http::response<http::string_body> res;
+    http::read(stream, buffer, res);
+
+    beast::error_code ec;
+    stream.shutdown(ec);
+
+    return nlohmann::json::parse(res.body()).at("api_key").get<std::string>();
+}
+
+net::awaitable<void> write_text(WsStream& ws, const std::string& text) 
+{
+    ws.text(true);
+    co_await ws.async_write(net::buffer(text), net::use_awaitable);
+}
+
+// Часть ответов сервер отправлял вместе с завершающим нулем строки
+std::string_view strip_trailing_nuls(std::string_view text) 
+{
+    while (!text.empty() && text.back() == '\0') 
+    {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// Кадры отличаются от служебных ответов сервера переводами строк
+net::awaitable<void> read_frames(WsStream& ws, ConnectionStats& stats) 
+{
+    beast::flat_buffer buffer;
+    TraceHeader echo_header{};
+
+    for (;;) 
+    {
+        buffer.clear();
+        co_await ws.async_read(buffer, net::use_awaitable);
+        const auto now = Clock::now();
+        const auto data = buffer.cdata();
+
+        if (ws.got_binary()) 
+        {
+            TraceEcho echo;
+            if (data.size() < TRACE_HEADER_SIZE || !decode_trace_echo(data.data(), TRACE_HEADER_SIZE, echo)) 
+            {
+                continue;
+            }
+
+            // Часы сервера и клиента совпадают только на одной машине;
+            // для удаленного сервера в задержку входит разница часов
+            stats.latencies_ms.push_back(
+                std::chrono::duration<double, std::milli>(now - echo.sent_at + echo.pipeline).count());
+            stats.record_frame(now, data.size() - TRACE_HEADER_SIZE);
+
+            // Возвращенный заголовок дает серверу время до клиента и обратно
+            std::copy_n(static_cast<const uint8_t*>(data.data()), TRACE_HEADER_SIZE, echo_header.begin());
+            ws.binary(true);
+            co_await ws.async_write(net::buffer(echo_header), net::use_awaitable);
+            continue;
+        }
+
+        const std::string_view text = strip_trailing_nuls(
+            std::string_view(static_cast<const char*>(data.data()), data.size()));
+        if (text == "HEARTBEAT") 
+        {
+            ++stats.heartbeats;
+        } 
+        else if (text == "AUTH_FAILED") 
+        {
+            throw std::runtime_error("authentication failed");
+        } 
+        else if (text == "AUTH_LOCKED") 
+        {
+            throw std::runtime_error("address locked out after failed auth attempts");
+        } 
+        else if (text == "STREAM_FULL") 
+        {
+            throw std::runtime_error("viewer limit reached");
+        } 
+        else if (text.find('\n') != std::string_view::npos) 
+        {
+            stats.record_frame(now, data.size());
+        }
+    }
+}
+
+net::awaitable<void> run_viewer(const Options& options, const std::string& api_key, ssl::context& ctx, 
+                                ConnectionStats& stats, bool controller) 
+{
+    auto executor = co_await net::this_coro::executor;
+    WsStream ws(executor, ctx);
+
+    try 
+    {
+        tcp::resolver resolver(executor);
+        auto endpoints = co_await resolver.async_resolve(options.host, options.port, net::use_awaitable);
+
+        beast::get_lowest_layer(ws).expires_after(std::chrono::seconds(10));
+        co_await beast::get_lowest_layer(ws).async_connect(endpoints, net::use_awaitable);
+        SSL_set_tlsext_host_name(ws.next_layer().native_handle(), options.host.c_str());
+        co_await ws.next_layer().async_handshake(ssl::stream_base::client, net::use_awaitable);
+
+        beast::get_lowest_layer(ws).expires_never();
+        ws.set_option(websocket::stream_base::timeout::suggested(beast::role_type::client));
+        co_await ws.async_handshake(options.host + ":" + options.port, "/stream", net::use_awaitable);
+        stats.connected = true;
+
+        nlohmann::json auth;
+        auth["type"] = "auth";
+        auth["api_key"] = api_key;
+        auth["role"] = controller ? "controller" : "viewer";
+        co_await write_text(ws, auth.dump());
+
+        if (options.trace) 
+        {
+            nlohmann::json trace;
+            trace["type"] = "set_trace";
+            trace["enabled"] = true;
+            co_await write_text(ws, trace.dump());
+        }
+        if (controller) 
+        {
+            nlohmann::json config;
+            config["type"] = "config";
+            config["camera_index"] = 0;
+            config["resolution"] = options.resolution;
+            config["fps"] = options.fps;
+            co_await write_text(ws, config.dump());
+        }
+
+        // Контроллер подключается первым, но уходит последним: с его
+        // отключением сервер останавливает трансляцию, а зрители, вошедшие
+        // позже на время разгона, еще измеряют. Запас - на рукопожатия
+        // зрителей, которые отодвигают начало их измерения
+        std::chrono::milliseconds stay = std::chrono::seconds(options.duration_seconds);
+        if (controller) 
+        {
+            stay += std::chrono::milliseconds(options.ramp_ms) * options.connections + std::chrono::seconds(1);
+        }
+        net::steady_timer deadline(executor, stay);
+        co_await (read_frames(ws, stats) || deadline.async_wait(net::use_awaitable));
+
+        co_await ws.async_close(websocket::close_code::normal, net::as_tuple(net::use_awaitable));
+    } 
+    catch (const std::exception& e) 
+    {
+        stats.error = e.what();
+    }
+}
+
+net::awaitable<void> spawn_viewers(const Options& options, const std::string& api_key, ssl::context& ctx, 
+                                   std::vector<ConnectionStats>& stats, net::io_context& ioc) 
+{
+    auto executor = co_await net::this_coro::executor;
+    net::steady_timer ramp(executor);
+
+    for (size_t i = 0; i < stats.size(); ++i) 
+    {
+        const bool controller = options.start_stream && i == 0;
+        net::co_spawn(net::make_strand(ioc), 
+            run_viewer(options, api_key, ctx, stats[i], controller), 
+            net::detached);
+
+        if (options.ramp_ms > 0) 
+        {
+            ramp.expires_after(std::chrono::milliseconds(options.ramp_ms));
+            co_await ramp.async_wait(net::use_awaitable);
+        }
+    }
+}
+
+double percentile(std::vector<double> values, double q) 
+{
+    if (values.empty()) 
+    {
+        return 0.0;
+    }
+    const size_t index = std::min(values.size() - 1, static_cast<size_t>(q * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+// Джиттер - стандартное отклонение интервалов между кадрами
+double jitter(const std::vector<double>& intervals) 
+{
+    if (intervals.size() < 2) 
+    {
+        return 0.0;
+    }
+    double mean = 0.0;
+    for (double value : intervals) 
+    {
+        mean += value;
+    }
+    mean /= intervals.size();
+
+    double variance = 0.0;
+    for (double value : intervals) 
+    {
+        variance += (value - mean) * (value - mean);
+    }
+    return std::sqrt(variance / (intervals.size() - 1));
+}
+
+double active_seconds(const ConnectionStats& stats) 
+{
+    return stats.frames > 1 
+        ? std::chrono::duration<double>(stats.last_frame - stats.first_frame).count() 
+        : 0.0;
+}
+
+void print_report(const Options& options, const std::vector<ConnectionStats>& stats) 
+{
+    std::cout << std::fixed << std::setprecision(2);
+
+    if (options.per_connection) 
+    {
+        std::cout << "conn   frames      fps     KB/s  jitter_ms  lat_p50_ms  lat_p99_ms  status\n";
+        for (size_t i = 0; i < stats.size(); ++i) 
+        {
+            const auto& s = stats[i];
+            const double seconds = active_seconds(s);
+            std::cout << std::setw(4) << i 
+                      << std::setw(9) << s.frames
+                      << std::setw(9) << (seconds > 0 ? (s.frames - 1) / seconds : 0.0)
+                      << std::setw(9) << (seconds > 0 ? s.bytes / seconds / 1024.0 : 0.0)
+                      << std::setw(11) << jitter(s.intervals_ms)
+                      << std::setw(12) << percentile(s.latencies_ms, 0.5)
+                      << std::setw(12) << percentile(s.latencies_ms, 0.99)
+                      << "  " << (s.error.empty() ? "ok" : s.error) << "\n";
+        }
+    }
+
+    size_t connected = 0;
+    uint64_t frames = 0;
+    uint64_t bytes = 0;
+    std::vector<double> fps;
+    std::vector<double> jitters;
+    std::vector<double> latencies;
+    for (const auto& s : stats) 
+    {
+        connected += s.connected ? 1 : 0;
+        frames += s.frames;
+        bytes += s.bytes;
+        if (const double seconds = active_seconds(s); seconds > 0) 
+        {
+            fps.push_back((s.frames - 1) / seconds);
+            jitters.push_back(jitter(s.intervals_ms));
+        }
+        latencies.insert(latencies.end(), s.latencies_ms.begin(), s.latencies_ms.end());
+    }
+
+    std::cout << "\nconnections: " << connected << "/" << stats.size() << " connected\n"
+              << "frames: " << frames << ", " << bytes / (1024.0 * 1024.0) << " MB\n"
+              << "fps per connection: p50 " << percentile(fps, 0.5) << ", min " << percentile(fps, 0.0) << "\n"
+              << "jitter ms: p50 " << percentile(jitters, 0.5) << ", p99 " << percentile(jitters, 0.99) << "\n";
+    if (!latencies.empty()) 
+    {
+        std::cout << "latency ms (capture to client): p50 " << percentile(latencies, 0.5) 
+                  << ", p99 " << percentile(latencies, 0.99) 
+                  << ", max " << percentile(latencies, 1.0) << "\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) 
+{
+    Options options;
+    try 
+    {
+        if (!parse_options(argc, argv, options)) 
+        {
+            print_usage();
+            return 1;
+        }
+    } 
+    catch (const std::exception& e) 
+    {
+        std::cerr << e.what() << "\n";
+        print_usage();
+        return 1;
+    }
+
+    // Сервер использует самоподписанный сертификат
+    ssl::context ctx(ssl::context::tls_client);
+    ctx.set_verify_mode(ssl::verify_none);
+
+    std::string api_key;
+    try 
+    {
+        api_key = fetch_api_key(options, ctx);
+    } 
+    catch (const std::exception& e) 
+    {
+        std::cerr << "Failed to get API key from https://" << options.host << ":" << options.port 
+                  << "/api: " << e.what() << "\n";
+        return 1;
+    }
+
+    std::cout << "Connecting " << options.connections << " viewers to " 
+              << options.host << ":" << options.port << " for " << options.duration_seconds << "s\n";
+
+    net::io_context ioc(options.threads);
+    std::vector<ConnectionStats> stats(options.connections);
+    net::co_spawn(ioc, spawn_viewers(options, api_key, ctx, stats, ioc), net::detached);
+
+    std::vector<std::thread> workers;
+    for (int i = 1; i < options.threads; ++i) 
+    {
+        workers.emplace_back([&ioc] { ioc.run(); });
+    }
+    ioc.run();
+    for (auto& worker : workers) 
+    {
+        worker.join();
+    }
+
+    print_report(options, stats);
+
+    const bool starved = std::any_of(stats.begin(), stats.end(), 
+        [&options](const ConnectionStats& s) { return s.frames < options.min_frames; });
+    if (starved) 
+    {
+        std::cerr << "Some connections got fewer than " << options.min_frames << " frames\n";
+        return 2;
+    }
+    return 0;
+}
\ No newline at end of file
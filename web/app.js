@@ -27,6 +27,192 @@ class AsciiStreamer
         this.isRecording = false;
         
         this.recordBtn.addEventListener('click', () => this.toggleRecording());
+
+        this.autoRecordBtn = document.getElementById('autoRecordBtn');
+        this.isAutoRecording = false;
+
+        this.autoRecordBtn.addEventListener('click', () => this.toggleAutoRecording());
+
+        this.renderMode = document.getElementById('renderMode');
+        this.renderMode.addEventListener('change', () => this.sendRenderOptions());
+
+        // Трассировка задержек включается параметром страницы ?trace=1
+        this.traceEnabled = new URLSearchParams(window.location.search).get('trace') === '1';
+        this.textDecoder = new TextDecoder();
+        this.binaryFraming = false;
+    }
+
+    // Двоичное сообщение (set_framing): 32 байта заголовка FrameHeader, затем нагрузка.
+    // Тип берется из заголовка, текст кадра не нужно сравнивать со служебными ответами.
+    handleFramedMessage(data)
+    {
+        const FRAME_HEADER_SIZE = 32;
+        const MESSAGE_FRAME = 1;
+        const MESSAGE_HEARTBEAT = 2;
+        const FLAG_TRACED = 0x01;
+        if (data.byteLength < FRAME_HEADER_SIZE) 
+        {
+            return;
+        }
+
+        const header = new DataView(data, 0, FRAME_HEADER_SIZE);
+        const type = header.getUint8(1);
+        if (type === MESSAGE_HEARTBEAT) 
+        {
+            return;
+        }
+
+        const payload = this.textDecoder.decode(new Uint8Array(data, FRAME_HEADER_SIZE));
+        if (type !== MESSAGE_FRAME) 
+        {
+            this.handleTextMessage(payload);
+            return;
+        }
+
+        if (header.getUint8(3) & FLAG_TRACED) 
+        {
+            this.ws.send(data.slice(0, FRAME_HEADER_SIZE));
+        }
+        this.output.textContent = payload;
+    }
+
+    // Кадр с трассировкой: 24 байта заголовка, затем текст кадра.
+    // Заголовок сразу возвращается серверу для замера времени до браузера и обратно.
+    handleTracedFrame(data)
+    {
+        const TRACE_HEADER_SIZE = 24;
+        if (data.byteLength < TRACE_HEADER_SIZE) 
+        {
+            return;
+        }
+
+        this.ws.send(data.slice(0, TRACE_HEADER_SIZE));
+        this.output.textContent = this.textDecoder.decode(new Uint8Array(data, TRACE_HEADER_SIZE));
+    }
+
+    handleTextMessage(message)
+    {
+        // Убираем нулевой символ и пробелы
+        const cleanedMessage = message.replace(/\u0000/g, '').trim();
+
+        // Сцена не меняется, на экране остается последний кадр
+        if (cleanedMessage === "HEARTBEAT") 
+        {
+            return;
+        }
+
+        if (cleanedMessage === "AUTH_CONTROLLER_SUCCESS") 
+        {
+            // Дальше все сообщения, включая ответы на команды, приходят двоичными
+            this.ws.send(JSON.stringify({ type: 'set_framing', mode: 'binary' }));
+            this.binaryFraming = true;
+
+            if (this.traceEnabled) 
+            {
+                this.ws.send(JSON.stringify({ type: 'set_trace', enabled: true }));
+            }
+
+
+            const cameraIndex = document.getElementById('camera').value;
+            const resolution = document.getElementById('resolution').value;
+            const fps = 10;
+            
+            this.ws.send(JSON.stringify({
+                type: 'config',
+                camera_index: parseInt(cameraIndex),
+                resolution: resolution,
+                fps: fps
+            }));
+        } 
+        else if (cleanedMessage === "CONFIG_APPLIED") 
+        {
+            this.output.textContent = "Stream started successfully";
+            this.sendRenderOptions();
+        } 
+        else if (cleanedMessage === "STREAM_STOPPED") 
+        {
+            // Сервер подтвердил остановку стрима
+            this.updateUI(false);
+        } 
+        else if (cleanedMessage === "RECORDING_STARTED") 
+        {
+            alert('Recording started successfully');
+        } 
+        else if (cleanedMessage === "RECORDING_STOPPED") 
+        {
+            alert('Recording stopped successfully');
+        } 
+        else if (cleanedMessage === "AUTO_RECORD_ENABLED" || cleanedMessage === "AUTO_RECORD_DISABLED" || 
+                 cleanedMessage === "RENDER_OPTIONS_SET" || cleanedMessage === "TRACE_SET" || 
+                 cleanedMessage === "FRAMING_SET" || cleanedMessage === "STREAM_ACTIVE" || 
+                 cleanedMessage === "STREAM_INACTIVE") 
+        {
+            // Состояние кнопки уже обновлено
+        } 
+        else if (cleanedMessage === "AUTH_LOCKED" || cleanedMessage === "STREAM_FULL") 
+        {
+            // Сервер закрывает соединение сам; повторная попытка сейчас тоже будет отклонена
+            this.updateUI(false);
+            this.output.textContent = cleanedMessage === "AUTH_LOCKED" 
+                ? "Too many failed authentication attempts, try again later" 
+                : "The stream has reached its viewer limit";
+        } 
+        else if (cleanedMessage === "RECORDING_ERROR") 
+        {
+            alert('Recording error occurred');
+            this.recordBtn.textContent = 'Start Recording';
+            this.isRecording = false;
+        } 
+        else 
+        {
+            this.output.textContent = cleanedMessage;
+        }
+    }
+
+    sendRenderOptions()
+    {
+        if (!this.ws || this.ws.readyState !== WebSocket.OPEN) 
+        {
+            return;
+        }
+
+        // Режимы из списка - готовые сочетания стадий обработки на сервере
+        const mode = this.renderMode.value;
+        const options = { type: 'set_render_options', tone: 'linear', dither: 'none', edges: false };
+
+        if (mode === 'gamma' || mode === 'equalize') 
+        {
+            options.tone = mode;
+        } 
+        else if (mode === 'ordered' || mode === 'floyd_steinberg') 
+        {
+            options.tone = 'equalize';
+            options.dither = mode;
+        } 
+        else if (mode === 'edges') 
+        {
+            options.tone = 'equalize';
+            options.edges = true;
+        }
+
+        this.ws.send(JSON.stringify(options));
+    }
+
+    async toggleAutoRecording()
+    {
+        if (!this.ws || this.ws.readyState !== WebSocket.OPEN) 
+        {
+            alert('Please start the stream first');
+            return;
+        }
+
+        // Запись начинается сама при движении в кадре и включает несколько секунд до него
+        this.ws.send(JSON.stringify({
+            type: this.isAutoRecording ? 'auto_record_stop' : 'auto_record_start'
+        }));
+
+        this.isAutoRecording = !this.isAutoRecording;
+        this.autoRecordBtn.textContent = this.isAutoRecording ? 'Disable Auto Record' : 'Enable Auto Record';
     }
 
     async toggleRecording()
@@ -135,7 +321,9 @@ class AsciiStreamer
             this.api_key = await this.getApiKey();
         }
         
-        this.ws = new WebSocket(`wss://${window.location.host}/stream`);
+        this.ws = new WebSocket(`${window.location.protocol === 'https:' ? 'wss' : 'ws'}://${window.location.host}/stream`);
+        this.ws.binaryType = 'arraybuffer';
+        this.binaryFraming = false;
         
         this.ws.onopen = () => {
             this.ws.send(JSON.stringify({
@@ -146,49 +334,14 @@ class AsciiStreamer
         };
         
         this.ws.onmessage = (event) => {
-            // Убираем нулевой символ и пробелы
-            const cleanedMessage = event.data.replace(/\u0000/g, '').trim();
-
-            if (cleanedMessage === "AUTH_CONTROLLER_SUCCESS") 
-            {
-                const cameraIndex = document.getElementById('camera').value;
-                const resolution = document.getElementById('resolution').value;
-                const fps = 10;
-                
-                this.ws.send(JSON.stringify({
-                    type: 'config',
-                    camera_index: parseInt(cameraIndex),
-                    resolution: resolution,
-                    fps: fps
-                }));
-            } 
-            else if (cleanedMessage === "CONFIG_APPLIED") 
-            {
-                this.output.textContent = "Stream started successfully";
-            } 
-            else if (cleanedMessage === "STREAM_STOPPED") 
+            if (event.data instanceof ArrayBuffer) 
             {
-                // Сервер подтвердил остановку стрима
-                this.updateUI(false);
-            } 
-            else if (cleanedMessage === "RECORDING_STARTED") 
-            {
-                alert('Recording started successfully');
-            } 
-            else if (cleanedMessage === "RECORDING_STOPPED") 
-            {
-                alert('Recording stopped successfully');
-            } 
-            else if (cleanedMessage === "RECORDING_ERROR") 
-            {
-                alert('Recording error occurred');
-                this.recordBtn.textContent = 'Start Recording';
-                this.isRecording = false;
-            } 
-            else 
-            {
-                this.output.textContent = cleanedMessage;
+                if (this.binaryFraming) this.handleFramedMessage(event.data);
+                else this.handleTracedFrame(event.data);
+                return;
             }
+
+            this.handleTextMessage(event.data);
         };
 
         this.ws.onclose = () => {
@@ -9,6 +9,8 @@ class RecordingsManager
         this.playBtn = document.getElementById('playBtn');
         this.pauseBtn = document.getElementById('pauseBtn');
         this.stopBtn = document.getElementById('stopBtn');
+        this.prevActivityBtn = document.getElementById('prevActivityBtn');
+        this.nextActivityBtn = document.getElementById('nextActivityBtn');
         this.speedSelect = document.getElementById('speedSelect');
         this.playbackOutput = document.getElementById('playbackOutput');
         this.currentTimeEl = document.getElementById('currentTime');
@@ -19,6 +21,8 @@ class RecordingsManager
         this.playBtn.addEventListener('click', () => this.startPlayback());
         this.pauseBtn.addEventListener('click', () => this.togglePause());
         this.stopBtn.addEventListener('click', () => this.stopPlayback());
+        this.prevActivityBtn.addEventListener('click', () => this.seekActivity('playback_prev_activity'));
+        this.nextActivityBtn.addEventListener('click', () => this.seekActivity('playback_next_activity'));
         this.speedSelect.addEventListener('change', () => this.changePlaybackSpeed());
         
         this.currentRecording = null;
@@ -77,6 +81,7 @@ class RecordingsManager
                 <td>${duration}</td>
                 <td>${size}</td>
                 <td>
+                    <button class="preview-btn" data-filename="${recording.filename}">Preview</button>
                     <button class="play-btn" data-filename="${recording.filename}">Play</button>
                     <button class="delete-btn" data-filename="${recording.filename}">Delete</button>
                 </td>
@@ -86,6 +91,12 @@ class RecordingsManager
         });
         
         // Add event listeners to buttons
+        document.querySelectorAll('.preview-btn').forEach(btn => {
+            btn.addEventListener('click', (e) => {
+                this.togglePreview(e.target.closest('tr'), e.target.dataset.filename);
+            });
+        });
+        
         document.querySelectorAll('.play-btn').forEach(btn => {
             btn.addEventListener('click', (e) => {
                 this.selectRecording(e.target.dataset.filename);
@@ -99,6 +110,59 @@ class RecordingsManager
         });
     }
     
+    async togglePreview(row, filename) 
+    {
+        const next = row.nextElementSibling;
+        if (next && next.classList.contains('preview-row')) 
+        {
+            next.remove();
+            return;
+        }
+        
+        const previewRow = document.createElement('tr');
+        previewRow.className = 'preview-row';
+        const cell = document.createElement('td');
+        cell.colSpan = 5;
+        cell.textContent = 'Loading preview...';
+        previewRow.appendChild(cell);
+        row.after(previewRow);
+        
+        try 
+        {
+            let response = await fetch(`/recordings/${filename}/preview`);
+            // 202: the server is still building the preview from the file
+            for (let attempt = 0; response.status === 202 && attempt < 10; ++attempt) 
+            {
+                await new Promise(resolve => setTimeout(resolve, 500));
+                response = await fetch(`/recordings/${filename}/preview`);
+            }
+            if (response.status !== 200) 
+            {
+                cell.textContent = 'Preview not available';
+                return;
+            }
+            
+            const preview = await response.json();
+            cell.textContent = '';
+            
+            const strip = document.createElement('div');
+            strip.className = 'preview-strip';
+            preview.frames.forEach(frame => {
+                const snapshot = document.createElement('pre');
+                snapshot.className = 'preview-frame';
+                snapshot.title = this.formatDuration(Math.floor(frame.timestamp / 1000));
+                snapshot.textContent = frame.frame;
+                strip.appendChild(snapshot);
+            });
+            cell.appendChild(strip);
+        } 
+        catch (error) 
+        {
+            console.error('Failed to load preview:', error);
+            cell.textContent = 'Preview not available';
+        }
+    }
+    
     formatFileSize(bytes) 
     {
         if (bytes < 1024) return bytes + ' B';
@@ -160,7 +224,7 @@ class RecordingsManager
         }
         
         // Connect to WebSocket for playback
-        this.ws = new WebSocket(`wss://${window.location.host}/playback`);
+        this.ws = new WebSocket(`${window.location.protocol === 'https:' ? 'wss' : 'ws'}://${window.location.host}/playback`);
         
         this.ws.onopen = () => {
             this.ws.send(JSON.stringify({
@@ -174,6 +238,17 @@ class RecordingsManager
         };
         
         this.ws.onmessage = (event) => {
+            if (event.data === 'NO_ACTIVITY_FOUND') 
+            {
+                alert('No more activity in this direction');
+                return;
+            }
+            
+            if (event.data.startsWith('PLAYBACK_')) 
+            {
+                return;
+            }
+            
             this.playbackOutput.textContent = event.data;
         };
         
@@ -227,6 +302,16 @@ class RecordingsManager
         this.playbackOutput.textContent = 'Playback stopped';
     }
     
+    seekActivity(type) 
+    {
+        if (!this.ws || this.ws.readyState !== WebSocket.OPEN) 
+        {
+            return;
+        }
+        
+        this.ws.send(JSON.stringify({ type: type }));
+    }
+    
     changePlaybackSpeed() 
     {
         if (!this.ws || this.ws.readyState !== WebSocket.OPEN) 
@@ -247,6 +332,8 @@ class RecordingsManager
         this.pauseBtn.disabled = !this.isPlaying;
         this.stopBtn.disabled = !this.isPlaying;
         this.speedSelect.disabled = !this.isPlaying;
+        this.prevActivityBtn.disabled = !this.isPlaying;
+        this.nextActivityBtn.disabled = !this.isPlaying;
         
         if (this.isPaused) 
         {